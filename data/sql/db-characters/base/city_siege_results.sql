@@ -0,0 +1,19 @@
+-- Outcome of every siege, written once its rewards have been handed out
+CREATE TABLE IF NOT EXISTS `city_siege_results` (
+    `id` INT UNSIGNED NOT NULL AUTO_INCREMENT,
+    `city_id` TINYINT UNSIGNED NOT NULL,
+    `city_name` VARCHAR(32) NOT NULL,
+    `start_time` INT UNSIGNED NOT NULL COMMENT 'Unix time the siege started',
+    `end_time` INT UNSIGNED NOT NULL COMMENT 'Unix time the siege ended',
+    `winner_team` TINYINT UNSIGNED NOT NULL COMMENT '0 = Alliance, 1 = Horde',
+    `defenders_won` TINYINT UNSIGNED NOT NULL,
+    `participants` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'Players in range when the siege ended',
+    `attacker_deaths` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'Attacking creatures and bots killed',
+    `defender_deaths` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'Defending creatures and bots killed',
+    `rewarded_players` INT UNSIGNED NOT NULL DEFAULT 0,
+    `mailed_rewards` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'Rewards mailed to players who had logged out',
+    `honor_awarded` INT UNSIGNED NOT NULL DEFAULT 0,
+    `money_awarded` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'Copper',
+    PRIMARY KEY (`id`),
+    KEY `idx_city_time` (`city_id`, `start_time`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COMMENT='mod-city-siege results';
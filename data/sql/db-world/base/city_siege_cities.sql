@@ -0,0 +1,30 @@
+-- Optional city registry. A row replaces the built-in city with the same id and its
+-- CitySiege.<City>.* conf keys; ids 8 to 31 add custom cities, which must follow on without gaps.
+-- Both tables ship empty, so the built-in cities and the conf keys apply until rows are added.
+CREATE TABLE IF NOT EXISTS `city_siege_city` (
+    `id` TINYINT UNSIGNED NOT NULL COMMENT '0-7 = built-in cities, 8-31 = custom cities',
+    `name` VARCHAR(32) NOT NULL,
+    `team` TINYINT UNSIGNED NOT NULL COMMENT 'Defending faction: 0 = Alliance, 1 = Horde',
+    `enabled` TINYINT UNSIGNED NOT NULL DEFAULT 1,
+    `map_id` SMALLINT UNSIGNED NOT NULL,
+    `center_x` FLOAT NOT NULL,
+    `center_y` FLOAT NOT NULL,
+    `center_z` FLOAT NOT NULL,
+    `spawn_x` FLOAT NOT NULL COMMENT 'Where the attackers gather',
+    `spawn_y` FLOAT NOT NULL,
+    `spawn_z` FLOAT NOT NULL,
+    `leader_x` FLOAT NOT NULL COMMENT 'Final march target next to the city leader',
+    `leader_y` FLOAT NOT NULL,
+    `leader_z` FLOAT NOT NULL,
+    `leader_entry` INT UNSIGNED NOT NULL COMMENT 'Creature entry of the city leader',
+    PRIMARY KEY (`id`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COMMENT='mod-city-siege cities';
+
+CREATE TABLE IF NOT EXISTS `city_siege_waypoint` (
+    `city_id` TINYINT UNSIGNED NOT NULL,
+    `point` TINYINT UNSIGNED NOT NULL COMMENT 'Order along the path, from the spawn to the leader',
+    `x` FLOAT NOT NULL,
+    `y` FLOAT NOT NULL,
+    `z` FLOAT NOT NULL,
+    PRIMARY KEY (`city_id`, `point`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COMMENT='mod-city-siege waypoints of cities in city_siege_city';
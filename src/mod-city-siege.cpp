@@ -31,6 +31,7 @@
 #include "ObjectAccessor.h"
 #include "MoveSplineInit.h"
 #include "MotionMaster.h"
+#include "PathGenerator.h"
 #include "Language.h"
 #include "ScriptedCreature.h"
 #include "Cell.h"
@@ -40,11 +41,26 @@
 #include "Weather.h"
 #include "WeatherMgr.h"
 #include "MiscPackets.h"
+#include "DatabaseEnv.h"
+#include "CharacterCache.h"
+#include "Mail.h"
+#include "StringFormat.h"
+#include "Metric.h"
 #include <vector>
+#include <array>
+#include <bitset>
 #include <unordered_map>
 #include <string>
 #include <cmath>
+#include <cstring>
+#include <chrono>
 #include <algorithm>
+#include <limits>
+#include <mutex>
+#include <memory>
+#include <future>
+#include <fstream>
+#include <atomic>
 
 // Conditional include for playerbots module
 #ifdef MOD_PLAYERBOTS
@@ -115,14 +131,19 @@ static bool g_AllowMultipleCities = false;
 static uint32 g_AnnounceRadius = 500;
 static uint32 g_MinimumLevel = 1;
 
-// City enable/disable flags
-static std::unordered_map<std::string, bool> g_CityEnabled;
-
 // Spawn counts
 static uint32 g_SpawnCountMinions = 15;
 static uint32 g_SpawnCountElites = 5;
 static uint32 g_SpawnCountMiniBosses = 2;
 static uint32 g_SpawnCountLeaders = 1;
+static uint32 g_SpawnBatchSize = 10; // Units summoned per respawn stage run during the cinematic, 0 = all at once
+static uint32 g_SquadSize = 0; // Units per squad, only the squad leader paths (0 or 1 = every unit paths on its own)
+
+// Attacker waves - the army after the first wave is streamed in as reinforcements (see UpdateSiegeWaves)
+static bool g_WavesEnabled = false;
+static uint32 g_WavesSize = 15;     // Attackers per wave, leaders not counted
+static uint32 g_WavesInterval = 90; // Seconds after which the next wave comes even if the last one is still at the spawn point
+static uint32 g_WavesMaxLive = 60;  // Live attackers a siege is held to, 0 = no cap
 
 // Creature entries - Using Mount Hyjal battle units for thematic appropriateness
 // Alliance attackers: Footman, Knights, Riflemen, Priests
@@ -189,6 +210,8 @@ static bool g_RewardOnDefense = true;
 static uint32 g_RewardHonor = 100;
 static uint32 g_RewardGoldBase = 5000; // 50 silver in copper at level 1
 static uint32 g_RewardGoldPerLevel = 5000; // 0.5 gold per level in copper
+static bool g_RewardMailOffline = true; // Mail the gold reward to participants who logged out before the rewards
+static bool g_ResultsEnabled = true; // Save each siege's outcome to city_siege_results
 
 // Announcement messages
 static std::string g_MessageSiegeStart = "|cffff0000[City Siege]|r The city of {CITYNAME} is under attack! Defenders are needed!";
@@ -214,6 +237,9 @@ static uint32 g_PlayerbotsMinLevel = 70;
 static uint32 g_PlayerbotsMaxDefenders = 20;
 static uint32 g_PlayerbotsMaxAttackers = 20;
 static uint32 g_PlayerbotsRespawnDelay = 30; // Seconds before bot respawns after death
+static uint32 g_PlayerbotsIndexInterval = 60; // Seconds between rebuilds of the recruitment candidate index
+static uint32 g_PlayerbotsIndexBatch = 100; // Bots added to the candidate index per world tick while rebuilding
+static uint32 g_PlayerbotsTeleportBatch = 5; // Recruited bots teleported per status stage run during the cinematic
 #endif
 
 // Weather settings
@@ -228,11 +254,86 @@ static uint32 g_CombatMusicId = 11804;   // Battle of Mount Hyjal (intense battl
 static uint32 g_VictoryMusicId = 16039;  // Invincible (triumphant victory music)
 static uint32 g_DefeatMusicId = 14127;   // Wrath of the Lich King main theme (somber/defeat)
 
+// Scheduler settings - each siege stage runs on its own interval (milliseconds)
+enum SiegeStage : uint8
+{
+    SIEGE_STAGE_STATUS   = 0, // Phase transitions, status announcements, win conditions
+    SIEGE_STAGE_YELLS    = 1, // Countdown, RP dialogue and combat yells
+    SIEGE_STAGE_RESPAWN  = 2, // Batched army spawning, respawning of creatures and bots
+    SIEGE_STAGE_MOVEMENT = 3, // Waypoint movement of creatures and bots
+    SIEGE_STAGE_PARTICIPANTS = 4, // Refresh of the players within the announce radius
+    SIEGE_STAGE_MAX
+};
+
+static uint32 g_StageIntervals[SIEGE_STAGE_MAX] = { 1000, 1000, 1000, 500, 5000 };
+static uint32 g_UpdateBudget = 10; // Milliseconds per world tick, 0 = unlimited
+static size_t g_SiegeUpdateCursor = 0; // First siege updated next tick (round-robin)
+static uint32 g_TeardownBatch = 25; // Creatures, bots or players handled per tick while an ended siege is torn down
+static bool g_MapThreadUpdates = true; // Run the respawn, movement and participant stages from the city map's update
+
+// Interest management - units with no participant nearby are parked (see UpdateParkedSiegeUnit)
+static bool g_InterestEnabled = true;
+static float g_InterestRadius = 150.0f; // Yards around a participant within which units are fully simulated
+static uint32 g_InterestParkedInterval = 5; // Seconds between the coarse steps of a parked unit
+
+// Stuck units - a unit whose legs stop bringing it closer to its target retries with backoff, then is recovered
+static uint32 g_StuckTimeout = 30; // Seconds without getting closer before a unit is recovered, 0 = off
+static uint32 g_StuckMaxBackoff = 8; // Longest wait in seconds between two launches that made no progress
+static uint32 g_StuckAction = 0; // 0 = teleport to the target path point, 1 = despawn and queue for respawn
+
+// Adaptive army size - spawn counts and respawn rates follow the world tick and the player count (see ComputeSiegeArmyScale)
+static bool g_AdaptiveEnabled = false;
+static bool g_AdaptiveDuringSiege = true; // Rescale with every participant refresh, not only at siege start
+static uint32 g_AdaptiveTargetDiff = 60; // Milliseconds per world tick the armies are shrunk to stay under
+static float g_AdaptiveMinScale = 0.5f;
+static float g_AdaptiveMaxScale = 1.5f;
+static uint32 g_AdaptiveFullPlayers = 20; // Real players in the announce radius that call for the largest army
+static float g_WorldDiffAverage = 0.0f; // Moving average of the world update diff in milliseconds
+
+// City cache file - height and path caches, precomputed on the map threads and kept across restarts
+static bool g_CacheEnabled = true;
+static std::string g_CacheFile = "city_siege.cache";
+
+// Telemetry - per-siege combat counters, sampled into a ring buffer (see .citysiege stats)
+static bool g_TelemetryEnabled = true;
+static uint32 g_TelemetryInterval = 30; // Seconds between samples
+static bool g_TelemetryLog = false; // Write every sample to the server log as one line
+static bool g_TelemetryMetrics = true; // Send every sample to the worldserver metrics (Metric.Enable)
+
+// Built-in profiler - wall time spent in each part of the siege update (see .citysiege perf)
+enum SiegePerfSection : uint8
+{
+    SIEGE_PERF_TICK = 0,          // Whole siege update of one world tick
+    SIEGE_PERF_YELLS,             // Cinematic countdown, RP dialogue and combat yells
+    SIEGE_PERF_ATTACKER_MOVEMENT, // Attacker waypoint movement
+    SIEGE_PERF_DEFENDER_MOVEMENT, // Defender waypoint movement
+    SIEGE_PERF_BOT_MOVEMENT,      // Playerbot waypoint movement
+    SIEGE_PERF_RESPAWN,           // Creature respawns
+    SIEGE_PERF_BOT_RESPAWN,       // Playerbot respawns
+    SIEGE_PERF_STATUS,            // Phase transitions, status announcements and leader checks
+    SIEGE_PERF_PARTICIPANTS,      // Participant list refresh
+    SIEGE_PERF_SPAWN,             // Army spawning (initial batch and cinematic batches)
+    SIEGE_PERF_DESPAWN,           // DespawnSiegeCreatures
+    SIEGE_PERF_BOT_RECRUIT,       // Playerbot recruitment
+    SIEGE_PERF_MAP_TICK,          // Siege update of one city map, run by its map update thread
+    SIEGE_PERF_MAX
+};
+
+static const char* const g_PerfSectionNames[SIEGE_PERF_MAX] =
+{
+    "tick", "yells/rp", "attacker move", "defender move", "bot move", "respawn",
+    "bot respawn", "status/leader", "participants", "spawn", "despawn", "bot recruit", "map tick"
+};
+
+static bool g_PerfEnabled = true;
+static uint32 g_PerfLogInterval = 0; // Seconds between profiler log lines while sieges run, 0 = off
+static uint32 g_PerfLogTimer = 0;
+
 // -----------------------------------------------------------------------------
 // CITY SIEGE DATA STRUCTURES
 // -----------------------------------------------------------------------------
 
-enum CityId
+enum CityId : uint8
 {
     CITY_STORMWIND = 0,
     CITY_IRONFORGE,
@@ -242,9 +343,68 @@ enum CityId
     CITY_UNDERCITY,
     CITY_THUNDERBLUFF,
     CITY_SILVERMOON,
-    CITY_MAX
+    CITY_MAX // Custom cities from the city_siege_city table take the ids from here on
+};
+
+static const uint32 SIEGE_MAX_CITIES = 32; // Built-in and custom cities
+
+// Role of a siege unit, recorded when it spawns so hot loops never re-classify by entry
+enum SiegeUnitRole : uint8
+{
+    SIEGE_ROLE_LEADER   = 0,
+    SIEGE_ROLE_MINIBOSS = 1,
+    SIEGE_ROLE_ELITE    = 2,
+    SIEGE_ROLE_MINION   = 3,
+    SIEGE_ROLE_DEFENDER = 4,
+    SIEGE_ROLE_MAX
+};
+
+// Fixed traits of each siege unit role, indexed by SiegeUnitRole
+struct SiegeRoleTraits
+{
+    bool defender; // Fights for the city and takes its faction
+    bool scaled;   // Spawn count follows the army scale (see GetSiegeRoleScaledCount)
+    bool resized;  // Model scale set from CitySiege.Scale.*
+};
+
+static constexpr SiegeRoleTraits g_SiegeRoleTraits[SIEGE_ROLE_MAX] =
+{
+    { false, false, true  }, // SIEGE_ROLE_LEADER
+    { false, true,  true  }, // SIEGE_ROLE_MINIBOSS
+    { false, true,  false }, // SIEGE_ROLE_ELITE
+    { false, true,  false }, // SIEGE_ROLE_MINION
+    { true,  true,  false }  // SIEGE_ROLE_DEFENDER
+};
+
+// Configured settings of each siege unit role, indexed by SiegeUnitRole (see BuildSiegeRoleSettings)
+struct SiegeRoleSettings
+{
+    uint32 entry[2] = { }; // Creature entry by the team the unit fights for, 0 for leaders (picked per siege)
+    uint32 level = 0;
+    float scale = 1.0f;
+    uint32 respawnTime = 0; // Seconds
+    uint32 spawnCount = 0;
+    ReactStates reactState = REACT_AGGRESSIVE; // Once the battle has begun
+};
+
+static SiegeRoleSettings g_RoleSettings[SIEGE_ROLE_MAX];
+
+// Traits of the two teams that own cities, indexed by TeamId
+struct SiegeFactionTraits
+{
+    const char* name;
+    TeamId enemy;
+    uint32 combatFaction; // Faction template of the siege units fighting for the team
+};
+
+static constexpr SiegeFactionTraits g_SiegeFactions[2] =
+{
+    { "Alliance", TEAM_HORDE,    84 }, // TEAM_ALLIANCE
+    { "Horde",    TEAM_ALLIANCE, 83 }  // TEAM_HORDE
 };
 
+static constexpr uint32 SIEGE_FACTION_PASSIVE = 35; // Friendly to all, held by the army while the cinematic plays
+
 struct Waypoint
 {
     float x;
@@ -252,10 +412,14 @@ struct Waypoint
     float z;
 };
 
+struct CityHeightCache;
+struct CityPathCache;
+
 struct CityData
 {
     CityId id;
     std::string name;
+    TeamId team;        // Defending faction
     uint32 mapId;
     float centerX;      // City center for announcement radius
     float centerY;
@@ -268,18 +432,123 @@ struct CityData
     float leaderZ;
     uint32 targetLeaderEntry; // Entry ID of the city leader to attack
     std::vector<Waypoint> waypoints; // Waypoints for creatures to follow to reach the leader
+    std::shared_ptr<CityHeightCache> heights; // Filled on first use, one per config snapshot
+    std::shared_ptr<CityPathCache> paths;     // Filled on first use, one per config snapshot
+};
+
+// Built-in city definitions with approximate center coordinates, overridden by the conf keys
+// or by a city_siege_city row (see LoadCitySiegeConfiguration)
+static const std::vector<CityData> g_DefaultCities = {
+    { CITY_STORMWIND,   "Stormwind",      TEAM_ALLIANCE, 0,   -8913.23f, 554.633f,  93.7944f,  -9161.16f, 353.365f,  88.117f,   -8442.578f, 334.6064f, 122.476685f,  29611,  {} },
+    { CITY_IRONFORGE,   "Ironforge",      TEAM_ALLIANCE, 0,   -4981.25f, -881.542f, 501.660f,  -5174.09f, -594.361f, 397.853f,  -4981.25f, -881.542f, 501.660f,  2784,  {} },
+    { CITY_DARNASSUS,   "Darnassus",      TEAM_ALLIANCE, 1,    9947.52f, 2482.73f,  1316.21f,   9887.36f, 1856.49f,  1317.14f,   9947.52f, 2482.73f,  1316.21f,  7999,  {} },
+    { CITY_EXODAR,      "Exodar",         TEAM_ALLIANCE, 530, -3864.92f, -11643.7f, -137.644f, -4080.80f, -12193.2f, 1.712f,    -3864.92f, -11643.7f, -137.644f, 17468, {} },
+    { CITY_ORGRIMMAR,   "Orgrimmar",      TEAM_HORDE,    1,    1633.75f, -4439.39f, 15.4396f,   1114.96f, -4374.63f, 25.813f,    1633.75f, -4439.39f, 15.4396f,  4949,  {} },
+    { CITY_UNDERCITY,   "Undercity",      TEAM_HORDE,    0,    1633.75f, 240.167f,  -43.1034f,  1982.26f, 226.674f,  35.951f,    1633.75f, 240.167f,  -43.1034f, 10181, {} },
+    { CITY_THUNDERBLUFF, "ThunderBluff", TEAM_HORDE,    1,   -1043.11f, 285.809f,  135.165f,  -1558.61f, -5.071f,   5.384f,    -1043.11f, 285.809f,  135.165f,  3057,  {} },
+    { CITY_SILVERMOON,  "Silvermoon",     TEAM_HORDE,    530,  9338.74f, -7277.27f, 13.7014f,   9230.47f, -6962.67f, 5.004f,     9338.74f, -7277.27f, 13.7014f,  16802, {} }
+};
+
+// City registry and everything derived from it. A config load builds a new snapshot and swaps
+// it in, running sieges keep the one they started with, so a reload never moves the path under them.
+struct SiegeConfigSnapshot
+{
+    std::vector<CityData> cities; // Indexed by CityId
+    std::bitset<SIEGE_MAX_CITIES> cityEnabled; // Indexed by CityId
+};
+
+// Only replaced from the world update, which never overlaps the map updates reading siege snapshots
+static std::shared_ptr<const SiegeConfigSnapshot> g_Config = std::make_shared<SiegeConfigSnapshot>();
+
+/**
+ * @brief Checks whether a city is defended by the Alliance.
+ * @param city The city.
+ * @return True for Alliance cities, false for Horde cities.
+ */
+inline bool IsAllianceCity(const CityData& city)
+{
+    return city.team == TEAM_ALLIANCE;
+}
+
+/**
+ * @brief Gets the team that attacks a city.
+ * @param city The city.
+ * @return The enemy team of the city's owner.
+ */
+inline TeamId GetSiegeAttackingTeam(const CityData& city)
+{
+    return g_SiegeFactions[city.team].enemy;
+}
+
+/**
+ * @brief Gets the team a siege unit of the given role fights for.
+ * @param city The city being sieged.
+ * @param role The role of the unit.
+ * @return The city's owner for defenders, its enemy for attackers.
+ */
+inline TeamId GetSiegeUnitTeam(const CityData& city, SiegeUnitRole role)
+{
+    return g_SiegeRoleTraits[role].defender ? city.team : GetSiegeAttackingTeam(city);
+}
+
+// Direction a siege unit walks the path (see GetSiegePathPoint)
+enum SiegeMarchDirection : uint8
+{
+    SIEGE_MARCH_FORWARD = 0,  // Attackers: spawn point -> waypoints -> leader
+    SIEGE_MARCH_BACKWARD = 1  // Defenders: leader -> waypoints (reversed) -> spawn point
+};
+
+// Steps of tearing down an ended siege, one batch per world tick
+enum SiegeTeardownStage : uint8
+{
+    SIEGE_TEARDOWN_NONE = 0, // Siege still running
+    SIEGE_TEARDOWN_DESPAWN,  // Despawning attackers and defenders
+    SIEGE_TEARDOWN_REWARDS,  // Rewarding the winning participants
+    SIEGE_TEARDOWN_BOTS,     // Sending playerbots back to where they came from
+    SIEGE_TEARDOWN_DONE
+};
+
+// Waypoint progress of a siege unit. Marching forward with progress P the unit
+// heads for path point P+1, marching backward for path point P.
+static const uint32 SIEGE_PROGRESS_NONE = std::numeric_limits<uint32>::max(); // No progress target, the next check starts over
+
+struct SiegeUnitProgress
+{
+    uint32 waypoint = 0;
+    SiegeMarchDirection direction = SIEGE_MARCH_FORWARD;
+};
+
+// Counter bumped by the unit hooks on the city map's update thread and read by the world update.
+// Relaxed atomics, copyable so SiegeEvent can still live in a vector.
+template <typename T>
+struct SiegeCounter
+{
+    std::atomic<T> value{ 0 };
+
+    SiegeCounter() = default;
+    SiegeCounter(const SiegeCounter& other) : value(other.Get()) { }
+    SiegeCounter& operator=(const SiegeCounter& other) { value.store(other.Get(), std::memory_order_relaxed); return *this; }
+
+    void Add(T amount = 1) { value.fetch_add(amount, std::memory_order_relaxed); }
+    T Get() const { return value.load(std::memory_order_relaxed); }
 };
 
-// City definitions with approximate center coordinates
-static std::vector<CityData> g_Cities = {
-    { CITY_STORMWIND,   "Stormwind",      0,   -8913.23f, 554.633f,  93.7944f,  -9161.16f, 353.365f,  88.117f,   -8442.578f, 334.6064f, 122.476685f,  29611,  {} },
-    { CITY_IRONFORGE,   "Ironforge",      0,   -4981.25f, -881.542f, 501.660f,  -5174.09f, -594.361f, 397.853f,  -4981.25f, -881.542f, 501.660f,  2784,  {} },
-    { CITY_DARNASSUS,   "Darnassus",      1,    9947.52f, 2482.73f,  1316.21f,   9887.36f, 1856.49f,  1317.14f,   9947.52f, 2482.73f,  1316.21f,  7999,  {} },
-    { CITY_EXODAR,      "Exodar",         530, -3864.92f, -11643.7f, -137.644f, -4080.80f, -12193.2f, 1.712f,    -3864.92f, -11643.7f, -137.644f, 17468, {} },
-    { CITY_ORGRIMMAR,   "Orgrimmar",      1,    1633.75f, -4439.39f, 15.4396f,   1114.96f, -4374.63f, 25.813f,    1633.75f, -4439.39f, 15.4396f,  4949,  {} },
-    { CITY_UNDERCITY,   "Undercity",      0,    1633.75f, 240.167f,  -43.1034f,  1982.26f, 226.674f,  35.951f,    1633.75f, 240.167f,  -43.1034f, 10181, {} },
-    { CITY_THUNDERBLUFF, "ThunderBluff", 1,   -1043.11f, 285.809f,  135.165f,  -1558.61f, -5.071f,   5.384f,    -1043.11f, 285.809f,  135.165f,  3057,  {} },
-    { CITY_SILVERMOON,  "Silvermoon",     530,  9338.74f, -7277.27f, 13.7014f,   9230.47f, -6962.67f, 5.004f,     9338.74f, -7277.27f, 13.7014f,  16802, {} }
+static const uint32 SIEGE_TELEMETRY_SAMPLES = 64; // Samples kept per siege, the oldest are overwritten
+
+// Siege counters at one point in time, totals since the siege started (see SampleSiegeTelemetry)
+struct SiegeTelemetrySample
+{
+    uint32 elapsed; // Seconds since the siege started
+    uint32 attackerDeaths;
+    uint32 defenderDeaths;
+    uint32 botDeaths;
+    uint32 playerKills;
+    uint32 respawns;
+    uint64 leaderDamage;
+    uint32 allianceParticipants;
+    uint32 hordeParticipants;
+    float waypointAverage; // Average waypoint reached by the living attackers
+    uint32 waypointFront; // Furthest waypoint reached by an attacker
 };
 
 struct SiegeEvent
@@ -289,9 +558,73 @@ struct SiegeEvent
     uint32 endTime;
     bool isActive;
     std::vector<ObjectGuid> spawnedCreatures;
+    std::vector<uint32> rpSpeakerSlots; // Indices into spawnedCreatures of leaders and mini-bosses (RP and yells)
     std::vector<ObjectGuid> spawnedDefenders; // Defender creatures
-    ObjectGuid cityLeaderGuid; // GUID of the city leader being defended
+
+    // Per-slot state of the siege creatures, indexed like spawnedCreatures / spawnedDefenders.
+    // A respawned creature takes over the slot (and GUID entry) of the dead one.
+    struct UnitSlot
+    {
+        SiegeUnitRole role;
+        SiegeUnitProgress progress;
+        uint32 lastMoveTime = 0; // Server time the last movement leg was launched
+        bool awaitingRespawn = false; // Dead and queued in deadCreatures
+        bool parked = false; // No participant nearby, stepped along the cached path (see UpdateParkedSiegeUnit)
+        uint32 parkedLegPoint = 0; // Next point of the cached leg a parked unit heads for, 0 = not resolved yet
+
+        // Progress towards the current target (see CheckSiegeUnitProgress)
+        uint32 progressTarget = SIEGE_PROGRESS_NONE; // Path point progressDistance refers to
+        float progressDistance = 0.0f; // Closest the unit has come to progressTarget
+        uint32 progressTime = 0; // Server time the unit last got closer
+        uint32 retryTime = 0; // Earliest next launch after a leg that made no progress
+        uint8 retries = 0; // Launches without progress, each one doubles the wait
+    };
+    std::vector<UnitSlot> creatureSlots; // Attackers
+    std::vector<UnitSlot> defenderSlots; // Defenders
+
+    // Every tracked siege unit (creatures and bots), so the death hook can find it by GUID
+    struct UnitRef
+    {
+        uint32 slot; // Index into spawnedCreatures or spawnedDefenders (unused for bots)
+        bool isDefender;
+        bool isBot;
+    };
+    std::unordered_map<ObjectGuid, UnitRef> unitIndex;
+
+    // Army formation computed when the siege starts and summoned in batches during the cinematic
+    struct PendingSpawn
+    {
+        uint32 entry;
+        SiegeUnitRole role;
+        float x, y, z; // Ground-adjusted spawn position
+    };
+    std::vector<PendingSpawn> pendingSpawns;
+    size_t nextPendingSpawn = 0; // Index of the next pendingSpawns entry to summon
+
+    // Attacker waves (see UpdateSiegeWaves), pendingSpawns is ordered wave by wave
+    std::vector<size_t> waveEnds; // End of each wave in pendingSpawns
+    size_t waveSpawnEnd = 0; // pendingSpawns are summoned up to here, the end of the latest wave sent
+    uint32 wavesSent = 0;
+    uint32 waveFirstSlot = 0; // First spawnedCreatures slot of the latest wave
+    uint32 nextWaveTime = 0;
+    bool waveStreaming = false; // The latest wave is still being summoned
+
+    // Squads of same-rank units: only the leader paths, the others follow it in formation
+    struct SiegeSquad
+    {
+        bool isDefender;
+        std::vector<uint32> slots; // Member slots in spawnedCreatures or spawnedDefenders
+        uint32 leader; // Index into slots of the current leader, promoted when it dies
+        std::vector<ObjectGuid> followedLeader; // Leader each member was last told to follow, indexed like slots
+        bool inInterest = true; // A participant is near the leader, refreshed every movement pass
+    };
+    std::vector<SiegeSquad> squads;
+    std::vector<int32> creatureSquads; // Squad of each attacker slot, -1 if not in a squad
+    std::vector<int32> defenderSquads; // Squad of each defender slot, -1 if not in a squad
+    ObjectGuid cityLeaderGuid; // GUID of the city leader being defended, resolved at siege start
     std::string cityLeaderName; // Name of the city leader (for RP script placeholders)
+    bool cityLeaderKilled = false; // Set by the unit death hook when the city leader dies
+    uint32 nextLeaderScan = 0; // Earliest time the leader may be searched for again if its GUID goes stale
     bool cinematicPhase;
     uint32 lastYellTime;
     uint32 lastStatusAnnouncement; // For 5-minute countdown announcements
@@ -301,7 +634,12 @@ struct SiegeEvent
     bool countdown25Announced; // 25% time remaining announced
     uint32 rpScriptIndex; // Current line in the RP script (sequential playback)
     std::vector<std::string> activeRPScript; // The chosen RP script lines for this siege
-    std::unordered_map<ObjectGuid, uint32> creatureWaypointProgress; // Tracks which waypoint each creature is on (attackers and defenders)
+    std::string startMessage; // CitySiege.Message.SiegeStart resolved for this siege
+    std::string endMessage; // CitySiege.Message.SiegeEnd resolved for this siege
+    std::vector<ObjectGuid> participants; // Players within the announce radius, refreshed by the scheduler
+    uint32 realParticipants = 0; // Participants that are not playerbots
+    float armyScale = 1.0f; // Spawn count and respawn rate multiplier (see ComputeSiegeArmyScale)
+    std::unordered_map<ObjectGuid, SiegeUnitProgress> botWaypointProgress; // Tracks which waypoint each playerbot is on (creatures keep theirs in their slot)
     
     // Playerbot participants
     std::vector<ObjectGuid> defenderBots; // Playerbots defending the city
@@ -317,32 +655,136 @@ struct SiegeEvent
         std::string rpgStrategy; // Store RPG strategy if active ("rpg", "new rpg", or empty)
     };
     std::vector<BotReturnPosition> botReturnPositions; // Original positions to return bots to
+
+    // Recruited bots are teleported in batches during the cinematic instead of all on the start tick
+    struct PendingBotTeleport
+    {
+        ObjectGuid botGuid;
+        float x, y, z;
+    };
+    std::vector<PendingBotTeleport> pendingBotTeleports;
+    size_t nextBotTeleport = 0; // Index of the next pendingBotTeleports entry to teleport
+
+#ifdef MOD_PLAYERBOTS
+    // Travel destinations of the city waypoints, indexed like city.waypoints. Built on first use,
+    // shared by every bot of this siege and owned by the siege until DeactivatePlayerbotsFromSiege.
+    struct BotWaypointDestination
+    {
+        WorldPosition* position;
+        TravelDestination* destination;
+    };
+    std::vector<BotWaypointDestination> botDestinations;
+#endif
     
     // Bot respawn tracking: stores bot GUID, death time, and faction
     struct BotRespawnData
     {
         ObjectGuid botGuid;
-        uint32 deathTime;
+        uint32 respawnTime; // When the bot is due to respawn
         bool isDefender; // true = defender, false = attacker
     };
-    std::vector<BotRespawnData> deadBots; // Bots waiting to respawn
+    std::vector<BotRespawnData> deadBots; // Bots waiting to respawn, min-heap on respawnTime
     
     // Respawn tracking: stores creature GUID, entry, and death time
     struct RespawnData
     {
         ObjectGuid guid;
         uint32 entry;
-        uint32 deathTime;
+        uint32 respawnTime; // When the creature is due to respawn, resolved from its role at death
+        uint32 slot; // Slot in spawnedCreatures or spawnedDefenders that the respawned unit takes over
+        SiegeUnitRole role; // Role of the dead unit, drives respawn delay, level and scale
         bool isDefender; // Track if this is a defender for correct respawn
     };
-    std::vector<RespawnData> deadCreatures; // Creatures waiting to respawn
+    std::vector<RespawnData> deadCreatures; // Creatures waiting to respawn, min-heap on respawnTime
+
+    // Teardown of an ended siege, spread over several ticks (see UpdateSiegeTeardown)
+    SiegeTeardownStage teardownStage = SIEGE_TEARDOWN_NONE;
+    size_t teardownCursor = 0; // Progress within the current teardown stage
+    int rewardTeam = -1; // Team rewarded in SIEGE_TEARDOWN_REWARDS
+    uint32 rewardedPlayers = 0;
+
+    // Outcome and totals saved to city_siege_results once the rewards are handed out
+    bool defendersWon = false;
+    uint32 endedAt = 0; // When the siege actually ended (endTime is when it was scheduled to)
+    SiegeCounter<uint32> attackerDeaths; // Attacking creatures and bots killed
+    SiegeCounter<uint32> defenderDeaths; // Defending creatures and bots killed
+    uint32 honorAwarded = 0;
+    uint32 moneyAwarded = 0; // Copper, mailed rewards included
+    uint32 mailedRewards = 0; // Rewards mailed to participants who had logged out
+    CharacterDatabaseTransaction resultTransaction; // Reward mails and the results row, committed in one go
+
+    std::shared_ptr<const SiegeConfigSnapshot> config; // City registry the siege started with
+
+    // Telemetry, counted without CitySiege.DebugMode and sampled by the status stage
+    SiegeCounter<uint32> botDeaths; // Playerbots of either side killed
+    SiegeCounter<uint32> playerKills; // Siege units killed by a player, a playerbot or their pet
+    SiegeCounter<uint32> respawns; // Creatures and bots respawned
+    SiegeCounter<uint64> leaderDamage; // Damage taken by the city leader
+    SiegeCounter<uint32> stuckRecoveries; // Units recovered by the stuck detector (see RecoverStuckSiegeUnit)
+    uint32 allianceParticipants = 0; // Participants by faction, counted by RefreshSiegeParticipants
+    uint32 hordeParticipants = 0;
+    std::array<SiegeTelemetrySample, SIEGE_TELEMETRY_SAMPLES> telemetry = { };
+    uint32 telemetrySamples = 0; // Samples taken, the latest is telemetry[(telemetrySamples - 1) % SIEGE_TELEMETRY_SAMPLES]
+    uint32 nextTelemetryTime = 0;
 
     // Weather storage for siege weather override
     WeatherState originalWeatherType; // Store original weather type
     float originalWeatherGrade; // Store original weather grade
     bool weatherOverridden; // Track if weather was overridden for this siege
+
+    // Announcements are rendered into a reused buffer, and only again once their numbers change
+    std::string messageBuffer;
+    uint64 messageKey = 0; // SiegeMessageKind and numbers messageBuffer was rendered for
+
+    // Scheduler: milliseconds accumulated towards each stage's next run
+    uint32 stageTimers[SIEGE_STAGE_MAX] = { };
+    bool mapStagesDeferred = false; // The budget cut the last map update short, goes first next time
+};
+
+/**
+ * @brief Gets the city of a siege from the config snapshot the siege started with.
+ * @param event The siege.
+ * @return The besieged city.
+ */
+inline const CityData& GetSiegeCity(const SiegeEvent& event)
+{
+    return event.config->cities[event.cityId];
+}
+
+// Announcements rendered through RenderSiegeMessage, part of the message key
+enum SiegeMessageKind : uint8
+{
+    SIEGE_MSG_NONE = 0,
+    SIEGE_MSG_PRE_ANNOUNCE,
+    SIEGE_MSG_COUNTDOWN,
+    SIEGE_MSG_BATTLE_START,
+    SIEGE_MSG_STATUS,
+    SIEGE_MSG_RESULT
 };
 
+/**
+ * @brief Renders an announcement into the message buffer of a siege. Nothing is rendered if the
+ * buffer already holds the same announcement, and clearing the buffer keeps its capacity.
+ * @param event The siege event.
+ * @param kind The announcement.
+ * @param numbers The numbers in the announcement, 32 bits at most.
+ * @param render Function appending the text to the back_insert_iterator it is given.
+ * @return The rendered announcement.
+ */
+template <class Render>
+const std::string& RenderSiegeMessage(SiegeEvent& event, SiegeMessageKind kind, uint32 numbers, Render&& render)
+{
+    uint64 key = (uint64(kind) << 32) | numbers;
+    if (event.messageKey != key)
+    {
+        event.messageBuffer.clear();
+        render(std::back_inserter(event.messageBuffer));
+        event.messageKey = key;
+    }
+
+    return event.messageBuffer;
+}
+
 // Active siege events
 static std::vector<SiegeEvent> g_ActiveSieges;
 static uint32 g_NextSiegeTime = 0;
@@ -350,3671 +792,5944 @@ static uint32 g_NextSiegeTime = 0;
 // Waypoint visualization tracking
 static std::unordered_map<uint32, std::vector<ObjectGuid>> g_WaypointVisualizations; // cityId -> vector of creature GUIDs
 
+// Ground heights of the static siege points of a city, probed once instead of every tick
+struct CityHeightCache
+{
+    bool built = false;
+    std::vector<SiegeEvent::PendingSpawn> formation; // Ground-adjusted formation slots (entry left 0)
+    std::vector<std::vector<Waypoint>> pathJitter; // Reachable jitter targets around each path point
+    std::vector<Waypoint> defenderRespawnPoints; // Ground-adjusted respawn ring around the city leader
+    float spawnGroundZ = 0.0f; // Ground height at the attacker spawn point
+    std::unordered_map<uint64, float> groundCells; // Memoized ground probes of moving units, keyed by grid cell
+};
+
+// Navmesh path of one leg between consecutive siege path points, shared by every unit walking it
+struct SiegePathLeg
+{
+    bool computed = false;
+    Movement::PointsArray points; // Empty if no complete path was found
+};
+
+struct CityPathCache
+{
+    std::vector<SiegePathLeg> forwardLegs;  // Leg i runs from path point i to i+1 (attackers)
+    std::vector<SiegePathLeg> backwardLegs; // Leg i runs from path point i+1 to i (defenders)
+    bool precomputed = false; // Every leg has been computed (see PrecomputeSiegeCityCaches)
+    uint32 precomputeRetryTime = 0; // Earliest time to look for a pathfinding source again
+};
+
+// Placeholders understood in configured messages, yells and RP scripts
+enum SiegeTextToken : uint8
+{
+    SIEGE_TOKEN_TEXT   = 0, // Literal text
+    SIEGE_TOKEN_CITY   = 1, // {CITY} or {CITYNAME}
+    SIEGE_TOKEN_LEADER = 2  // {LEADER}, name of the defending city leader
+};
+
+// A configured text split into literal parts and placeholders, compiled once when the config loads
+struct SiegeTextTemplate
+{
+    std::vector<std::pair<SiegeTextToken, std::string>> parts;
+};
+
+// Compiled message templates and yell lists (see LoadCitySiegeConfiguration)
+static SiegeTextTemplate g_MessageSiegeStartTemplate;
+static SiegeTextTemplate g_MessageSiegeEndTemplate;
+static std::vector<std::string> g_LeaderSpawnYells;
+static std::vector<std::string> g_CombatYells;
+static std::vector<std::vector<SiegeTextTemplate>> g_RPScriptTemplatesAlliance; // Scripts, each a list of lines
+static std::vector<std::vector<SiegeTextTemplate>> g_RPScriptTemplatesHorde;
+
 // -----------------------------------------------------------------------------
 // HELPER FUNCTIONS
 // -----------------------------------------------------------------------------
 
-// Forward declarations
-void DistributeRewards(const SiegeEvent& event, const CityData& city, int winningTeam = -1);
-
 /**
- * @brief Sets siege weather for a city during RP phase
- * @param city The city to set weather for
- * @param event The siege event to store original weather state
+ * @brief Splits a configured string on a separator, dropping empty entries.
+ * @param text The configured string.
+ * @param separator Separator character.
+ * @return The non-empty entries.
  */
-void SetSiegeWeather(const CityData& city, SiegeEvent& event)
+std::vector<std::string> SplitSiegeConfigList(const std::string& text, char separator)
 {
-    if (!g_WeatherEnabled)
-        return;
+    std::vector<std::string> entries;
+    size_t start = 0;
+    while (start <= text.size())
+    {
+        size_t end = text.find(separator, start);
+        if (end == std::string::npos)
+        {
+            end = text.size();
+        }
 
-    Map* map = sMapMgr->FindMap(city.mapId, 0);
-    if (!map)
-        return;
+        if (end > start)
+        {
+            entries.push_back(text.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+    return entries;
+}
 
-    // Get the zone ID from the city center coordinates
-    uint32 zoneId = map->GetZoneId(0, city.centerX, city.centerY, city.centerZ);
+/**
+ * @brief Compiles a configured text into literal parts and placeholders.
+ * @param text The configured text.
+ * @return The compiled template.
+ */
+SiegeTextTemplate CompileSiegeText(const std::string& text)
+{
+    static const std::pair<const char*, SiegeTextToken> placeholders[] =
+    {
+        { "{CITYNAME}", SIEGE_TOKEN_CITY },
+        { "{CITY}",     SIEGE_TOKEN_CITY },
+        { "{LEADER}",   SIEGE_TOKEN_LEADER }
+    };
 
-    // Store original weather state
-    // Note: Weather::GetWeatherState() and Weather::GetGrade() are private methods
-    // Since we can't access them from a module, we'll restore to fine weather
-    event.originalWeatherType = WEATHER_STATE_FINE;
-    event.originalWeatherGrade = 0.0f;
-    event.weatherOverridden = true;
+    SiegeTextTemplate compiled;
+    std::string literal;
+    size_t pos = 0;
+    while (pos < text.size())
+    {
+        bool matched = false;
+        if (text[pos] == '{')
+        {
+            for (const auto& placeholder : placeholders)
+            {
+                size_t length = strlen(placeholder.first);
+                if (text.compare(pos, length, placeholder.first) == 0)
+                {
+                    if (!literal.empty())
+                    {
+                        compiled.parts.emplace_back(SIEGE_TOKEN_TEXT, literal);
+                        literal.clear();
+                    }
+                    compiled.parts.emplace_back(placeholder.second, std::string());
+                    pos += length;
+                    matched = true;
+                    break;
+                }
+            }
+        }
 
-    // Set siege weather
-    map->SetZoneWeather(zoneId, g_WeatherType, g_WeatherGrade);
+        if (!matched)
+        {
+            literal += text[pos++];
+        }
+    }
 
-    if (g_DebugMode)
+    if (!literal.empty())
     {
-        LOG_INFO("server.loading", "[City Siege] Set siege weather for {} (zone {}): type={}, grade={:.2f}",
-                 city.name, zoneId, static_cast<uint32>(g_WeatherType), g_WeatherGrade);
+        compiled.parts.emplace_back(SIEGE_TOKEN_TEXT, literal);
     }
+    return compiled;
 }
 
 /**
- * @brief Restores original weather for a city after siege ends
- * @param city The city to restore weather for
- * @param event The siege event containing original weather state
+ * @brief Compiles the configured RP scripts: scripts separated by |, lines within each script by ;
+ * @param text The configured RP scripts.
+ * @return The compiled scripts.
  */
-void RestoreSiegeWeather(const CityData& city, SiegeEvent& event)
+std::vector<std::vector<SiegeTextTemplate>> CompileSiegeRPScripts(const std::string& text)
 {
-    if (!g_WeatherEnabled || !event.weatherOverridden)
-        return;
+    std::vector<std::vector<SiegeTextTemplate>> scripts;
+    for (const std::string& script : SplitSiegeConfigList(text, '|'))
+    {
+        std::vector<SiegeTextTemplate> lines;
+        for (const std::string& line : SplitSiegeConfigList(script, ';'))
+        {
+            lines.push_back(CompileSiegeText(line));
+        }
 
-    Map* map = sMapMgr->FindMap(city.mapId, 0);
-    if (!map)
-        return;
+        if (!lines.empty())
+        {
+            scripts.push_back(lines);
+        }
+    }
+    return scripts;
+}
 
-    // Get the zone ID from the city center coordinates
-    uint32 zoneId = map->GetZoneId(0, city.centerX, city.centerY, city.centerZ);
+/**
+ * @brief Resolves the placeholders of a compiled template.
+ * @param text The compiled template.
+ * @param cityName Replacement for {CITY} and {CITYNAME}.
+ * @param leaderName Replacement for {LEADER}.
+ * @return The resolved text.
+ */
+std::string ResolveSiegeText(const SiegeTextTemplate& text, const std::string& cityName, const std::string& leaderName)
+{
+    std::string resolved;
+    for (const auto& part : text.parts)
+    {
+        switch (part.first)
+        {
+            case SIEGE_TOKEN_CITY:
+                resolved += cityName;
+                break;
+            case SIEGE_TOKEN_LEADER:
+                resolved += leaderName;
+                break;
+            default:
+                resolved += part.second;
+                break;
+        }
+    }
+    return resolved;
+}
 
-    // Restore original weather
-    map->SetZoneWeather(zoneId, event.originalWeatherType, event.originalWeatherGrade);
+// Accumulated profiler data of one section
+struct SiegePerfStats
+{
+    uint64 totalUs = 0;
+    uint32 calls = 0;
+    uint32 maxUs = 0;
+    std::vector<uint32> samples; // Most recent durations in microseconds (ring buffer) for the percentiles
+    uint32 nextSample = 0;
+};
 
-    if (g_DebugMode)
+static const uint32 SIEGE_PERF_SAMPLES = 1024;
+static SiegePerfStats g_PerfStats[SIEGE_PERF_MAX];
+static std::mutex g_PerfLock; // The map update threads record their sections concurrently
+
+/**
+ * @brief Adds one measured call to a set of profiler stats.
+ * @param stats The stats to add to.
+ * @param durationUs Duration of the call in microseconds.
+ */
+void AddSiegePerfSample(SiegePerfStats& stats, uint32 durationUs)
+{
+    stats.totalUs += durationUs;
+    ++stats.calls;
+    stats.maxUs = std::max(stats.maxUs, durationUs);
+
+    if (stats.samples.size() < SIEGE_PERF_SAMPLES)
     {
-        LOG_INFO("server.loading", "[City Siege] Restored original weather for {} (zone {}): type={}, grade={:.2f}",
-                 city.name, zoneId, static_cast<uint32>(event.originalWeatherType), event.originalWeatherGrade);
+        stats.samples.push_back(durationUs);
+    }
+    else
+    {
+        stats.samples[stats.nextSample] = durationUs;
+        stats.nextSample = (stats.nextSample + 1) % SIEGE_PERF_SAMPLES;
     }
+}
 
-    event.weatherOverridden = false;
+/**
+ * @brief Adds one measured call to the profiler.
+ * @param section The profiled section.
+ * @param durationUs Duration of the call in microseconds.
+ */
+void RecordSiegePerf(SiegePerfSection section, uint32 durationUs)
+{
+    std::lock_guard<std::mutex> guard(g_PerfLock);
+    AddSiegePerfSample(g_PerfStats[section], durationUs);
 }
 
 /**
- * @brief Loads the configuration for the City Siege module.
+ * @brief Measures the wall time of a scope and records it for a profiler section.
+ * Used from the world thread and the map update threads.
  */
-void LoadCitySiegeConfiguration()
+class SiegePerfScope
 {
-    g_CitySiegeEnabled = sConfigMgr->GetOption<bool>("CitySiege.Enabled", true);
-    g_DebugMode = sConfigMgr->GetOption<bool>("CitySiege.DebugMode", false);
+public:
+    explicit SiegePerfScope(SiegePerfSection section)
+        : _section(section), _start(std::chrono::steady_clock::now()), _active(g_PerfEnabled) { }
 
-    // Timer settings (convert minutes to seconds)
-    g_TimerMin = sConfigMgr->GetOption<uint32>("CitySiege.TimerMin", 120) * 60;
-    g_TimerMax = sConfigMgr->GetOption<uint32>("CitySiege.TimerMax", 240) * 60;
-    g_EventDuration = sConfigMgr->GetOption<uint32>("CitySiege.EventDuration", 30) * 60;
+    ~SiegePerfScope() { Finish(); }
 
-    // Event settings
-    g_AllowMultipleCities = sConfigMgr->GetOption<bool>("CitySiege.AllowMultipleCities", false);
-    g_AnnounceRadius = sConfigMgr->GetOption<uint32>("CitySiege.AnnounceRadius", 1500);
-    g_MinimumLevel = sConfigMgr->GetOption<uint32>("CitySiege.MinimumLevel", 1);
+    // Records the time so far, for sections that end before the scope does
+    void Finish()
+    {
+        if (!_active)
+        {
+            return;
+        }
 
-    // City enable/disable flags
-    g_CityEnabled["Stormwind"] = sConfigMgr->GetOption<bool>("CitySiege.Stormwind.Enabled", true);
-    g_CityEnabled["Ironforge"] = sConfigMgr->GetOption<bool>("CitySiege.Ironforge.Enabled", true);
-    g_CityEnabled["Darnassus"] = sConfigMgr->GetOption<bool>("CitySiege.Darnassus.Enabled", true);
-    g_CityEnabled["Exodar"] = sConfigMgr->GetOption<bool>("CitySiege.Exodar.Enabled", true);
-    g_CityEnabled["Orgrimmar"] = sConfigMgr->GetOption<bool>("CitySiege.Orgrimmar.Enabled", true);
-    g_CityEnabled["Undercity"] = sConfigMgr->GetOption<bool>("CitySiege.Undercity.Enabled", true);
-    g_CityEnabled["ThunderBluff"] = sConfigMgr->GetOption<bool>("CitySiege.ThunderBluff.Enabled", true);
-    g_CityEnabled["Silvermoon"] = sConfigMgr->GetOption<bool>("CitySiege.Silvermoon.Enabled", true);
+        _active = false;
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _start);
+        RecordSiegePerf(_section, uint32(elapsed.count()));
+    }
 
-    // Spawn counts
-    g_SpawnCountMinions = sConfigMgr->GetOption<uint32>("CitySiege.SpawnCount.Minions", 15);
-    g_SpawnCountElites = sConfigMgr->GetOption<uint32>("CitySiege.SpawnCount.Elites", 5);
-    g_SpawnCountMiniBosses = sConfigMgr->GetOption<uint32>("CitySiege.SpawnCount.MiniBosses", 2);
-    g_SpawnCountLeaders = sConfigMgr->GetOption<uint32>("CitySiege.SpawnCount.Leaders", 1);
+    // Drops the measurement (nothing worth recording happened)
+    void Cancel() { _active = false; }
 
-    // Creature entries - Mount Hyjal battle units
-    g_CreatureAllianceMinion = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Alliance.Minion", 17919);   // Alliance Footman
-    g_CreatureAllianceElite = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Alliance.Elite", 17920);     // Alliance Knight
-    g_CreatureAllianceMiniBoss = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Alliance.MiniBoss", 17921); // Alliance Rifleman
-    g_CreatureHordeMinion = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Horde.Minion", 17932);         // Horde Grunt
-    g_CreatureHordeElite = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Horde.Elite", 17933);           // Tauren Warrior
-    g_CreatureHordeMiniBoss = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Horde.MiniBoss", 17934);     // Horde Headhunter
-
-    // Aggro settings
-    g_AggroPlayers = sConfigMgr->GetOption<bool>("CitySiege.AggroPlayers", true);
-    g_AggroNPCs = sConfigMgr->GetOption<bool>("CitySiege.AggroNPCs", true);
-
-    // Defender settings
-    g_DefendersEnabled = sConfigMgr->GetOption<bool>("CitySiege.Defenders.Enabled", true);
-    g_DefendersCount = sConfigMgr->GetOption<uint32>("CitySiege.Defenders.Count", 10);
-    g_CreatureAllianceDefender = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Alliance.Defender", 17919);
-    g_CreatureHordeDefender = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Horde.Defender", 17932);
+private:
+    SiegePerfSection _section;
+    std::chrono::steady_clock::time_point _start;
+    bool _active;
+};
 
-    // Level settings
-    g_LevelLeader = sConfigMgr->GetOption<uint32>("CitySiege.Level.Leader", 80);
-    g_LevelMiniBoss = sConfigMgr->GetOption<uint32>("CitySiege.Level.MiniBoss", 80);
-    g_LevelElite = sConfigMgr->GetOption<uint32>("CitySiege.Level.Elite", 75);
-    g_LevelMinion = sConfigMgr->GetOption<uint32>("CitySiege.Level.Minion", 70);
-    g_LevelDefender = sConfigMgr->GetOption<uint32>("CitySiege.Level.Defender", 70);
+/**
+ * @brief Formats one line of profiler stats.
+ * @param name Name of the section.
+ * @param stats The stats, with at least one call.
+ * @return The report line.
+ */
+std::string FormatSiegePerfLine(const char* name, const SiegePerfStats& stats)
+{
+    // Percentiles over the most recent samples
+    std::vector<uint32> sorted(stats.samples);
+    std::sort(sorted.begin(), sorted.end());
+    uint32 p50 = sorted[sorted.size() / 2];
+    uint32 p99 = sorted[std::min<size_t>(sorted.size() - 1, sorted.size() * 99 / 100)];
+
+    char line[256];
+    snprintf(line, sizeof(line), "%-14s calls %u | total %.1f ms | avg %.3f | p50 %.3f | p99 %.3f | max %.3f ms",
+        name, stats.calls, stats.totalUs / 1000.0,
+        stats.totalUs / 1000.0 / stats.calls, p50 / 1000.0, p99 / 1000.0, stats.maxUs / 1000.0);
+    return line;
+}
 
-    // Scale settings
-    g_ScaleLeader = sConfigMgr->GetOption<float>("CitySiege.Scale.Leader", 1.6f);
-    g_ScaleMiniBoss = sConfigMgr->GetOption<float>("CitySiege.Scale.MiniBoss", 1.3f);
+/**
+ * @brief Formats the profiler data, one line per section that has been measured.
+ * @return The report lines.
+ */
+std::vector<std::string> BuildSiegePerfReport()
+{
+    std::lock_guard<std::mutex> guard(g_PerfLock);
+    std::vector<std::string> lines;
+    for (uint8 section = 0; section < SIEGE_PERF_MAX; ++section)
+    {
+        if (g_PerfStats[section].calls)
+        {
+            lines.push_back(FormatSiegePerfLine(g_PerfSectionNames[section], g_PerfStats[section]));
+        }
+    }
+    return lines;
+}
 
-    // Cinematic settings
-    g_CinematicDelay = sConfigMgr->GetOption<uint32>("CitySiege.CinematicDelay", 150);
-    g_YellFrequency = sConfigMgr->GetOption<uint32>("CitySiege.YellFrequency", 30);
+/**
+ * @brief Clears all profiler data.
+ */
+void ResetSiegePerf()
+{
+    std::lock_guard<std::mutex> guard(g_PerfLock);
+    for (SiegePerfStats& stats : g_PerfStats)
+    {
+        stats = SiegePerfStats();
+    }
+}
 
-    // Respawn settings
-    g_RespawnEnabled = sConfigMgr->GetOption<bool>("CitySiege.Respawn.Enabled", true);
-    g_RespawnTimeLeader = sConfigMgr->GetOption<uint32>("CitySiege.Respawn.LeaderTime", 300);
-    g_RespawnTimeMiniBoss = sConfigMgr->GetOption<uint32>("CitySiege.Respawn.MiniBossTime", 180);
-    g_RespawnTimeElite = sConfigMgr->GetOption<uint32>("CitySiege.Respawn.EliteTime", 120);
-    g_RespawnTimeMinion = sConfigMgr->GetOption<uint32>("CitySiege.Respawn.MinionTime", 60);
-    g_RespawnTimeDefender = sConfigMgr->GetOption<uint32>("CitySiege.Defenders.RespawnTime", 45);
+// Forward declarations
+void DistributeRewards(SiegeEvent& event, const CityData& city, int winningTeam = -1);
+void BeginSiegeResult(SiegeEvent& event, int winningTeam, bool defendersWon);
+void SaveSiegeResult(SiegeEvent& event);
+void StartSiegeUnitMarch(SiegeEvent& event, Creature* creature, uint32 slot, bool isDefender);
+void StartSiegeCacheLoad();
 
-    // Reward settings
-    g_RewardOnDefense = sConfigMgr->GetOption<bool>("CitySiege.RewardOnDefense", true);
-    g_RewardHonor = sConfigMgr->GetOption<uint32>("CitySiege.RewardHonor", 100);
-    g_RewardGoldBase = sConfigMgr->GetOption<uint32>("CitySiege.RewardGoldBase", 5000);
-    g_RewardGoldPerLevel = sConfigMgr->GetOption<uint32>("CitySiege.RewardGoldPerLevel", 5000);
+/**
+ * @brief Records a spawned attacker together with its role.
+ * @param event The siege event the attacker belongs to.
+ * @param guid GUID of the spawned creature.
+ * @param role Role of the creature in the siege army.
+ */
+void AddSiegeAttacker(SiegeEvent& event, ObjectGuid guid, SiegeUnitRole role)
+{
+    uint32 slot = event.spawnedCreatures.size();
+    if (role == SIEGE_ROLE_LEADER || role == SIEGE_ROLE_MINIBOSS)
+    {
+        event.rpSpeakerSlots.push_back(slot);
+    }
 
-    // Messages
-    g_MessageSiegeStart = sConfigMgr->GetOption<std::string>("CitySiege.Message.SiegeStart", 
-        "|cffff0000[City Siege]|r The city of {CITYNAME} is under attack! Defenders are needed!");
-    g_MessageSiegeEnd = sConfigMgr->GetOption<std::string>("CitySiege.Message.SiegeEnd", 
-        "|cff00ff00[City Siege]|r The siege of {CITYNAME} has ended!");
-    g_MessageReward = sConfigMgr->GetOption<std::string>("CitySiege.Message.Reward", 
-        "|cff00ff00[City Siege]|r You have been rewarded for defending {CITYNAME}!");
-    
-    // Yells
-    g_YellLeaderSpawn = sConfigMgr->GetOption<std::string>("CitySiege.Yell.LeaderSpawn", 
-        "This city will fall before our might!");
-    g_YellsCombat = sConfigMgr->GetOption<std::string>("CitySiege.Yell.Combat", 
-        "Your defenses crumble!;This city will burn!;Face your doom!;None can stand against us!;Your leaders will fall!");
-    
-    // RP Phase scripts (multiple scripts separated by |, lines within each script separated by ;)
-    g_RPScriptsAlliance = sConfigMgr->GetOption<std::string>("CitySiege.RP.Alliance", 
-        "Citizens of {CITY}, your time has come! We march under the banner of the Alliance!;{LEADER}, your people cry out for mercy, but you have shown none to ours!;We have crossed mountains and seas to bring justice to {CITY}. Surrender now, or face annihilation!;The Light guides our blades, and the might of Stormwind stands behind us. Your defenses will crumble!;This ends today! {LEADER}, come forth and face the Alliance, or watch {CITY} burn!|The Alliance has gathered its greatest heroes for this assault on {CITY}. You cannot stand against us!;{LEADER}, your leadership has made the Horde enemies it cannot defeat! We will tear down these walls!;Too long have you raided our villages and slaughtered our people. Today, we bring the war to {CITY}!;Your shamans' magic cannot protect you. Our priests and paladins have blessed this army!;Prepare to face the wrath of the Alliance! {LEADER}, your reign over {CITY} ends here and now!|By order of King Varian Wrynn, {CITY} is to be taken! Resistance is futile!;{LEADER}! Come forth and face us, or hide like a coward while your people suffer!;The Horde's reign of terror ends here at {CITY}. We will show no mercy to those who threaten peace!;Our siege engines are ready. The walls of {CITY} mean nothing to the might of the Alliance!;For every innocent killed by Horde aggression, {LEADER}, you will pay with your life!");
-    g_RPScriptsHorde = sConfigMgr->GetOption<std::string>("CitySiege.RP.Horde", 
-        "The Horde has come to claim {CITY}! Your precious Alliance ends today!;{LEADER}, you have oppressed our people for the last time! Come out and face your fate!;We are not savages - we are warriors! And today, we show {CITY} what true strength means!;Your guards are weak. Your walls are weak. {LEADER} hides in the throne room while we stand at the gates!;Blood and honor! Today we prove that the Horde is the superior force in Azeroth!|Citizens of {CITY}, flee while you can! We have come for your leaders, not for you!;{LEADER}! Your reign of tyranny over {CITY} ends today! The throne will belong to the Horde!;You call us monsters, but it is YOU who started this war! We finish it today at {CITY}!;The spirits of our ancestors guide us. No amount of Light magic will save {CITY} from our wrath!;Lok'tar Ogar! {LEADER}, today you fall, and the Horde claims {CITY}!|The Warchief has sent his finest warriors to end Alliance tyranny at {CITY} once and for all!;Your pitiful city guard cannot stop the Horde war machine! {LEADER}, your time has come!;We march for honor! We march for glory! We march to prove that the Horde will take {CITY}!;Every siege tower, every warrior, every drop of blood spilled today at {CITY} - it all leads to YOUR defeat!;{LEADER}, the Alliance has grown soft under your leadership. Today at {CITY}, the Horde reminds you why you should fear us!");
+    SiegeEvent::UnitSlot unit;
+    unit.role = role;
 
-#ifdef MOD_PLAYERBOTS
-    // Playerbot Integration
-    g_PlayerbotsEnabled = sConfigMgr->GetOption<bool>("CitySiege.Playerbots.Enabled", false);
-    g_PlayerbotsMinLevel = sConfigMgr->GetOption<uint32>("CitySiege.Playerbots.MinLevel", 70);
-    g_PlayerbotsMaxDefenders = sConfigMgr->GetOption<uint32>("CitySiege.Playerbots.MaxDefenders", 20);
-    g_PlayerbotsMaxAttackers = sConfigMgr->GetOption<uint32>("CitySiege.Playerbots.MaxAttackers", 20);
-    g_PlayerbotsRespawnDelay = sConfigMgr->GetOption<uint32>("CitySiege.Playerbots.RespawnDelay", 30);
-#endif
+    event.spawnedCreatures.push_back(guid);
+    event.creatureSlots.push_back(unit);
+    event.unitIndex[guid] = { slot, false, false };
+}
 
-    // Weather settings
-    g_WeatherEnabled = sConfigMgr->GetOption<bool>("CitySiege.Weather.Enabled", true);
-    g_WeatherType = static_cast<WeatherState>(sConfigMgr->GetOption<uint32>("CitySiege.Weather.Type", WEATHER_STATE_MEDIUM_RAIN));
-    g_WeatherGrade = sConfigMgr->GetOption<float>("CitySiege.Weather.Grade", 0.8f);
+/**
+ * @brief Gets the slot state of a siege creature.
+ * @param event The siege event the creature belongs to.
+ * @param slot Slot of the creature in spawnedCreatures or spawnedDefenders.
+ * @param isDefender True for city defenders, false for attackers.
+ * @return The slot state.
+ */
+inline SiegeEvent::UnitSlot& GetSiegeUnitSlot(SiegeEvent& event, uint32 slot, bool isDefender)
+{
+    return isDefender ? event.defenderSlots[slot] : event.creatureSlots[slot];
+}
 
-    // Music settings
-    g_MusicEnabled   = sConfigMgr->GetOption<bool>("CitySiege.Music.Enabled", true);
-    g_RPMusicId      = sConfigMgr->GetOption<uint32>("CitySiege.Music.RPMusicId", 11803);        // The Burning Legion
-    g_CombatMusicId  = sConfigMgr->GetOption<uint32>("CitySiege.Music.CombatMusicId", 11804); // Battle of Mount Hyjal
-    g_VictoryMusicId = sConfigMgr->GetOption<uint32>("CitySiege.Music.VictoryMusicId", 16039); // Invincible
-    g_DefeatMusicId  = sConfigMgr->GetOption<uint32>("CitySiege.Music.DefeatMusicId", 14127);   // Wrath of the Lich King
+/**
+ * @brief Heap ordering for the respawn queues: the entry due first sits at the front.
+ */
+struct RespawnDueLater
+{
+    template <class T>
+    bool operator()(T const& a, T const& b) const
+    {
+        return a.respawnTime > b.respawnTime;
+    }
+};
 
-    // Load spawn locations for each city
-    g_Cities[CITY_STORMWIND].spawnX = sConfigMgr->GetOption<float>("CitySiege.Stormwind.SpawnX", -9161.16f);
-    g_Cities[CITY_STORMWIND].spawnY = sConfigMgr->GetOption<float>("CitySiege.Stormwind.SpawnY", 353.365f);
-    g_Cities[CITY_STORMWIND].spawnZ = sConfigMgr->GetOption<float>("CitySiege.Stormwind.SpawnZ", 88.117f);
-    
-    g_Cities[CITY_IRONFORGE].spawnX = sConfigMgr->GetOption<float>("CitySiege.Ironforge.SpawnX", -5174.09f);
-    g_Cities[CITY_IRONFORGE].spawnY = sConfigMgr->GetOption<float>("CitySiege.Ironforge.SpawnY", -594.361f);
-    g_Cities[CITY_IRONFORGE].spawnZ = sConfigMgr->GetOption<float>("CitySiege.Ironforge.SpawnZ", 397.853f);
-    
-    g_Cities[CITY_DARNASSUS].spawnX = sConfigMgr->GetOption<float>("CitySiege.Darnassus.SpawnX", 9887.36f);
-    g_Cities[CITY_DARNASSUS].spawnY = sConfigMgr->GetOption<float>("CitySiege.Darnassus.SpawnY", 1856.49f);
-    g_Cities[CITY_DARNASSUS].spawnZ = sConfigMgr->GetOption<float>("CitySiege.Darnassus.SpawnZ", 1317.14f);
-    
-    g_Cities[CITY_EXODAR].spawnX = sConfigMgr->GetOption<float>("CitySiege.Exodar.SpawnX", -4080.80f);
-    g_Cities[CITY_EXODAR].spawnY = sConfigMgr->GetOption<float>("CitySiege.Exodar.SpawnY", -12193.2f);
-    g_Cities[CITY_EXODAR].spawnZ = sConfigMgr->GetOption<float>("CitySiege.Exodar.SpawnZ", 1.712f);
-    
-    g_Cities[CITY_ORGRIMMAR].spawnX = sConfigMgr->GetOption<float>("CitySiege.Orgrimmar.SpawnX", 1114.96f);
-    g_Cities[CITY_ORGRIMMAR].spawnY = sConfigMgr->GetOption<float>("CitySiege.Orgrimmar.SpawnY", -4374.63f);
-    g_Cities[CITY_ORGRIMMAR].spawnZ = sConfigMgr->GetOption<float>("CitySiege.Orgrimmar.SpawnZ", 25.813f);
-    
-    g_Cities[CITY_UNDERCITY].spawnX = sConfigMgr->GetOption<float>("CitySiege.Undercity.SpawnX", 1982.26f);
-    g_Cities[CITY_UNDERCITY].spawnY = sConfigMgr->GetOption<float>("CitySiege.Undercity.SpawnY", 226.674f);
-    g_Cities[CITY_UNDERCITY].spawnZ = sConfigMgr->GetOption<float>("CitySiege.Undercity.SpawnZ", 35.951f);
-    
-    g_Cities[CITY_THUNDERBLUFF].spawnX = sConfigMgr->GetOption<float>("CitySiege.ThunderBluff.SpawnX", -1558.61f);
-    g_Cities[CITY_THUNDERBLUFF].spawnY = sConfigMgr->GetOption<float>("CitySiege.ThunderBluff.SpawnY", -5.071f);
-    g_Cities[CITY_THUNDERBLUFF].spawnZ = sConfigMgr->GetOption<float>("CitySiege.ThunderBluff.SpawnZ", 5.384f);
-    
-    g_Cities[CITY_SILVERMOON].spawnX = sConfigMgr->GetOption<float>("CitySiege.Silvermoon.SpawnX", 9230.47f);
-    g_Cities[CITY_SILVERMOON].spawnY = sConfigMgr->GetOption<float>("CitySiege.Silvermoon.SpawnY", -6962.67f);
-    g_Cities[CITY_SILVERMOON].spawnZ = sConfigMgr->GetOption<float>("CitySiege.Silvermoon.SpawnZ", 5.004f);
-
-    // Load leader locations for each city
-    g_Cities[CITY_STORMWIND].leaderX = sConfigMgr->GetOption<float>("CitySiege.Stormwind.LeaderX", -8442.578f);
-    g_Cities[CITY_STORMWIND].leaderY = sConfigMgr->GetOption<float>("CitySiege.Stormwind.LeaderY", 334.6064f);
-    g_Cities[CITY_STORMWIND].leaderZ = sConfigMgr->GetOption<float>("CitySiege.Stormwind.LeaderZ", 122.476685f);
-    
-    g_Cities[CITY_IRONFORGE].leaderX = sConfigMgr->GetOption<float>("CitySiege.Ironforge.LeaderX", -4981.25f);
-    g_Cities[CITY_IRONFORGE].leaderY = sConfigMgr->GetOption<float>("CitySiege.Ironforge.LeaderY", -881.542f);
-    g_Cities[CITY_IRONFORGE].leaderZ = sConfigMgr->GetOption<float>("CitySiege.Ironforge.LeaderZ", 501.660f);
-    
-    g_Cities[CITY_DARNASSUS].leaderX = sConfigMgr->GetOption<float>("CitySiege.Darnassus.LeaderX", 9947.52f);
-    g_Cities[CITY_DARNASSUS].leaderY = sConfigMgr->GetOption<float>("CitySiege.Darnassus.LeaderY", 2482.73f);
-    g_Cities[CITY_DARNASSUS].leaderZ = sConfigMgr->GetOption<float>("CitySiege.Darnassus.LeaderZ", 1316.21f);
-    
-    g_Cities[CITY_EXODAR].leaderX = sConfigMgr->GetOption<float>("CitySiege.Exodar.LeaderX", -3864.92f);
-    g_Cities[CITY_EXODAR].leaderY = sConfigMgr->GetOption<float>("CitySiege.Exodar.LeaderY", -11643.7f);
-    g_Cities[CITY_EXODAR].leaderZ = sConfigMgr->GetOption<float>("CitySiege.Exodar.LeaderZ", -137.644f);
-    
-    g_Cities[CITY_ORGRIMMAR].leaderX = sConfigMgr->GetOption<float>("CitySiege.Orgrimmar.LeaderX", 1633.75f);
-    g_Cities[CITY_ORGRIMMAR].leaderY = sConfigMgr->GetOption<float>("CitySiege.Orgrimmar.LeaderY", -4439.39f);
-    g_Cities[CITY_ORGRIMMAR].leaderZ = sConfigMgr->GetOption<float>("CitySiege.Orgrimmar.LeaderZ", 15.4396f);
-    
-    g_Cities[CITY_UNDERCITY].leaderX = sConfigMgr->GetOption<float>("CitySiege.Undercity.LeaderX", 1633.75f);
-    g_Cities[CITY_UNDERCITY].leaderY = sConfigMgr->GetOption<float>("CitySiege.Undercity.LeaderY", 240.167f);
-    g_Cities[CITY_UNDERCITY].leaderZ = sConfigMgr->GetOption<float>("CitySiege.Undercity.LeaderZ", -43.1034f);
-    
-    g_Cities[CITY_THUNDERBLUFF].leaderX = sConfigMgr->GetOption<float>("CitySiege.ThunderBluff.LeaderX", -1043.11f);
-    g_Cities[CITY_THUNDERBLUFF].leaderY = sConfigMgr->GetOption<float>("CitySiege.ThunderBluff.LeaderY", 285.809f);
-    g_Cities[CITY_THUNDERBLUFF].leaderZ = sConfigMgr->GetOption<float>("CitySiege.ThunderBluff.LeaderZ", 135.165f);
-    
-    g_Cities[CITY_SILVERMOON].leaderX = sConfigMgr->GetOption<float>("CitySiege.Silvermoon.LeaderX", 9338.74f);
-    g_Cities[CITY_SILVERMOON].leaderY = sConfigMgr->GetOption<float>("CitySiege.Silvermoon.LeaderY", -7277.27f);
-    g_Cities[CITY_SILVERMOON].leaderZ = sConfigMgr->GetOption<float>("CitySiege.Silvermoon.LeaderZ", 13.7014f);
+/**
+ * @brief Adds an entry to a respawn queue.
+ * @param queue Respawn queue kept as a min-heap on respawnTime.
+ * @param entry The entry to add.
+ */
+template <class T>
+void PushRespawnEntry(std::vector<T>& queue, T const& entry)
+{
+    queue.push_back(entry);
+    std::push_heap(queue.begin(), queue.end(), RespawnDueLater());
+}
 
-    // Load waypoints for each city
-    for (auto& city : g_Cities)
+/**
+ * @brief Takes the next due entry off a respawn queue.
+ * @param queue Respawn queue kept as a min-heap on respawnTime.
+ * @param currentTime Current server time in seconds.
+ * @param entry Receives the popped entry.
+ * @return True if an entry was due and has been popped.
+ */
+template <class T>
+bool PopDueRespawnEntry(std::vector<T>& queue, uint32 currentTime, T& entry)
+{
+    if (queue.empty() || queue.front().respawnTime > currentTime)
     {
-        city.waypoints.clear();
-        
-        // Get waypoint count for this city
-        std::string waypointCountKey = "CitySiege." + city.name + ".WaypointCount";
-        uint32 waypointCount = sConfigMgr->GetOption<uint32>(waypointCountKey, 0);
-        
-        if (g_DebugMode)
-        {
-            LOG_INFO("server.loading", "[City Siege] Loading {} waypoints for {}", waypointCount, city.name);
-        }
-        
-        // Load each waypoint
-        for (uint32 i = 0; i < waypointCount; ++i)
-        {
-            std::string baseKey = "CitySiege." + city.name + ".Waypoint" + std::to_string(i + 1);
-            Waypoint wp;
-            wp.x = sConfigMgr->GetOption<float>(baseKey + ".X", 0.0f);
-            wp.y = sConfigMgr->GetOption<float>(baseKey + ".Y", 0.0f);
-            wp.z = sConfigMgr->GetOption<float>(baseKey + ".Z", 0.0f);
-            
-            // Only add waypoint if coordinates are valid
-            if (wp.x != 0.0f || wp.y != 0.0f || wp.z != 0.0f)
-            {
-                city.waypoints.push_back(wp);
-                
-                if (g_DebugMode)
-                {
-                    LOG_INFO("server.loading", "[City Siege]   Waypoint {}: ({}, {}, {})", 
-                             i + 1, wp.x, wp.y, wp.z);
-                }
-            }
-        }
+        return false;
     }
 
-    if (g_DebugMode)
+    std::pop_heap(queue.begin(), queue.end(), RespawnDueLater());
+    entry = queue.back();
+    queue.pop_back();
+    return true;
+}
+
+/**
+ * @brief Records a spawned city defender.
+ * @param event The siege event the defender belongs to.
+ * @param guid GUID of the spawned creature.
+ */
+void AddSiegeDefender(SiegeEvent& event, ObjectGuid guid)
+{
+    SiegeEvent::UnitSlot unit;
+    unit.role = SIEGE_ROLE_DEFENDER;
+
+    event.unitIndex[guid] = { static_cast<uint32>(event.spawnedDefenders.size()), true, false };
+    event.spawnedDefenders.push_back(guid);
+    event.defenderSlots.push_back(unit);
+}
+
+/**
+ * @brief Fills the per-role settings table from the CitySiege.* settings just read.
+ */
+void BuildSiegeRoleSettings()
+{
+    ReactStates attackerReact = (g_AggroPlayers && g_AggroNPCs) ? REACT_AGGRESSIVE : REACT_DEFENSIVE;
+
+    g_RoleSettings[SIEGE_ROLE_LEADER] = { { 0, 0 }, g_LevelLeader, g_ScaleLeader, g_RespawnTimeLeader, g_SpawnCountLeaders, attackerReact };
+    g_RoleSettings[SIEGE_ROLE_MINIBOSS] = { { g_CreatureAllianceMiniBoss, g_CreatureHordeMiniBoss }, g_LevelMiniBoss, g_ScaleMiniBoss,
+        g_RespawnTimeMiniBoss, g_SpawnCountMiniBosses, attackerReact };
+    g_RoleSettings[SIEGE_ROLE_ELITE] = { { g_CreatureAllianceElite, g_CreatureHordeElite }, g_LevelElite, 1.0f,
+        g_RespawnTimeElite, g_SpawnCountElites, attackerReact };
+    g_RoleSettings[SIEGE_ROLE_MINION] = { { g_CreatureAllianceMinion, g_CreatureHordeMinion }, g_LevelMinion, 1.0f,
+        g_RespawnTimeMinion, g_SpawnCountMinions, attackerReact };
+    g_RoleSettings[SIEGE_ROLE_DEFENDER] = { { g_CreatureAllianceDefender, g_CreatureHordeDefender }, g_LevelDefender, 1.0f,
+        g_RespawnTimeDefender, g_DefendersEnabled ? g_DefendersCount : 0, REACT_AGGRESSIVE };
+}
+
+/**
+ * @brief Gets the configured respawn delay for a siege unit role.
+ * @param role The role of the unit.
+ * @return Respawn delay in seconds.
+ */
+inline uint32 GetSiegeRoleRespawnTime(SiegeUnitRole role)
+{
+    return g_RoleSettings[role].respawnTime;
+}
+
+/**
+ * @brief Gets the configured number of units of a role in the siege formation.
+ * @param role The role of the unit.
+ * @return Number of units to spawn.
+ */
+inline uint32 GetSiegeRoleSpawnCount(SiegeUnitRole role)
+{
+    return g_RoleSettings[role].spawnCount;
+}
+
+/**
+ * @brief Scales a configured unit count, keeping at least one unit of anything that is configured.
+ * @param count The configured count.
+ * @param scale The army scale.
+ * @return The scaled count.
+ */
+uint32 ScaleSiegeCount(uint32 count, float scale)
+{
+    if (!count)
     {
-        LOG_INFO("server.loading", "[City Siege] Configuration loaded:");
-        LOG_INFO("server.loading", "[City Siege]   Enabled: {}", g_CitySiegeEnabled);
-        LOG_INFO("server.loading", "[City Siege]   Timer: {}-{} minutes", g_TimerMin / 60, g_TimerMax / 60);
-        LOG_INFO("server.loading", "[City Siege]   Event Duration: {} minutes", g_EventDuration / 60);
+        return 0;
     }
+
+    return std::max<uint32>(1, uint32(count * scale + 0.5f));
 }
 
 /**
- * @brief Selects a random city for siege event.
- * @return Pointer to the selected CityData, or nullptr if no cities are available.
+ * @brief Gets the number of units of a role in a siege formation of the given scale.
+ * The leaders are never scaled, a siege always has its configured leaders.
+ * @param role The role of the unit.
+ * @param scale The army scale.
+ * @return Number of units to spawn.
  */
-CityData* SelectRandomCity()
+uint32 GetSiegeRoleScaledCount(SiegeUnitRole role, float scale)
 {
-    std::vector<CityData*> availableCities;
+    uint32 count = GetSiegeRoleSpawnCount(role);
+    return g_SiegeRoleTraits[role].scaled ? ScaleSiegeCount(count, scale) : count;
+}
 
-    for (auto& city : g_Cities)
+/**
+ * @brief Gets the size of one side of a siege army at the given scale.
+ * @param isDefender True for the defenders, false for the attackers.
+ * @param scale The army scale.
+ * @return Number of creatures on that side.
+ */
+uint32 GetSiegeArmySize(bool isDefender, float scale)
+{
+    uint32 size = 0;
+    for (uint8 role = 0; role < SIEGE_ROLE_MAX; ++role)
     {
-        if (g_CityEnabled[city.name])
+        if (g_SiegeRoleTraits[role].defender == isDefender)
         {
-            // Check if city already has an active siege (if multiple sieges not allowed)
-            if (!g_AllowMultipleCities)
-            {
-                bool alreadyUnderSiege = false;
-                for (const auto& siege : g_ActiveSieges)
-                {
-                    if (siege.isActive && siege.cityId == city.id)
-                    {
-                        alreadyUnderSiege = true;
-                        break;
-                    }
-                }
-                if (!alreadyUnderSiege)
-                {
-                    availableCities.push_back(&city);
-                }
-            }
-            else
-            {
-                availableCities.push_back(&city);
-            }
+            size += GetSiegeRoleScaledCount(static_cast<SiegeUnitRole>(role), scale);
         }
     }
+    return size;
+}
 
-    if (availableCities.empty())
-    {
-        return nullptr;
-    }
+/**
+ * @brief Gets the respawn delay of a siege unit role, shortened or stretched by the army scale.
+ * @param event The siege event.
+ * @param role The role of the unit.
+ * @return Respawn delay in seconds.
+ */
+uint32 GetSiegeRespawnDelay(const SiegeEvent& event, SiegeUnitRole role)
+{
+    return uint32(GetSiegeRoleRespawnTime(role) / event.armyScale);
+}
 
-    uint32 randomIndex = urand(0, availableCities.size() - 1);
-    return availableCities[randomIndex];
+/**
+ * @brief Puts a siege creature in the respawn queue; the unit respawned for it takes over its slot.
+ * @param event The siege event the creature belongs to.
+ * @param guid GUID of the dead, despawned or vanished creature.
+ * @param entry Creature entry.
+ * @param slot Slot of the creature in spawnedCreatures or spawnedDefenders.
+ * @param isDefender True for city defenders, false for attackers.
+ * @param currentTime Current server time in seconds.
+ * @return Role of the creature.
+ */
+SiegeUnitRole QueueSiegeRespawn(SiegeEvent& event, ObjectGuid guid, uint32 entry, uint32 slot, bool isDefender, uint32 currentTime)
+{
+    SiegeEvent::RespawnData respawnData;
+    respawnData.guid = guid;
+    respawnData.entry = entry;
+    respawnData.slot = slot;
+    SiegeEvent::UnitSlot& unitSlot = GetSiegeUnitSlot(event, slot, isDefender);
+    unitSlot.awaitingRespawn = true;
+    respawnData.role = unitSlot.role;
+    respawnData.respawnTime = currentTime + GetSiegeRespawnDelay(event, respawnData.role);
+    respawnData.isDefender = isDefender;
+    PushRespawnEntry(event.deadCreatures, respawnData);
+    return respawnData.role;
 }
 
 /**
- * @brief Announces a siege event to players.
- * @param city The city being sieged.
- * @param isStart True if siege is starting, false if ending.
+ * @brief Feeds a world update diff into the moving average the adaptive army size is based on.
+ * @param diff The world update diff in milliseconds.
  */
-void AnnounceSiege(const CityData& city, bool isStart)
+void SampleSiegeWorldDiff(uint32 diff)
 {
-    std::string message;
-    if (isStart)
+    // About the last 30 ticks, so single hitches do not resize an army
+    if (g_WorldDiffAverage <= 0.0f)
     {
-        message = g_MessageSiegeStart;
-        size_t pos = message.find("{CITYNAME}");
-        if (pos != std::string::npos)
-        {
-            message.replace(pos, 10, city.name);
-        }
+        g_WorldDiffAverage = float(diff);
     }
     else
     {
-        message = g_MessageSiegeEnd;
-        size_t pos = message.find("{CITYNAME}");
-        if (pos != std::string::npos)
-        {
-            message.replace(pos, 10, city.name);
-        }
+        g_WorldDiffAverage += (float(diff) - g_WorldDiffAverage) / 32.0f;
     }
+}
 
-    if (g_AnnounceRadius == 0)
-    {
-        // Announce to the entire world
-        sWorldSessionMgr->SendServerMessage(SERVER_MSG_STRING, message);
-    }
-    else
+/**
+ * @brief Computes the army scale for the current server load and siege population.
+ * The army grows with the real players around the city, from the minimum scale with nobody
+ * there to the maximum scale at CitySiege.Adaptive.FullPlayers, and shrinks in proportion
+ * while the world tick is over its target.
+ * @param realPlayers Real players within the announce radius of the siege.
+ * @return The army scale, 1 if adaptive army size is disabled.
+ */
+float ComputeSiegeArmyScale(uint32 realPlayers)
+{
+    if (!g_AdaptiveEnabled)
     {
-        // Announce to players in range
-        Map* map = sMapMgr->FindMap(city.mapId, 0);
-        if (map)
-        {
-            Map::PlayerList const& players = map->GetPlayers();
-            for (auto itr = players.begin(); itr != players.end(); ++itr)
-            {
-                if (Player* player = itr->GetSource())
-                {
-                    if (player->GetDistance(city.centerX, city.centerY, city.centerZ) <= g_AnnounceRadius)
-                    {
-                        ChatHandler(player->GetSession()).PSendSysMessage(message.c_str());
-                    }
-                }
-            }
-        }
+        return 1.0f;
     }
 
-    if (g_DebugMode)
+    float population = g_AdaptiveFullPlayers ? std::min(1.0f, float(realPlayers) / g_AdaptiveFullPlayers) : 1.0f;
+    float scale = g_AdaptiveMinScale + (g_AdaptiveMaxScale - g_AdaptiveMinScale) * population;
+
+    if (g_AdaptiveTargetDiff && g_WorldDiffAverage > g_AdaptiveTargetDiff)
     {
-        LOG_INFO("server.loading", "[City Siege] {}", message);
+        scale *= g_AdaptiveTargetDiff / g_WorldDiffAverage;
     }
+
+    return std::clamp(scale, g_AdaptiveMinScale, g_AdaptiveMaxScale);
 }
 
 /**
- * @brief Spawns siege creatures for a city siege event.
- * @param event The siege event to spawn creatures for.
- */
-void SpawnSiegeCreatures(SiegeEvent& event)
+ * @brief Sets siege weather for a city during RP phase
+ * @param city The city to set weather for
+ * @param event The siege event to store original weather state
+ */
+void SetSiegeWeather(const CityData& city, SiegeEvent& event)
 {
-    const CityData& city = g_Cities[event.cityId];
-    
+    if (!g_WeatherEnabled)
+        return;
+
+    Map* map = sMapMgr->FindMap(city.mapId, 0);
+    if (!map)
+        return;
+
+    // Get the zone ID from the city center coordinates
+    uint32 zoneId = map->GetZoneId(0, city.centerX, city.centerY, city.centerZ);
+
+    // Store original weather state
+    // Note: Weather::GetWeatherState() and Weather::GetGrade() are private methods
+    // Since we can't access them from a module, we'll restore to fine weather
+    event.originalWeatherType = WEATHER_STATE_FINE;
+    event.originalWeatherGrade = 0.0f;
+    event.weatherOverridden = true;
+
+    // Set siege weather
+    map->SetZoneWeather(zoneId, g_WeatherType, g_WeatherGrade);
+
     if (g_DebugMode)
     {
-        LOG_INFO("server.loading", "[City Siege] Spawning creatures for siege at {}", city.name);
-        LOG_INFO("server.loading", "[City Siege]   Minions: {}", g_SpawnCountMinions);
-        LOG_INFO("server.loading", "[City Siege]   Elites: {}", g_SpawnCountElites);
-        LOG_INFO("server.loading", "[City Siege]   Mini-Bosses: {}", g_SpawnCountMiniBosses);
-        LOG_INFO("server.loading", "[City Siege]   Leaders: {}", g_SpawnCountLeaders);
+        LOG_INFO("server.loading", "[City Siege] Set siege weather for {} (zone {}): type={}, grade={:.2f}",
+                 city.name, zoneId, static_cast<uint32>(g_WeatherType), g_WeatherGrade);
     }
+}
+
+/**
+ * @brief Restores original weather for a city after siege ends
+ * @param city The city to restore weather for
+ * @param event The siege event containing original weather state
+ */
+void RestoreSiegeWeather(const CityData& city, SiegeEvent& event)
+{
+    if (!g_WeatherEnabled || !event.weatherOverridden)
+        return;
 
     Map* map = sMapMgr->FindMap(city.mapId, 0);
     if (!map)
-    {
-        LOG_ERROR("server.loading", "[City Siege] Failed to find map {} for {}", city.mapId, city.name);
         return;
-    }
 
-    // Define creature entries based on city faction
-    // If it's an Alliance city, spawn Horde attackers (and vice versa)
-    bool isAllianceCity = (event.cityId <= CITY_EXODAR);
-    
-    // Use configured creature entries - spawn OPPOSITE faction as attackers
-    uint32 minionEntry = isAllianceCity ? g_CreatureHordeMinion : g_CreatureAllianceMinion;
-    uint32 eliteEntry = isAllianceCity ? g_CreatureHordeElite : g_CreatureAllianceElite;
-    uint32 miniBossEntry = isAllianceCity ? g_CreatureHordeMiniBoss : g_CreatureAllianceMiniBoss;
-    
-    // Randomly select a city leader from the opposing faction's leader pool
-    uint32 leaderEntry;
-    if (isAllianceCity)
-    {
-        // Horde attacking Alliance city - pick random Horde leader
-        uint32 randomIndex = urand(0, g_HordeCityLeaders.size() - 1);
-        leaderEntry = g_HordeCityLeaders[randomIndex];
-        
-        if (g_DebugMode)
-        {
-            LOG_INFO("server.loading", "[City Siege] Randomly selected Horde leader entry {} for attack on Alliance city {}", 
-                     leaderEntry, city.name);
-        }
-    }
-    else
-    {
-        // Alliance attacking Horde city - pick random Alliance leader
-        uint32 randomIndex = urand(0, g_AllianceCityLeaders.size() - 1);
-        leaderEntry = g_AllianceCityLeaders[randomIndex];
-        
-        if (g_DebugMode)
-        {
-            LOG_INFO("server.loading", "[City Siege] Randomly selected Alliance leader entry {} for attack on Horde city {}", 
-                     leaderEntry, city.name);
-        }
-    }
-    
-    // Military formation setup - organized ranks like a real army assault
-    // Leaders at center, mini-bosses forming command circle, elites in mid-rank, minions in outer perimeter
-    float baseRadius = 35.0f;
-    
-    // === RANK 1: LEADERS (Center/Command Post) ===
-    // Leaders spawn at the very center in a tight formation
-    float leaderRadius = 3.0f;
-    float leaderAngleStep = (2 * M_PI) / std::max(1u, g_SpawnCountLeaders);
-    for (uint32 i = 0; i < g_SpawnCountLeaders; ++i)
-    {
-        float angle = leaderAngleStep * i;
-        float x = city.spawnX + leaderRadius * cos(angle);
-        float y = city.spawnY + leaderRadius * sin(angle);
-        float z = city.spawnZ;
-        
-        // Get proper ground height
-        float groundZ = map->GetHeight(x, y, z + 50.0f, true, 50.0f);
-        if (groundZ > INVALID_HEIGHT)
-            z = groundZ + 0.5f;
-        
-        if (Creature* creature = map->SummonCreature(leaderEntry, Position(x, y, z, 0)))
-        {
-            creature->SetLevel(g_LevelLeader);
-            creature->SetObjectScale(g_ScaleLeader);
-            creature->SetDisableGravity(false);
-            creature->SetCanFly(false);
-            creature->SetHover(false);
-            creature->RemoveUnitMovementFlag(MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER);
-            creature->SetReactState(REACT_PASSIVE);
-            creature->SetFaction(35);
-            
-            // Prevent return to home position after combat
-            creature->SetWalk(false);
-            creature->GetMotionMaster()->Clear(false);
-            creature->GetMotionMaster()->MoveIdle();
-            
-            // Set home position to spawn location to prevent evading back
-            creature->SetHomePosition(x, y, z, 0.0f);
-            
-            // Enforce ground position immediately after spawn
-            creature->UpdateGroundPositionZ(x, y, z);
-            
-            event.spawnedCreatures.push_back(creature->GetGUID());
-            
-            // Parse leader spawn yells from configuration (semicolon separated for random selection)
-            std::vector<std::string> spawnYells;
-            std::string yellStr = g_YellLeaderSpawn;
-            size_t pos = 0;
-            while ((pos = yellStr.find(';')) != std::string::npos)
-            {
-                std::string yell = yellStr.substr(0, pos);
-                if (!yell.empty())
-                {
-                    spawnYells.push_back(yell);
-                }
-                yellStr.erase(0, pos + 1);
-            }
-            if (!yellStr.empty())
-            {
-                spawnYells.push_back(yellStr);
-            }
-            
-            // Yell a random spawn message
-            if (!spawnYells.empty() && creature->IsAlive())
-            {
-                uint32 randomIndex = urand(0, spawnYells.size() - 1);
-                creature->Yell(spawnYells[randomIndex].c_str(), LANG_UNIVERSAL);
-            }
-        }
-    }
+    // Get the zone ID from the city center coordinates
+    uint32 zoneId = map->GetZoneId(0, city.centerX, city.centerY, city.centerZ);
 
-    // === RANK 2: MINI-BOSSES (Command Circle) ===
-    // Form a protective circle around the leaders
-    float miniBossRadius = baseRadius * 0.3f; // ~10.5 yards
-    float miniBossAngleStep = (2 * M_PI) / std::max(1u, g_SpawnCountMiniBosses);
-    for (uint32 i = 0; i < g_SpawnCountMiniBosses; ++i)
-    {
-        float angle = miniBossAngleStep * i;
-        float x = city.spawnX + miniBossRadius * cos(angle);
-        float y = city.spawnY + miniBossRadius * sin(angle);
-        float z = city.spawnZ;
-        
-        float groundZ = map->GetHeight(x, y, z + 50.0f, true, 50.0f);
-        if (groundZ > INVALID_HEIGHT)
-            z = groundZ + 0.5f;
-        
-        if (Creature* creature = map->SummonCreature(miniBossEntry, Position(x, y, z, 0)))
-        {
-            creature->SetLevel(g_LevelMiniBoss);
-            creature->SetObjectScale(g_ScaleMiniBoss);
-            creature->SetDisableGravity(false);
-            creature->SetCanFly(false);
-            creature->SetHover(false);
-            creature->RemoveUnitMovementFlag(MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER);
-            creature->SetReactState(REACT_PASSIVE);
-            creature->SetFaction(35);
-            
-            // Prevent return to home position after combat
-            creature->SetWalk(false);
-            creature->GetMotionMaster()->Clear(false);
-            creature->GetMotionMaster()->MoveIdle();
-            
-            // Set home position to spawn location to prevent evading back
-            creature->SetHomePosition(x, y, z, 0);
-            
-            // Enforce ground position immediately after spawn
-            creature->UpdateGroundPositionZ(x, y, z);
-            
-            event.spawnedCreatures.push_back(creature->GetGUID());
-        }
-    }
+    // Restore original weather
+    map->SetZoneWeather(zoneId, event.originalWeatherType, event.originalWeatherGrade);
 
-    // === RANK 3: ELITES (Mid-Rank Officers) ===
-    // Form the middle rank in an organized formation
-    float eliteRadius = baseRadius * 0.6f; // ~21 yards
-    float eliteAngleStep = (2 * M_PI) / std::max(1u, g_SpawnCountElites);
-    for (uint32 i = 0; i < g_SpawnCountElites; ++i)
+    if (g_DebugMode)
     {
-        float angle = eliteAngleStep * i;
-        float x = city.spawnX + eliteRadius * cos(angle);
-        float y = city.spawnY + eliteRadius * sin(angle);
-        float z = city.spawnZ;
-        
-        float groundZ = map->GetHeight(x, y, z + 50.0f, true, 50.0f);
-        if (groundZ > INVALID_HEIGHT)
-            z = groundZ + 0.5f;
-        
-        if (Creature* creature = map->SummonCreature(eliteEntry, Position(x, y, z, 0)))
-        {
-            creature->SetLevel(g_LevelElite);
-            creature->SetDisableGravity(false);
-            creature->SetCanFly(false);
-            creature->SetHover(false);
-            creature->RemoveUnitMovementFlag(MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER);
-            creature->SetReactState(REACT_PASSIVE);
-            creature->SetFaction(35);
-            
-            // Prevent return to home position after combat
-            creature->SetWalk(false);
-            creature->GetMotionMaster()->Clear(false);
-            creature->GetMotionMaster()->MoveIdle();
-            
-            // Set home position to spawn location to prevent evading back
-            creature->SetHomePosition(x, y, z, 0);
-            
-            // Enforce ground position immediately after spawn
-            creature->UpdateGroundPositionZ(x, y, z);
-            
-            event.spawnedCreatures.push_back(creature->GetGUID());
-        }
+        LOG_INFO("server.loading", "[City Siege] Restored original weather for {} (zone {}): type={}, grade={:.2f}",
+                 city.name, zoneId, static_cast<uint32>(event.originalWeatherType), event.originalWeatherGrade);
     }
 
-    // === RANK 4: MINIONS (Front Line / Outer Perimeter) ===
-    // Form the outer perimeter - the main fighting force
-    float minionRadius = baseRadius; // Full 35 yards
-    float minionAngleStep = (2 * M_PI) / std::max(1u, g_SpawnCountMinions);
-    for (uint32 i = 0; i < g_SpawnCountMinions; ++i)
+    event.weatherOverridden = false;
+}
+
+/**
+ * @brief Loads the cities of the world database tables city_siege_city and city_siege_waypoint.
+ * A row replaces the built-in city with the same id and its conf keys. Ids from CITY_MAX on
+ * add custom cities, which must follow on without gaps.
+ * @param cities Registry being built, starting out as the built-in cities.
+ * @param enabled Receives the enabled flag of every loaded city.
+ * @return The cities that came from the database.
+ */
+std::bitset<SIEGE_MAX_CITIES> LoadSiegeCityTable(std::vector<CityData>& cities, std::bitset<SIEGE_MAX_CITIES>& enabled)
+{
+    std::bitset<SIEGE_MAX_CITIES> loaded;
+
+    QueryResult result = WorldDatabase.Query("SELECT `id`, `name`, `team`, `enabled`, `map_id`, `center_x`, `center_y`, `center_z`, "
+        "`spawn_x`, `spawn_y`, `spawn_z`, `leader_x`, `leader_y`, `leader_z`, `leader_entry` FROM `city_siege_city` ORDER BY `id`");
+    if (!result)
     {
-        float angle = minionAngleStep * i;
-        float x = city.spawnX + minionRadius * cos(angle);
-        float y = city.spawnY + minionRadius * sin(angle);
-        float z = city.spawnZ;
-        
-        float groundZ = map->GetHeight(x, y, z + 50.0f, true, 50.0f);
-        if (groundZ > INVALID_HEIGHT)
-            z = groundZ + 0.5f;
-        
-        if (Creature* creature = map->SummonCreature(minionEntry, Position(x, y, z, 0)))
-        {
-            creature->SetLevel(g_LevelMinion);
-            creature->SetDisableGravity(false);
-            creature->SetCanFly(false);
-            creature->SetHover(false);
-            creature->RemoveUnitMovementFlag(MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER);
-            creature->SetReactState(REACT_PASSIVE);
-            creature->SetFaction(35);
-            
-            // Prevent return to home position after combat
-            creature->SetWalk(false);
-            creature->GetMotionMaster()->Clear(false);
-            creature->GetMotionMaster()->MoveIdle();
-            
-            // Set home position to spawn location to prevent evading back
-            creature->SetHomePosition(x, y, z, 0);
-            creature->GetMotionMaster()->Clear(false);
-            creature->GetMotionMaster()->MoveIdle();
-            
-            // Enforce ground position immediately after spawn
-            creature->UpdateGroundPositionZ(x, y, z);
-            
-            event.spawnedCreatures.push_back(creature->GetGUID());
-            
-            if (g_DebugMode)
-            {
-                LOG_INFO("server.loading", "[City Siege] Spawned minion at ({}, {}, {})", x, y, z);
-            }
-        }
+        return loaded;
     }
 
-    LOG_INFO("server.loading", "[City Siege] Spawned {} total attacker creatures in military formation for siege at {}", 
-             event.spawnedCreatures.size(), city.name);
-    
-    // === SPAWN DEFENDERS ===
-    // Defenders spawn near the leader and march towards the attackers (reverse waypoint order)
-    if (g_DefendersEnabled && g_DefendersCount > 0)
+    do
     {
-        // Determine defender entry based on city faction (same faction as city)
-        bool isAllianceCity = (event.cityId <= CITY_EXODAR);
-        uint32 defenderEntry = isAllianceCity ? g_CreatureAllianceDefender : g_CreatureHordeDefender;
-        
-        // Spawn defenders in a formation near the leader position
-        float defenderRadius = 10.0f; // Spawn in 10-yard radius around leader
-        float defenderAngleStep = (2 * M_PI) / std::max(1u, g_DefendersCount);
-        
-        for (uint32 i = 0; i < g_DefendersCount; ++i)
+        Field* fields = result->Fetch();
+        uint32 id = fields[0].Get<uint8>();
+        if (id >= SIEGE_MAX_CITIES || id > cities.size())
         {
-            float angle = defenderAngleStep * i;
-            float x = city.leaderX + defenderRadius * cos(angle);
-            float y = city.leaderY + defenderRadius * sin(angle);
-            float z = city.leaderZ;
-            
-            float groundZ = map->GetHeight(x, y, z, true, 50.0f);
-            if (groundZ > INVALID_HEIGHT)
-                z = groundZ + 0.5f;
-            
-            if (Creature* creature = map->SummonCreature(defenderEntry, Position(x, y, z, 0)))
-            {
-                creature->SetLevel(g_LevelDefender);
-                creature->SetDisableGravity(false);
-                creature->SetCanFly(false);
-                creature->SetHover(false);
-                creature->RemoveUnitMovementFlag(MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER);
-                creature->SetReactState(REACT_PASSIVE);
-                creature->SetFaction(35);
-                
-                // Prevent return to home position after combat
-                creature->SetWalk(false);
-                creature->GetMotionMaster()->Clear(false);
-                creature->GetMotionMaster()->MoveIdle();
-                
-                // Set home position to spawn location
-                creature->SetHomePosition(x, y, z, 0);
-                
-                // Enforce ground position immediately after spawn
-                creature->UpdateGroundPositionZ(x, y, z);
-                
-                event.spawnedDefenders.push_back(creature->GetGUID());
-                
-                if (g_DebugMode)
-                {
-                    LOG_INFO("server.loading", "[City Siege] Spawned defender at ({}, {}, {})", x, y, z);
-                }
-            }
+            LOG_ERROR("server.loading", "[City Siege] city_siege_city: skipped id {}, custom cities need consecutive ids from {} to {}",
+                      id, uint32(CITY_MAX), SIEGE_MAX_CITIES - 1);
+            continue;
         }
-        
-        LOG_INFO("server.loading", "[City Siege] Spawned {} defender creatures for {}", 
-                 event.spawnedDefenders.size(), city.name);
-    }
-}
 
-/**
- * @brief Despawns all creatures from a siege event.
- * @param event The siege event to clean up.
- */
-void DespawnSiegeCreatures(SiegeEvent& event)
-{
-    const CityData& city = g_Cities[event.cityId];
-    Map* map = sMapMgr->FindMap(city.mapId, 0);
-    
-    if (map)
-    {
-        for (const auto& guid : event.spawnedCreatures)
+        if (id == cities.size())
         {
-            if (Creature* creature = map->GetCreature(guid))
-            {
-                creature->DespawnOrUnsummon();
-            }
+            cities.emplace_back();
         }
-        
-        // Despawn defenders
-        for (const ObjectGuid& guid : event.spawnedDefenders)
+
+        CityData& city = cities[id];
+        city.id = static_cast<CityId>(id);
+        city.name = fields[1].Get<std::string>();
+        city.team = fields[2].Get<uint8>() ? TEAM_HORDE : TEAM_ALLIANCE;
+        enabled[id] = fields[3].Get<bool>();
+        city.mapId = fields[4].Get<uint16>();
+        city.centerX = fields[5].Get<float>();
+        city.centerY = fields[6].Get<float>();
+        city.centerZ = fields[7].Get<float>();
+        city.spawnX = fields[8].Get<float>();
+        city.spawnY = fields[9].Get<float>();
+        city.spawnZ = fields[10].Get<float>();
+        city.leaderX = fields[11].Get<float>();
+        city.leaderY = fields[12].Get<float>();
+        city.leaderZ = fields[13].Get<float>();
+        city.targetLeaderEntry = fields[14].Get<uint32>();
+        city.waypoints.clear();
+        loaded[id] = true;
+    } while (result->NextRow());
+
+    // Cities from the table take their waypoints from the table as well
+    result = WorldDatabase.Query("SELECT `city_id`, `x`, `y`, `z` FROM `city_siege_waypoint` ORDER BY `city_id`, `point`");
+    if (result)
+    {
+        do
         {
-            if (Creature* creature = map->GetCreature(guid))
+            Field* fields = result->Fetch();
+            uint32 id = fields[0].Get<uint8>();
+            if (id < SIEGE_MAX_CITIES && loaded.test(id))
             {
-                creature->DespawnOrUnsummon();
+                cities[id].waypoints.push_back({ fields[1].Get<float>(), fields[2].Get<float>(), fields[3].Get<float>() });
             }
-        }
+        } while (result->NextRow());
     }
-    
-    event.spawnedCreatures.clear();
-    event.spawnedDefenders.clear();
 
-    if (g_DebugMode)
-    {
-        LOG_INFO("server.loading", "[City Siege] Despawned attackers and defenders for siege at {}", city.name);
-    }
+    return loaded;
 }
 
 /**
- * @brief Starts a new siege event in a random city.
- */
-/**
- * @brief Randomize a position within a radius to prevent creatures from bunching up.
- * @param x Original X coordinate
- * @param y Original Y coordinate
- * @param z Original Z coordinate (will be updated with proper ground height)
- * @param map Map to check ground height
- * @param radius Random radius (default 5.0 yards)
+ * @brief Reads the conf keys of a built-in city that has no city_siege_city row.
+ * Missing keys keep the built-in values.
+ * @param city The city, holding its built-in values.
+ * @param enabled Receives the enabled flag of the city.
  */
-void RandomizePosition(float& x, float& y, float& z, Map* map, float radius = 5.0f)
+void LoadSiegeCityConfig(CityData& city, std::bitset<SIEGE_MAX_CITIES>& enabled)
 {
-    // Generate random offset within radius
-    float angle = frand(0.0f, 2.0f * M_PI);
-    float dist = frand(0.0f, radius);
-    
-    x += dist * cos(angle);
-    y += dist * sin(angle);
-    
-    // Update Z to proper ground height
-    if (map)
-    {
-        float groundZ = map->GetHeight(x, y, z + 50.0f, true, 50.0f);
-        if (groundZ > INVALID_HEIGHT)
-            z = groundZ + 0.5f;
-    }
-}
+    std::string prefix = "CitySiege." + city.name + ".";
+    enabled[city.id] = sConfigMgr->GetOption<bool>(prefix + "Enabled", true);
 
-/**
- * @brief Validates and corrects ground position before movement to prevent floating/stuck units.
- * @param x X coordinate
- * @param y Y coordinate  
- * @param z Reference to Z coordinate to adjust
- * @param map Map to check ground height
- * @return true if position is valid, false if position is invalid/unreachable
- */
-bool ValidateGroundPosition(float x, float y, float& z, Map* map)
-{
-    if (!map)
-        return false;
+    city.spawnX = sConfigMgr->GetOption<float>(prefix + "SpawnX", city.spawnX);
+    city.spawnY = sConfigMgr->GetOption<float>(prefix + "SpawnY", city.spawnY);
+    city.spawnZ = sConfigMgr->GetOption<float>(prefix + "SpawnZ", city.spawnZ);
+    city.leaderX = sConfigMgr->GetOption<float>(prefix + "LeaderX", city.leaderX);
+    city.leaderY = sConfigMgr->GetOption<float>(prefix + "LeaderY", city.leaderY);
+    city.leaderZ = sConfigMgr->GetOption<float>(prefix + "LeaderZ", city.leaderZ);
 
-    // Get ground height with generous search range
-    float groundZ = map->GetHeight(x, y, z + 100.0f, true, 100.0f);
-    
-    // If ground height is invalid, try searching from below
-    if (groundZ <= INVALID_HEIGHT)
-    {
-        groundZ = map->GetHeight(x, y, z - 50.0f, true, 100.0f);
-    }
-    
-    // Still invalid - position is not reachable
-    if (groundZ <= INVALID_HEIGHT)
-    {
-        return false;
-    }
-    
-    // Clamp Z to be no more than 5 yards from ground (prevent high-altitude floating)
-    if (z > groundZ + 5.0f)
+    city.waypoints.clear();
+    uint32 waypointCount = sConfigMgr->GetOption<uint32>(prefix + "WaypointCount", 0);
+
+    if (g_DebugMode)
     {
-        z = groundZ + 0.5f;
+        LOG_INFO("server.loading", "[City Siege] Loading {} waypoints for {}", waypointCount, city.name);
     }
-    else if (z < groundZ - 2.0f)
+
+    for (uint32 i = 0; i < waypointCount; ++i)
     {
-        // Too far below ground, raise to ground level
-        z = groundZ + 0.5f;
+        std::string baseKey = prefix + "Waypoint" + std::to_string(i + 1);
+        Waypoint wp;
+        wp.x = sConfigMgr->GetOption<float>(baseKey + ".X", 0.0f);
+        wp.y = sConfigMgr->GetOption<float>(baseKey + ".Y", 0.0f);
+        wp.z = sConfigMgr->GetOption<float>(baseKey + ".Z", 0.0f);
+
+        // Only add waypoint if coordinates are valid
+        if (wp.x != 0.0f || wp.y != 0.0f || wp.z != 0.0f)
+        {
+            city.waypoints.push_back(wp);
+
+            if (g_DebugMode)
+            {
+                LOG_INFO("server.loading", "[City Siege]   Waypoint {}: ({}, {}, {})",
+                         i + 1, wp.x, wp.y, wp.z);
+            }
+        }
     }
-    
-    return true;
 }
 
 /**
- * @brief Recruits defending playerbots to teleport to the city being sieged
- * @param city The city structure containing position and faction info
- * @param event The siege event to store bot return positions
- * @return Vector of GUIDs of recruited defender bots
+ * @brief Loads the configuration for the City Siege module.
  */
-std::vector<ObjectGuid> RecruitDefendingPlayerbots(CityData const& city, SiegeEvent& event)
+void LoadCitySiegeConfiguration()
 {
-    std::vector<ObjectGuid> recruitedBots;
-    
-#ifdef MOD_PLAYERBOTS
-    if (!g_PlayerbotsEnabled)
-    {
-        return recruitedBots;
-    }
-    
-    // Get the defending faction for this city
-    TeamId defendingFaction = (city.id <= CITY_EXODAR) ? TEAM_ALLIANCE : TEAM_HORDE;
-    
-    if (g_DebugMode)
-    {
-        LOG_INFO("server.loading", "[City Siege] Recruiting defenders for {} - Need faction: {} ({})", 
-                 city.name, defendingFaction == TEAM_HORDE ? "HORDE" : "ALLIANCE", static_cast<int>(defendingFaction));
-    }
-    
-    // Get all playerbots from RandomPlayerbotMgr
-    auto allBots = sRandomPlayerbotMgr->GetAllBots();
-    std::vector<Player*> eligibleBots;
+    g_CitySiegeEnabled = sConfigMgr->GetOption<bool>("CitySiege.Enabled", true);
+    g_DebugMode = sConfigMgr->GetOption<bool>("CitySiege.DebugMode", false);
+
+    // Timer settings (convert minutes to seconds)
+    g_TimerMin = sConfigMgr->GetOption<uint32>("CitySiege.TimerMin", 120) * 60;
+    g_TimerMax = sConfigMgr->GetOption<uint32>("CitySiege.TimerMax", 240) * 60;
+    g_EventDuration = sConfigMgr->GetOption<uint32>("CitySiege.EventDuration", 30) * 60;
+
+    // Event settings
+    g_AllowMultipleCities = sConfigMgr->GetOption<bool>("CitySiege.AllowMultipleCities", false);
+    g_AnnounceRadius = sConfigMgr->GetOption<uint32>("CitySiege.AnnounceRadius", 1500);
+    g_MinimumLevel = sConfigMgr->GetOption<uint32>("CitySiege.MinimumLevel", 1);
+
+    // Spawn counts
+    g_SpawnCountMinions = sConfigMgr->GetOption<uint32>("CitySiege.SpawnCount.Minions", 15);
+    g_SpawnCountElites = sConfigMgr->GetOption<uint32>("CitySiege.SpawnCount.Elites", 5);
+    g_SpawnCountMiniBosses = sConfigMgr->GetOption<uint32>("CitySiege.SpawnCount.MiniBosses", 2);
+    g_SpawnCountLeaders = sConfigMgr->GetOption<uint32>("CitySiege.SpawnCount.Leaders", 1);
+    g_SpawnBatchSize = sConfigMgr->GetOption<uint32>("CitySiege.Spawn.BatchSize", 10);
+    g_SquadSize = sConfigMgr->GetOption<uint32>("CitySiege.Squad.Size", 0);
+    g_WavesEnabled = sConfigMgr->GetOption<bool>("CitySiege.Waves.Enabled", false);
+    g_WavesSize = std::max<uint32>(1, sConfigMgr->GetOption<uint32>("CitySiege.Waves.Size", 15));
+    g_WavesInterval = sConfigMgr->GetOption<uint32>("CitySiege.Waves.Interval", 90);
+    g_WavesMaxLive = sConfigMgr->GetOption<uint32>("CitySiege.Waves.MaxLive", 60);
+
+    // Creature entries - Mount Hyjal battle units
+    g_CreatureAllianceMinion = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Alliance.Minion", 17919);   // Alliance Footman
+    g_CreatureAllianceElite = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Alliance.Elite", 17920);     // Alliance Knight
+    g_CreatureAllianceMiniBoss = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Alliance.MiniBoss", 17921); // Alliance Rifleman
+    g_CreatureHordeMinion = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Horde.Minion", 17932);         // Horde Grunt
+    g_CreatureHordeElite = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Horde.Elite", 17933);           // Tauren Warrior
+    g_CreatureHordeMiniBoss = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Horde.MiniBoss", 17934);     // Horde Headhunter
+
+    // Aggro settings
+    g_AggroPlayers = sConfigMgr->GetOption<bool>("CitySiege.AggroPlayers", true);
+    g_AggroNPCs = sConfigMgr->GetOption<bool>("CitySiege.AggroNPCs", true);
+
+    // Defender settings
+    g_DefendersEnabled = sConfigMgr->GetOption<bool>("CitySiege.Defenders.Enabled", true);
+    g_DefendersCount = sConfigMgr->GetOption<uint32>("CitySiege.Defenders.Count", 10);
+    g_CreatureAllianceDefender = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Alliance.Defender", 17919);
+    g_CreatureHordeDefender = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Horde.Defender", 17932);
+
+    // Level settings
+    g_LevelLeader = sConfigMgr->GetOption<uint32>("CitySiege.Level.Leader", 80);
+    g_LevelMiniBoss = sConfigMgr->GetOption<uint32>("CitySiege.Level.MiniBoss", 80);
+    g_LevelElite = sConfigMgr->GetOption<uint32>("CitySiege.Level.Elite", 75);
+    g_LevelMinion = sConfigMgr->GetOption<uint32>("CitySiege.Level.Minion", 70);
+    g_LevelDefender = sConfigMgr->GetOption<uint32>("CitySiege.Level.Defender", 70);
+
+    // Scale settings
+    g_ScaleLeader = sConfigMgr->GetOption<float>("CitySiege.Scale.Leader", 1.6f);
+    g_ScaleMiniBoss = sConfigMgr->GetOption<float>("CitySiege.Scale.MiniBoss", 1.3f);
+
+    // Cinematic settings
+    g_CinematicDelay = sConfigMgr->GetOption<uint32>("CitySiege.CinematicDelay", 150);
+    g_YellFrequency = sConfigMgr->GetOption<uint32>("CitySiege.YellFrequency", 30);
+
+    // Respawn settings
+    g_RespawnEnabled = sConfigMgr->GetOption<bool>("CitySiege.Respawn.Enabled", true);
+    g_RespawnTimeLeader = sConfigMgr->GetOption<uint32>("CitySiege.Respawn.LeaderTime", 300);
+    g_RespawnTimeMiniBoss = sConfigMgr->GetOption<uint32>("CitySiege.Respawn.MiniBossTime", 180);
+    g_RespawnTimeElite = sConfigMgr->GetOption<uint32>("CitySiege.Respawn.EliteTime", 120);
+    g_RespawnTimeMinion = sConfigMgr->GetOption<uint32>("CitySiege.Respawn.MinionTime", 60);
+    g_RespawnTimeDefender = sConfigMgr->GetOption<uint32>("CitySiege.Defenders.RespawnTime", 45);
+
+    // Reward settings
+    g_RewardOnDefense = sConfigMgr->GetOption<bool>("CitySiege.RewardOnDefense", true);
+    g_RewardHonor = sConfigMgr->GetOption<uint32>("CitySiege.RewardHonor", 100);
+    g_RewardGoldBase = sConfigMgr->GetOption<uint32>("CitySiege.RewardGoldBase", 5000);
+    g_RewardGoldPerLevel = sConfigMgr->GetOption<uint32>("CitySiege.RewardGoldPerLevel", 5000);
+    g_RewardMailOffline = sConfigMgr->GetOption<bool>("CitySiege.RewardMailOffline", true);
+    g_ResultsEnabled = sConfigMgr->GetOption<bool>("CitySiege.Results.Enabled", true);
+
+    // Messages
+    g_MessageSiegeStart = sConfigMgr->GetOption<std::string>("CitySiege.Message.SiegeStart", 
+        "|cffff0000[City Siege]|r The city of {CITYNAME} is under attack! Defenders are needed!");
+    g_MessageSiegeEnd = sConfigMgr->GetOption<std::string>("CitySiege.Message.SiegeEnd", 
+        "|cff00ff00[City Siege]|r The siege of {CITYNAME} has ended!");
+    g_MessageReward = sConfigMgr->GetOption<std::string>("CitySiege.Message.Reward", 
+        "|cff00ff00[City Siege]|r You have been rewarded for defending {CITYNAME}!");
     
-    uint32 totalBots = 0, wrongFaction = 0, tooLowLevel = 0, notAlive = 0, inCombat = 0, inInstance = 0;
+    // Yells
+    g_YellLeaderSpawn = sConfigMgr->GetOption<std::string>("CitySiege.Yell.LeaderSpawn", 
+        "This city will fall before our might!");
+    g_YellsCombat = sConfigMgr->GetOption<std::string>("CitySiege.Yell.Combat", 
+        "Your defenses crumble!;This city will burn!;Face your doom!;None can stand against us!;Your leaders will fall!");
     
-    for (auto& pair : allBots)
+    // RP Phase scripts (multiple scripts separated by |, lines within each script separated by ;)
+    g_RPScriptsAlliance = sConfigMgr->GetOption<std::string>("CitySiege.RP.Alliance", 
+        "Citizens of {CITY}, your time has come! We march under the banner of the Alliance!;{LEADER}, your people cry out for mercy, but you have shown none to ours!;We have crossed mountains and seas to bring justice to {CITY}. Surrender now, or face annihilation!;The Light guides our blades, and the might of Stormwind stands behind us. Your defenses will crumble!;This ends today! {LEADER}, come forth and face the Alliance, or watch {CITY} burn!|The Alliance has gathered its greatest heroes for this assault on {CITY}. You cannot stand against us!;{LEADER}, your leadership has made the Horde enemies it cannot defeat! We will tear down these walls!;Too long have you raided our villages and slaughtered our people. Today, we bring the war to {CITY}!;Your shamans' magic cannot protect you. Our priests and paladins have blessed this army!;Prepare to face the wrath of the Alliance! {LEADER}, your reign over {CITY} ends here and now!|By order of King Varian Wrynn, {CITY} is to be taken! Resistance is futile!;{LEADER}! Come forth and face us, or hide like a coward while your people suffer!;The Horde's reign of terror ends here at {CITY}. We will show no mercy to those who threaten peace!;Our siege engines are ready. The walls of {CITY} mean nothing to the might of the Alliance!;For every innocent killed by Horde aggression, {LEADER}, you will pay with your life!");
+    g_RPScriptsHorde = sConfigMgr->GetOption<std::string>("CitySiege.RP.Horde", 
+        "The Horde has come to claim {CITY}! Your precious Alliance ends today!;{LEADER}, you have oppressed our people for the last time! Come out and face your fate!;We are not savages - we are warriors! And today, we show {CITY} what true strength means!;Your guards are weak. Your walls are weak. {LEADER} hides in the throne room while we stand at the gates!;Blood and honor! Today we prove that the Horde is the superior force in Azeroth!|Citizens of {CITY}, flee while you can! We have come for your leaders, not for you!;{LEADER}! Your reign of tyranny over {CITY} ends today! The throne will belong to the Horde!;You call us monsters, but it is YOU who started this war! We finish it today at {CITY}!;The spirits of our ancestors guide us. No amount of Light magic will save {CITY} from our wrath!;Lok'tar Ogar! {LEADER}, today you fall, and the Horde claims {CITY}!|The Warchief has sent his finest warriors to end Alliance tyranny at {CITY} once and for all!;Your pitiful city guard cannot stop the Horde war machine! {LEADER}, your time has come!;We march for honor! We march for glory! We march to prove that the Horde will take {CITY}!;Every siege tower, every warrior, every drop of blood spilled today at {CITY} - it all leads to YOUR defeat!;{LEADER}, the Alliance has grown soft under your leadership. Today at {CITY}, the Horde reminds you why you should fear us!");
+
+    // Compile messages, yells and RP scripts once so the siege never parses them at runtime
+    g_MessageSiegeStartTemplate = CompileSiegeText(g_MessageSiegeStart);
+    g_MessageSiegeEndTemplate = CompileSiegeText(g_MessageSiegeEnd);
+    g_LeaderSpawnYells = SplitSiegeConfigList(g_YellLeaderSpawn, ';');
+    g_CombatYells = SplitSiegeConfigList(g_YellsCombat, ';');
+    g_RPScriptTemplatesAlliance = CompileSiegeRPScripts(g_RPScriptsAlliance);
+    g_RPScriptTemplatesHorde = CompileSiegeRPScripts(g_RPScriptsHorde);
+
+#ifdef MOD_PLAYERBOTS
+    // Playerbot Integration
+    g_PlayerbotsEnabled = sConfigMgr->GetOption<bool>("CitySiege.Playerbots.Enabled", false);
+    g_PlayerbotsMinLevel = sConfigMgr->GetOption<uint32>("CitySiege.Playerbots.MinLevel", 70);
+    g_PlayerbotsMaxDefenders = sConfigMgr->GetOption<uint32>("CitySiege.Playerbots.MaxDefenders", 20);
+    g_PlayerbotsMaxAttackers = sConfigMgr->GetOption<uint32>("CitySiege.Playerbots.MaxAttackers", 20);
+    g_PlayerbotsRespawnDelay = sConfigMgr->GetOption<uint32>("CitySiege.Playerbots.RespawnDelay", 30);
+    g_PlayerbotsIndexInterval = sConfigMgr->GetOption<uint32>("CitySiege.Playerbots.IndexInterval", 60);
+    g_PlayerbotsIndexBatch = std::max<uint32>(1, sConfigMgr->GetOption<uint32>("CitySiege.Playerbots.IndexBatch", 100));
+    g_PlayerbotsTeleportBatch = sConfigMgr->GetOption<uint32>("CitySiege.Playerbots.TeleportBatch", 5);
+#endif
+
+    // Weather settings
+    g_WeatherEnabled = sConfigMgr->GetOption<bool>("CitySiege.Weather.Enabled", true);
+    g_WeatherType = static_cast<WeatherState>(sConfigMgr->GetOption<uint32>("CitySiege.Weather.Type", WEATHER_STATE_MEDIUM_RAIN));
+    g_WeatherGrade = sConfigMgr->GetOption<float>("CitySiege.Weather.Grade", 0.8f);
+
+    // Music settings
+    g_MusicEnabled   = sConfigMgr->GetOption<bool>("CitySiege.Music.Enabled", true);
+    g_RPMusicId      = sConfigMgr->GetOption<uint32>("CitySiege.Music.RPMusicId", 11803);        // The Burning Legion
+    g_CombatMusicId  = sConfigMgr->GetOption<uint32>("CitySiege.Music.CombatMusicId", 11804); // Battle of Mount Hyjal
+    g_VictoryMusicId = sConfigMgr->GetOption<uint32>("CitySiege.Music.VictoryMusicId", 16039); // Invincible
+    g_DefeatMusicId  = sConfigMgr->GetOption<uint32>("CitySiege.Music.DefeatMusicId", 14127);   // Wrath of the Lich King
+
+    // Scheduler settings
+    g_StageIntervals[SIEGE_STAGE_STATUS]   = sConfigMgr->GetOption<uint32>("CitySiege.Scheduler.StatusInterval", 1000);
+    g_StageIntervals[SIEGE_STAGE_YELLS]    = sConfigMgr->GetOption<uint32>("CitySiege.Scheduler.YellInterval", 1000);
+    g_StageIntervals[SIEGE_STAGE_RESPAWN]  = sConfigMgr->GetOption<uint32>("CitySiege.Scheduler.RespawnInterval", 1000);
+    g_StageIntervals[SIEGE_STAGE_MOVEMENT] = sConfigMgr->GetOption<uint32>("CitySiege.Scheduler.MovementInterval", 500);
+    g_StageIntervals[SIEGE_STAGE_PARTICIPANTS] = sConfigMgr->GetOption<uint32>("CitySiege.Scheduler.ParticipantInterval", 5000);
+    g_UpdateBudget = sConfigMgr->GetOption<uint32>("CitySiege.Scheduler.UpdateBudget", 10);
+    g_TeardownBatch = sConfigMgr->GetOption<uint32>("CitySiege.Scheduler.TeardownBatch", 25);
+    g_MapThreadUpdates = sConfigMgr->GetOption<bool>("CitySiege.Scheduler.MapThreadUpdates", true);
+
+    // Interest management
+    g_InterestEnabled = sConfigMgr->GetOption<bool>("CitySiege.Interest.Enabled", true);
+    g_InterestRadius = sConfigMgr->GetOption<float>("CitySiege.Interest.Radius", 150.0f);
+    g_InterestParkedInterval = std::max<uint32>(1, sConfigMgr->GetOption<uint32>("CitySiege.Interest.ParkedInterval", 5));
+
+    // Stuck units
+    g_StuckTimeout = sConfigMgr->GetOption<uint32>("CitySiege.Stuck.Timeout", 30);
+    g_StuckMaxBackoff = std::max<uint32>(1, sConfigMgr->GetOption<uint32>("CitySiege.Stuck.MaxBackoff", 8));
+    g_StuckAction = sConfigMgr->GetOption<uint32>("CitySiege.Stuck.Action", 0);
+
+    // Adaptive army size
+    g_AdaptiveEnabled = sConfigMgr->GetOption<bool>("CitySiege.Adaptive.Enabled", false);
+    g_AdaptiveDuringSiege = sConfigMgr->GetOption<bool>("CitySiege.Adaptive.DuringSiege", true);
+    g_AdaptiveTargetDiff = sConfigMgr->GetOption<uint32>("CitySiege.Adaptive.TargetDiff", 60);
+    g_AdaptiveMinScale = std::max(0.1f, sConfigMgr->GetOption<float>("CitySiege.Adaptive.MinScale", 0.5f));
+    g_AdaptiveMaxScale = std::max(g_AdaptiveMinScale, sConfigMgr->GetOption<float>("CitySiege.Adaptive.MaxScale", 1.5f));
+    g_AdaptiveFullPlayers = sConfigMgr->GetOption<uint32>("CitySiege.Adaptive.FullPlayers", 20);
+
+    // Telemetry
+    g_TelemetryEnabled = sConfigMgr->GetOption<bool>("CitySiege.Telemetry.Enabled", true);
+    g_TelemetryInterval = std::max<uint32>(1, sConfigMgr->GetOption<uint32>("CitySiege.Telemetry.Interval", 30));
+    g_TelemetryLog = sConfigMgr->GetOption<bool>("CitySiege.Telemetry.Log", false);
+    g_TelemetryMetrics = sConfigMgr->GetOption<bool>("CitySiege.Telemetry.Metrics", true);
+
+    // Profiler
+    g_PerfEnabled = sConfigMgr->GetOption<bool>("CitySiege.Perf.Enabled", true);
+    g_PerfLogInterval = sConfigMgr->GetOption<uint32>("CitySiege.Perf.LogInterval", 0);
+
+    BuildSiegeRoleSettings();
+
+    // City cache file
+    g_CacheEnabled = sConfigMgr->GetOption<bool>("CitySiege.Cache.Enabled", true);
+    g_CacheFile = sConfigMgr->GetOption<std::string>("CitySiege.Cache.File", "city_siege.cache");
+
+    // City registry: a new snapshot, swapped in once complete
+    std::shared_ptr<SiegeConfigSnapshot> config = std::make_shared<SiegeConfigSnapshot>();
+    config->cities = g_DefaultCities;
+    std::bitset<SIEGE_MAX_CITIES> fromDatabase = LoadSiegeCityTable(config->cities, config->cityEnabled);
+    for (CityData& city : config->cities)
     {
-        Player* bot = pair.second;
-        totalBots++;
-        
-        if (!bot || !bot->IsInWorld())
-            continue;
-            
-        // Check if bot is correct faction
-        if (bot->GetTeamId() != defendingFaction)
-        {
-            wrongFaction++;
-            continue;
-        }
-            
-        // Check level requirement
-        if (bot->GetLevel() < g_PlayerbotsMinLevel)
-        {
-            tooLowLevel++;
-            continue;
-        }
-            
-        // Check if alive
-        if (!bot->IsAlive())
-        {
-            notAlive++;
-            continue;
-        }
-            
-        // Check if not in combat
-        if (bot->IsInCombat())
-        {
-            inCombat++;
-            continue;
-        }
-            
-        // Check if not in instance/battleground
-        if (bot->GetMap()->IsDungeon() || bot->GetMap()->IsBattleground())
+        if (city.id < CITY_MAX && !fromDatabase.test(city.id))
         {
-            inInstance++;
-            continue;
+            LoadSiegeCityConfig(city, config->cityEnabled);
         }
 
-        // Skip bots that are in a party or raid (we want free random bots, not alts)
-        if (Group* group = bot->GetGroup())
-        {
-            // If the bot is in any group (party or raid), skip it
-            inInstance++; // reuse counter for grouped
-            continue;
-        }
-            
-        eligibleBots.push_back(bot);
+        // City positions may have changed, height and path caches start over with the snapshot
+        city.heights = std::make_shared<CityHeightCache>();
+        city.paths = std::make_shared<CityPathCache>();
     }
-    
+
     if (g_DebugMode)
     {
-        LOG_INFO("server.loading", "[City Siege] Defender recruitment stats - Total bots: {}, Wrong faction: {}, Too low level: {}, Dead: {}, In combat: {}, In instance: {}, Eligible: {}", 
-                 totalBots, wrongFaction, tooLowLevel, notAlive, inCombat, inInstance, eligibleBots.size());
+        LOG_INFO("server.loading", "[City Siege] Loaded {} cities ({} from city_siege_city), {} enabled, {} running sieges keep their previous config",
+                 config->cities.size(), fromDatabase.count(), config->cityEnabled.count(), g_ActiveSieges.size());
     }
-    
-    // Shuffle and take up to max defenders
-    if (eligibleBots.size() > g_PlayerbotsMaxDefenders)
+
+    g_Config = std::move(config);
+
+    // Caches of unchanged cities are read back from the cache file off the world thread
+    StartSiegeCacheLoad();
+
+    if (g_DebugMode)
     {
-        std::random_device rd;
-        std::mt19937 g(rd());
-        std::shuffle(eligibleBots.begin(), eligibleBots.end(), g);
-        eligibleBots.resize(g_PlayerbotsMaxDefenders);
+        LOG_INFO("server.loading", "[City Siege] Configuration loaded:");
+        LOG_INFO("server.loading", "[City Siege]   Enabled: {}", g_CitySiegeEnabled);
+        LOG_INFO("server.loading", "[City Siege]   Timer: {}-{} minutes", g_TimerMin / 60, g_TimerMax / 60);
+        LOG_INFO("server.loading", "[City Siege]   Event Duration: {} minutes", g_EventDuration / 60);
     }
-    
-    // Store original positions and teleport bots to city center
-    for (Player* bot : eligibleBots)
+}
+
+/**
+ * @brief Selects a random city for siege event.
+ * @return Pointer to the selected CityData, or nullptr if no cities are available.
+ */
+const CityData* SelectRandomCity()
+{
+    std::vector<const CityData*> availableCities;
+
+    for (const auto& city : g_Config->cities)
     {
-        // Store original position and PvP status for return later
-        SiegeEvent::BotReturnPosition returnPos;
-        returnPos.botGuid = bot->GetGUID();
-        returnPos.mapId = bot->GetMapId();
-        returnPos.x = bot->GetPositionX();
-        returnPos.y = bot->GetPositionY();
-        returnPos.z = bot->GetPositionZ();
-        returnPos.o = bot->GetOrientation();
-        returnPos.wasPvPFlagged = bot->IsPvP(); // Store original PvP status
-        
-        // Check for and store RPG strategy
-        PlayerbotAI* botAI = sPlayerbotsMgr->GetPlayerbotAI(bot);
-        if (botAI)
+        if (g_Config->cityEnabled.test(city.id))
         {
-            // Check for "rpg" or "new rpg" strategy
-            if (botAI->HasStrategy("new rpg", BOT_STATE_NON_COMBAT))
+            // Check if city already has an active siege (if multiple sieges not allowed)
+            if (!g_AllowMultipleCities)
             {
-                returnPos.rpgStrategy = "new rpg";
-                botAI->ChangeStrategy("-new rpg", BOT_STATE_NON_COMBAT); // Remove RPG strategy during siege
-                if (g_DebugMode)
+                bool alreadyUnderSiege = false;
+                for (const auto& siege : g_ActiveSieges)
                 {
-                    LOG_INFO("server.loading", "[City Siege] Removed 'new rpg' strategy from defender bot {}", bot->GetName());
+                    if (siege.isActive && siege.cityId == city.id)
+                    {
+                        alreadyUnderSiege = true;
+                        break;
+                    }
                 }
-            }
-            else if (botAI->HasStrategy("rpg", BOT_STATE_NON_COMBAT))
-            {
-                returnPos.rpgStrategy = "rpg";
-                botAI->ChangeStrategy("-rpg", BOT_STATE_NON_COMBAT); // Remove RPG strategy during siege
-                if (g_DebugMode)
+                if (!alreadyUnderSiege)
                 {
-                    LOG_INFO("server.loading", "[City Siege] Removed 'rpg' strategy from defender bot {}", bot->GetName());
+                    availableCities.push_back(&city);
                 }
             }
             else
             {
-                returnPos.rpgStrategy = ""; // No RPG strategy active
+                availableCities.push_back(&city);
             }
         }
-        
-        event.botReturnPositions.push_back(returnPos);
-        
-        // Randomize position within ~10 yards of the leader
-        float angle = frand(0.0f, 2.0f * M_PI);
-        float distance = frand(0.0f, 10.0f);
-        float defenderX = city.leaderX + distance * std::cos(angle);
-        float defenderY = city.leaderY + distance * std::sin(angle);
-        float defenderZ = city.leaderZ; // Keep same Z as leader (will be adjusted by server)
-        
-        // Teleport to randomized position near city leader (throne room)
-        bot->TeleportTo(city.mapId, defenderX, defenderY, defenderZ, 0.0f);
-        recruitedBots.push_back(bot->GetGUID());
-        
-        if (g_DebugMode)
-        {
-            LOG_INFO("server.loading", "[City Siege] Recruited defender bot {} (Level {}) to {} near leader at [{:.2f}, {:.2f}, {:.2f}] (will return to map {} at [{:.2f}, {:.2f}, {:.2f}])", 
-                     bot->GetName(), bot->GetLevel(), city.name, defenderX, defenderY, defenderZ, returnPos.mapId, returnPos.x, returnPos.y, returnPos.z);
-        }
     }
-    
-    if (g_DebugMode && !recruitedBots.empty())
+
+    if (availableCities.empty())
     {
-        LOG_INFO("server.loading", "[City Siege] Total {} defender bots recruited to {}", 
-                 recruitedBots.size(), city.name);
+        return nullptr;
     }
-#endif
-    
-    return recruitedBots;
+
+    uint32 randomIndex = urand(0, availableCities.size() - 1);
+    return availableCities[randomIndex];
 }
 
 /**
- * @brief Recruits attacking playerbots to teleport to the spawn point
- * @param city The city structure containing spawn position
- * @param event The siege event to store bot return positions
- * @return Vector of GUIDs of recruited attacker bots
+ * @brief Rebuilds the list of players within the announce radius of a siege.
+ * This is the only place that scans the whole continent, all broadcasts and rewards use the list.
+ * @param event The siege event to refresh.
  */
-std::vector<ObjectGuid> RecruitAttackingPlayerbots(CityData const& city, SiegeEvent& event)
+void RefreshSiegeParticipants(SiegeEvent& event)
 {
-    std::vector<ObjectGuid> recruitedBots;
-    
-#ifdef MOD_PLAYERBOTS
-    if (!g_PlayerbotsEnabled)
-    {
-        return recruitedBots;
-    }
-    
-    // Get the attacking faction (opposite of defending)
-    TeamId attackingFaction = (city.id <= CITY_EXODAR) ? TEAM_HORDE : TEAM_ALLIANCE;
-    
-    if (g_DebugMode)
+    event.participants.clear();
+    event.realParticipants = 0;
+    event.allianceParticipants = 0;
+    event.hordeParticipants = 0;
+
+    const CityData& city = GetSiegeCity(event);
+    Map* map = sMapMgr->FindMap(city.mapId, 0);
+    if (!map)
     {
-        LOG_INFO("server.loading", "[City Siege] Recruiting attackers for {} - Need faction: {} ({})", 
-                 city.name, attackingFaction == TEAM_HORDE ? "HORDE" : "ALLIANCE", static_cast<int>(attackingFaction));
+        return;
     }
-    
-    // Get all playerbots from RandomPlayerbotMgr
-    auto allBots = sRandomPlayerbotMgr->GetAllBots();
-    std::vector<Player*> eligibleBots;
-    
-    uint32 totalBots = 0, wrongFaction = 0, tooLowLevel = 0, notAlive = 0, inCombat = 0, inInstance = 0;
-    
-    for (auto& pair : allBots)
+
+    float radiusSq = float(g_AnnounceRadius) * float(g_AnnounceRadius);
+    Map::PlayerList const& players = map->GetPlayers();
+    for (auto itr = players.begin(); itr != players.end(); ++itr)
     {
-        Player* bot = pair.second;
-        totalBots++;
-        
-        if (!bot || !bot->IsInWorld())
-            continue;
-            
-        // Check if bot is correct faction
-        if (bot->GetTeamId() != attackingFaction)
-        {
-            wrongFaction++;
-            continue;
-        }
-            
-        // Check level requirement
-        if (bot->GetLevel() < g_PlayerbotsMinLevel)
-        {
-            tooLowLevel++;
-            continue;
-        }
-            
-        // Check if alive
-        if (!bot->IsAlive())
-        {
-            notAlive++;
-            continue;
-        }
-            
-        // Check if not in combat
-        if (bot->IsInCombat())
+        if (Player* player = itr->GetSource())
         {
-            inCombat++;
-            continue;
+            if (player->GetExactDistSq(city.centerX, city.centerY, city.centerZ) <= radiusSq)
+            {
+                event.participants.push_back(player->GetGUID());
+                if (player->GetTeamId() == TEAM_ALLIANCE)
+                    event.allianceParticipants++;
+                else
+                    event.hordeParticipants++;
+
+#ifdef MOD_PLAYERBOTS
+                PlayerbotAI* botAI = sPlayerbotsMgr->GetPlayerbotAI(player);
+                if (botAI && !botAI->IsRealPlayer())
+                {
+                    continue;
+                }
+#endif
+                event.realParticipants++;
+            }
         }
-            
-        // Check if not in instance/battleground
-        if (bot->GetMap()->IsDungeon() || bot->GetMap()->IsBattleground())
-        {
-            inInstance++;
+    }
+}
+
+/**
+ * @brief Records the telemetry counters of a siege in its ring buffer, and writes them to the
+ * server log and the worldserver metrics if configured.
+ * @param event The siege event.
+ * @param currentTime Current server time in seconds.
+ */
+void SampleSiegeTelemetry(SiegeEvent& event, uint32 currentTime)
+{
+    event.nextTelemetryTime = currentTime + g_TelemetryInterval;
+
+    SiegeTelemetrySample& sample = event.telemetry[event.telemetrySamples % SIEGE_TELEMETRY_SAMPLES];
+    event.telemetrySamples++;
+
+    sample.elapsed = currentTime > event.startTime ? currentTime - event.startTime : 0;
+    sample.attackerDeaths = event.attackerDeaths.Get();
+    sample.defenderDeaths = event.defenderDeaths.Get();
+    sample.botDeaths = event.botDeaths.Get();
+    sample.playerKills = event.playerKills.Get();
+    sample.respawns = event.respawns.Get();
+    sample.leaderDamage = event.leaderDamage.Get();
+    sample.allianceParticipants = event.allianceParticipants;
+    sample.hordeParticipants = event.hordeParticipants;
+
+    // How far the attack has come along the waypoint path
+    uint32 marching = 0;
+    uint32 waypointTotal = 0;
+    sample.waypointFront = 0;
+    for (const SiegeEvent::UnitSlot& slot : event.creatureSlots)
+    {
+        if (slot.awaitingRespawn)
             continue;
-        }
-            
-        // Skip bots that are in a party or raid (avoid recruiting alts)
-        if (Group* group = bot->GetGroup())
+
+        marching++;
+        waypointTotal += slot.progress.waypoint;
+        sample.waypointFront = std::max(sample.waypointFront, slot.progress.waypoint);
+    }
+    sample.waypointAverage = marching ? float(waypointTotal) / marching : 0.0f;
+
+    const CityData& city = GetSiegeCity(event);
+    if (g_TelemetryLog)
+    {
+        LOG_INFO("server.loading", "[City Siege] telemetry city={} t={} attacker_deaths={} defender_deaths={} bot_deaths={} "
+            "player_kills={} respawns={} leader_damage={} alliance={} horde={} waypoint_avg={:.1f} waypoint_front={}",
+            city.name, sample.elapsed, sample.attackerDeaths, sample.defenderDeaths, sample.botDeaths, sample.playerKills,
+            sample.respawns, sample.leaderDamage, sample.allianceParticipants, sample.hordeParticipants,
+            sample.waypointAverage, sample.waypointFront);
+    }
+
+    if (g_TelemetryMetrics)
+    {
+        METRIC_VALUE("city_siege_attacker_deaths", sample.attackerDeaths, METRIC_TAG("city", city.name));
+        METRIC_VALUE("city_siege_defender_deaths", sample.defenderDeaths, METRIC_TAG("city", city.name));
+        METRIC_VALUE("city_siege_bot_deaths", sample.botDeaths, METRIC_TAG("city", city.name));
+        METRIC_VALUE("city_siege_player_kills", sample.playerKills, METRIC_TAG("city", city.name));
+        METRIC_VALUE("city_siege_respawns", sample.respawns, METRIC_TAG("city", city.name));
+        METRIC_VALUE("city_siege_leader_damage", sample.leaderDamage, METRIC_TAG("city", city.name));
+        METRIC_VALUE("city_siege_participants", sample.allianceParticipants, METRIC_TAG("city", city.name), METRIC_TAG("team", "alliance"));
+        METRIC_VALUE("city_siege_participants", sample.hordeParticipants, METRIC_TAG("city", city.name), METRIC_TAG("team", "horde"));
+        METRIC_VALUE("city_siege_waypoint_avg", sample.waypointAverage, METRIC_TAG("city", city.name));
+        METRIC_VALUE("city_siege_waypoint_front", sample.waypointFront, METRIC_TAG("city", city.name));
+    }
+}
+
+/**
+ * @brief Calls a function for every player of the siege participant list that is still on the city map.
+ * @param event The siege event.
+ * @param func Function taking a Player*.
+ */
+template <class Func>
+void ForEachSiegeParticipant(const SiegeEvent& event, Func&& func)
+{
+    uint32 mapId = GetSiegeCity(event).mapId;
+    for (const ObjectGuid& guid : event.participants)
+    {
+        Player* player = ObjectAccessor::FindPlayer(guid);
+        if (player && player->IsInWorld() && player->GetMapId() == mapId)
         {
-            inInstance++; // reuse counter for grouped
-            continue;
+            func(player);
         }
-            
-        eligibleBots.push_back(bot);
     }
-    
+}
+
+// System message packet reused by SendSiegeMessage, which only runs on the world thread
+static WorldPacket g_SiegeChatPacket;
+
+/**
+ * @brief Sends a siege message to the whole world, or to the siege participants if an announce radius is set.
+ * @param event The siege event.
+ * @param message The message to send.
+ */
+void SendSiegeMessage(const SiegeEvent& event, const std::string& message)
+{
+    if (g_AnnounceRadius == 0)
+    {
+        // Announce to the entire world
+        sWorldSessionMgr->SendServerMessage(SERVER_MSG_STRING, message);
+        return;
+    }
+
+    // Announce to players in range, one packet built for all of them
+    ChatHandler::BuildChatPacket(g_SiegeChatPacket, CHAT_MSG_SYSTEM, LANG_UNIVERSAL, ObjectGuid::Empty, ObjectGuid::Empty, message);
+    ForEachSiegeParticipant(event, [](Player* player)
+    {
+        player->SendDirectMessage(&g_SiegeChatPacket);
+    });
+}
+
+/**
+ * @brief Plays a music track to the siege participants.
+ * @param event The siege event.
+ * @param musicId Sound ID of the music.
+ */
+void PlaySiegeMusic(const SiegeEvent& event, uint32 musicId)
+{
+    ForEachSiegeParticipant(event, [musicId](Player* player)
+    {
+        player->SendDirectMessage(WorldPackets::Misc::PlayMusic(musicId).Write());
+    });
+}
+
+/**
+ * @brief Announces a siege event to players.
+ * @param event The siege event being announced.
+ * @param isStart True if siege is starting, false if ending.
+ */
+void AnnounceSiege(const SiegeEvent& event, bool isStart)
+{
+    const CityData& city = GetSiegeCity(event);
+
+    // Messages are resolved once when the siege starts
+    const std::string& message = isStart ? event.startMessage : event.endMessage;
+
+    SendSiegeMessage(event, message);
+
     if (g_DebugMode)
     {
-        LOG_INFO("server.loading", "[City Siege] Attacker recruitment stats - Total bots: {}, Wrong faction: {}, Too low level: {}, Dead: {}, In combat: {}, In instance: {}, Eligible: {}", 
-                 totalBots, wrongFaction, tooLowLevel, notAlive, inCombat, inInstance, eligibleBots.size());
+        LOG_INFO("server.loading", "[City Siege] {}", message);
     }
-    
-    // Shuffle and take up to max attackers
-    if (eligibleBots.size() > g_PlayerbotsMaxAttackers)
+}
+
+// Military formation - organized ranks like a real army assault.
+// Leaders at center, mini-bosses forming command circle, elites in mid-rank, minions in outer perimeter.
+// Defenders form up around the city leader and march towards the attackers (reverse waypoint order).
+struct SiegeFormationRank
+{
+    SiegeUnitRole role;
+    float radius;      // Ring radius around the rank's anchor point
+    float probeHeight; // Height above the anchor Z from which the ground is searched
+};
+
+static const SiegeFormationRank g_FormationRanks[] =
+{
+    { SIEGE_ROLE_LEADER,   3.0f,  50.0f }, // Command post, tight formation at the center
+    { SIEGE_ROLE_MINIBOSS, 10.5f, 50.0f }, // Command circle around the leaders
+    { SIEGE_ROLE_ELITE,    21.0f, 50.0f }, // Mid-rank officers
+    { SIEGE_ROLE_MINION,   35.0f, 50.0f }, // Front line / outer perimeter
+    { SIEGE_ROLE_DEFENDER, 10.0f, 0.0f  }  // City defenders around the leader position
+};
+
+/**
+ * @brief Gets a point of the siege path: 0 is the attacker spawn point, 1..N the waypoints, N+1 the city leader.
+ * Attackers with waypoint progress P head for point P+1, defenders with progress P for point P.
+ * @param city The city the path belongs to.
+ * @param index Index of the path point.
+ * @return The path point.
+ */
+Waypoint GetSiegePathPoint(const CityData& city, uint32 index)
+{
+    if (index == 0)
     {
-        std::random_device rd;
-        std::mt19937 g(rd());
-        std::shuffle(eligibleBots.begin(), eligibleBots.end(), g);
-        eligibleBots.resize(g_PlayerbotsMaxAttackers);
+        return { city.spawnX, city.spawnY, city.spawnZ };
     }
-    
-    // Store original positions and teleport bots to spawn point (randomized within radius)
-    for (Player* bot : eligibleBots)
+
+    if (index <= city.waypoints.size())
     {
-        // Store original position and PvP status for return later
-        SiegeEvent::BotReturnPosition returnPos;
-        returnPos.botGuid = bot->GetGUID();
-        returnPos.mapId = bot->GetMapId();
-        returnPos.x = bot->GetPositionX();
-        returnPos.y = bot->GetPositionY();
-        returnPos.z = bot->GetPositionZ();
-        returnPos.o = bot->GetOrientation();
-        returnPos.wasPvPFlagged = bot->IsPvP(); // Store original PvP status
-        
-        // Check for and store RPG strategy
-        PlayerbotAI* botAI = sPlayerbotsMgr->GetPlayerbotAI(bot);
-        if (botAI)
-        {
-            // Check for "rpg" or "new rpg" strategy
-            if (botAI->HasStrategy("new rpg", BOT_STATE_NON_COMBAT))
-            {
-                returnPos.rpgStrategy = "new rpg";
-                botAI->ChangeStrategy("-new rpg", BOT_STATE_NON_COMBAT); // Remove RPG strategy during siege
-                if (g_DebugMode)
-                {
-                    LOG_INFO("server.loading", "[City Siege] Removed 'new rpg' strategy from attacker bot {}", bot->GetName());
-                }
-            }
-            else if (botAI->HasStrategy("rpg", BOT_STATE_NON_COMBAT))
-            {
-                returnPos.rpgStrategy = "rpg";
-                botAI->ChangeStrategy("-rpg", BOT_STATE_NON_COMBAT); // Remove RPG strategy during siege
-                if (g_DebugMode)
-                {
-                    LOG_INFO("server.loading", "[City Siege] Removed 'rpg' strategy from attacker bot {}", bot->GetName());
-                }
-            }
-            else
-            {
-                returnPos.rpgStrategy = ""; // No RPG strategy active
-            }
-        }
-        
-        event.botReturnPositions.push_back(returnPos);
-        
-        // Randomize position within ~10 yards of the spawn point
-        float angle = frand(0.0f, 2.0f * M_PI);
-        float distance = frand(0.0f, 10.0f);
-        float spawnX = city.spawnX + distance * std::cos(angle);
-        float spawnY = city.spawnY + distance * std::sin(angle);
-        float spawnZ = city.spawnZ; // Keep same Z as spawn (will be adjusted by server)
-        
-        // Teleport to randomized spawn point
-        bot->TeleportTo(city.mapId, spawnX, spawnY, spawnZ, 0.0f);
-        recruitedBots.push_back(bot->GetGUID());
-        
-        if (g_DebugMode)
-        {
-            LOG_INFO("server.loading", "[City Siege] Recruited attacker bot {} (Level {}) for siege on {} at [{:.2f}, {:.2f}, {:.2f}] (will return to map {} at [{:.2f}, {:.2f}, {:.2f}])", 
-                     bot->GetName(), bot->GetLevel(), city.name, spawnX, spawnY, spawnZ, returnPos.mapId, returnPos.x, returnPos.y, returnPos.z);
-        }
+        return city.waypoints[index - 1];
     }
-    
-    if (g_DebugMode && !recruitedBots.empty())
+
+    return { city.leaderX, city.leaderY, city.leaderZ };
+}
+
+static const uint32 SIEGE_DEFENDER_RESPAWN_POINTS = 16; // Points of the defender respawn ring around the leader
+
+/**
+ * @brief Gets the number of formation slots a city height cache holds for the current ranks.
+ * @return Slots of every rank, for the largest army the adaptive scaling can ask for.
+ */
+uint32 GetSiegeFormationSize()
+{
+    uint32 size = 0;
+    for (const SiegeFormationRank& rank : g_FormationRanks)
     {
-        LOG_INFO("server.loading", "[City Siege] Total {} attacker bots recruited for siege on {}", 
-                 recruitedBots.size(), city.name);
+        size += GetSiegeRoleScaledCount(rank.role, g_AdaptiveEnabled ? g_AdaptiveMaxScale : 1.0f);
     }
-#endif
-    
-    return recruitedBots;
+    return size;
 }
 
 /**
- * @brief Activates siege combat mode for playerbots
- * @param event The siege event
- * Puts bots into combat mode and gives them initial movement orders
+ * @brief Gets the height cache of a city, probing the terrain on first use.
+ * @param city The city to get the cache for.
+ * @param map The city map, used to fill the cache.
+ * @return The height cache of the city.
  */
-void ActivatePlayerbotsForSiege(SiegeEvent& event)
+CityHeightCache& GetCityHeightCache(const CityData& city, Map* map)
 {
-#ifdef MOD_PLAYERBOTS
-    if (!g_PlayerbotsEnabled)
+    CityHeightCache& cache = *city.heights;
+    if (cache.built)
     {
-        return;
+        return cache;
     }
-    
-    CityData const* city = nullptr;
-    for (auto& c : g_Cities)
+
+    // Formation slots of every rank, for the largest army the adaptive scaling can ask for
+    for (const SiegeFormationRank& rank : g_FormationRanks)
     {
-        if (c.id == event.cityId)
+        uint32 count = GetSiegeRoleScaledCount(rank.role, g_AdaptiveEnabled ? g_AdaptiveMaxScale : 1.0f);
+        if (!count)
         {
-            city = &c;
-            break;
+            continue;
+        }
+
+        bool isDefender = (rank.role == SIEGE_ROLE_DEFENDER);
+        float anchorX = isDefender ? city.leaderX : city.spawnX;
+        float anchorY = isDefender ? city.leaderY : city.spawnY;
+        float anchorZ = isDefender ? city.leaderZ : city.spawnZ;
+        float angleStep = (2 * M_PI) / count;
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            float angle = angleStep * i;
+            SiegeEvent::PendingSpawn slot;
+            slot.entry = 0;
+            slot.role = rank.role;
+            slot.x = anchorX + rank.radius * cos(angle);
+            slot.y = anchorY + rank.radius * sin(angle);
+            slot.z = anchorZ;
+
+            float groundZ = map->GetHeight(slot.x, slot.y, anchorZ + rank.probeHeight, true, 50.0f);
+            if (groundZ > INVALID_HEIGHT)
+                slot.z = groundZ + 0.5f;
+
+            cache.formation.push_back(slot);
         }
     }
-    
-    if (!city)
-        return;
-    
-    // Activate defender bots - move them toward spawn to intercept attackers
-    if (!city->waypoints.empty())
+
+    // Attacker respawn point
+    cache.spawnGroundZ = city.spawnZ;
+    float spawnGroundZ = map->GetHeight(city.spawnX, city.spawnY, city.spawnZ, true, 50.0f);
+    if (spawnGroundZ > INVALID_HEIGHT)
+        cache.spawnGroundZ = spawnGroundZ + 0.5f;
+
+    // Defender respawn ring, 10-15 yards around the leader
+    for (uint32 i = 0; i < SIEGE_DEFENDER_RESPAWN_POINTS; ++i)
     {
-        // Defenders start at leader and move backward along waypoints toward spawn
-        size_t defenderWaypoint = city->waypoints.size() - 1; // Start at last waypoint (near leader)
-        
-        for (const auto& botGuid : event.defenderBots)
+        float angle = (2 * M_PI) / SIEGE_DEFENDER_RESPAWN_POINTS * i;
+        float dist = frand(10.0f, 15.0f);
+        Waypoint point;
+        point.x = city.leaderX + dist * cos(angle);
+        point.y = city.leaderY + dist * sin(angle);
+        point.z = city.leaderZ;
+
+        float groundZ = map->GetHeight(point.x, point.y, point.z, true, 50.0f);
+        if (groundZ > INVALID_HEIGHT)
+            point.z = groundZ + 0.5f;
+
+        cache.defenderRespawnPoints.push_back(point);
+    }
+
+    // Jitter grid around every path point (2 yard spacing within 5 yards). Samples without ground
+    // or on another floor level than the path point are dropped, so units never spread onto ledges.
+    uint32 pathPointCount = city.waypoints.size() + 2;
+    cache.pathJitter.resize(pathPointCount);
+    for (uint32 index = 0; index < pathPointCount; ++index)
+    {
+        Waypoint center = GetSiegePathPoint(city, index);
+        for (float offsetX = -4.0f; offsetX <= 4.0f; offsetX += 2.0f)
         {
-            Player* bot = ObjectAccessor::FindPlayer(botGuid);
-            if (!bot || !bot->IsInWorld())
-                continue;
-                
-            PlayerbotAI* botAI = sPlayerbotsMgr->GetPlayerbotAI(bot);
-            if (!botAI)
-                continue;
-            
-            // Enable PvP mode for siege combat
-            bot->SetPvP(true);
-            
-            // Remove away status to ensure bot is active
-            bot->RemovePlayerFlag(PLAYER_FLAGS_AFK);
-            
-            // Enable PvP strategy so bots attack enemy players while traveling
-            if (!botAI->HasStrategy("pvp", BOT_STATE_NON_COMBAT))
-            {
-                botAI->ChangeStrategy("+pvp", BOT_STATE_NON_COMBAT);
-            }
-            
-            // Initialize waypoint tracking for defenders
-            event.creatureWaypointProgress[botGuid] = defenderWaypoint;
-            
-            // Move bot toward a waypoint closer to spawn (backward movement) using playerbots travel system
-            if (defenderWaypoint > 0)
+            for (float offsetY = -4.0f; offsetY <= 4.0f; offsetY += 2.0f)
             {
-                const Waypoint& targetWP = city->waypoints[defenderWaypoint - 1];
-                
-                // Set travel destination using playerbots travel manager
-                TravelTarget* travelTarget = botAI->GetAiObjectContext()->GetValue<TravelTarget*>("travel target")->Get();
-                if (travelTarget)
-                {
-                    // Create destination position
-                    WorldPosition* destPos = new WorldPosition(city->mapId, targetWP.x, targetWP.y, targetWP.z, 0.0f);
-                    
-                    // Create a simple travel destination with 5 yard radius
-                    TravelDestination* siegeDest = new TravelDestination(0.0f, 5.0f);
-                    siegeDest->addPoint(destPos);
-                    
-                    // Set target with both destination and position
-                    travelTarget->setTarget(siegeDest, destPos);
-                    travelTarget->setForced(true);
-                }
-                
-                // Enable travel strategy for proper pathfinding
-                if (!botAI->HasStrategy("travel", BOT_STATE_NON_COMBAT))
-                {
-                    botAI->ChangeStrategy("+travel", BOT_STATE_NON_COMBAT);
-                }
-                
-                // if (g_DebugMode)
-                // {
-                //     LOG_INFO("server.loading", "[City Siege] Defender bot {} flagged for PvP and traveling to waypoint {} [{:.2f}, {:.2f}, {:.2f}]",
-                //              bot->GetName(), defenderWaypoint - 1, targetWP.x, targetWP.y, targetWP.z);
-                // }
+                if (offsetX * offsetX + offsetY * offsetY > 25.0f)
+                    continue;
+
+                Waypoint sample = { center.x + offsetX, center.y + offsetY, center.z };
+                float groundZ = map->GetHeight(sample.x, sample.y, center.z + 5.0f, true, 50.0f);
+                if (groundZ <= INVALID_HEIGHT || std::abs(groundZ - center.z) > 5.0f)
+                    continue;
+
+                sample.z = groundZ;
+                cache.pathJitter[index].push_back(sample);
             }
         }
     }
-    
-    // Activate attacker bots - move them toward leader along waypoints
-    if (!city->waypoints.empty())
-    {
-        // Attackers start at spawn and move forward along waypoints toward leader
-        for (const auto& botGuid : event.attackerBots)
-        {
-            Player* bot = ObjectAccessor::FindPlayer(botGuid);
-            if (!bot || !bot->IsInWorld())
-                continue;
-                
-            PlayerbotAI* botAI = sPlayerbotsMgr->GetPlayerbotAI(bot);
-            if (!botAI)
-                continue;
-            
-            // Enable PvP mode for siege combat
-            bot->SetPvP(true);
-            
-            // Remove away status to ensure bot is active
-            bot->RemovePlayerFlag(PLAYER_FLAGS_AFK);
-            
-            // Enable PvP strategy so bots attack enemy players while traveling
-            if (!botAI->HasStrategy("pvp", BOT_STATE_NON_COMBAT))
-            {
-                botAI->ChangeStrategy("+pvp", BOT_STATE_NON_COMBAT);
-            }
-            
-            // Initialize waypoint tracking for attackers (start at first waypoint)
-            event.creatureWaypointProgress[botGuid] = 0;
-            
-            // Move bot toward first waypoint using playerbots travel system
-            const Waypoint& targetWP = city->waypoints[0];
-            
-            // Set travel destination using playerbots travel manager
-            TravelTarget* travelTarget = botAI->GetAiObjectContext()->GetValue<TravelTarget*>("travel target")->Get();
-            if (travelTarget)
-            {
-                WorldPosition* destPos = new WorldPosition(city->mapId, targetWP.x, targetWP.y, targetWP.z, 0.0f);
-                
-                TravelDestination* siegeDest = new TravelDestination(0.0f, 5.0f);
-                siegeDest->addPoint(destPos);
-                
-                travelTarget->setTarget(siegeDest, destPos);
-                travelTarget->setForced(true);
-            }
-            
-            // Enable travel strategy for proper pathfinding
-            if (!botAI->HasStrategy("travel", BOT_STATE_NON_COMBAT))
-            {
-                botAI->ChangeStrategy("+travel", BOT_STATE_NON_COMBAT);
-            }
-            
-            // if (g_DebugMode)
-            // {
-            //     LOG_INFO("server.loading", "[City Siege] Attacker bot {} flagged for PvP and traveling to waypoint 0 [{:.2f}, {:.2f}, {:.2f}]",
-            //              bot->GetName(), targetWP.x, targetWP.y, targetWP.z);
-            // }
-        }
-    }
-    
+
+    cache.built = true;
+
     if (g_DebugMode)
     {
-        LOG_INFO("server.loading", "[City Siege] Activated {} defender and {} attacker bots for siege on {}",
-                 event.defenderBots.size(), event.attackerBots.size(), city->name);
+        LOG_INFO("server.loading", "[City Siege] Built height cache for {}: {} formation slots, {} path points",
+                 city.name, cache.formation.size(), pathPointCount);
     }
-#endif
+
+    return cache;
 }
 
 /**
- * @brief Deactivates siege combat mode for playerbots and releases them
- * @param event The siege event
- * Stops combat, teleports bots back to original locations, and releases all participating bots
+ * @brief Picks a random cached spot around a path point so units do not bunch up.
+ * @param cache Height cache of the city.
+ * @param index Index of the path point (see GetSiegePathPoint).
+ * @param x X coordinate of the path point, replaced by the jittered one.
+ * @param y Y coordinate of the path point, replaced by the jittered one.
  */
-void DeactivatePlayerbotsFromSiege(SiegeEvent& event)
+void JitterPathPoint(const CityHeightCache& cache, uint32 index, float& x, float& y)
 {
-#ifdef MOD_PLAYERBOTS
-    if (!g_PlayerbotsEnabled)
+    if (index >= cache.pathJitter.size() || cache.pathJitter[index].empty())
     {
         return;
     }
-    
-    // Teleport all bots back to their original positions
-    for (const auto& returnPos : event.botReturnPositions)
+
+    const std::vector<Waypoint>& samples = cache.pathJitter[index];
+    const Waypoint& sample = samples[urand(0, samples.size() - 1)];
+    x = sample.x;
+    y = sample.y;
+}
+
+/**
+ * @brief Gets the ground height below a moving unit, memoized per 1x1 yard cell and 4 yard floor band.
+ * The result is only precise enough to decide whether a unit is off the ground.
+ * @param cache Height cache of the city.
+ * @param map The city map.
+ * @param x X coordinate.
+ * @param y Y coordinate.
+ * @param z Z coordinate.
+ * @return Ground height, INVALID_HEIGHT if there is none.
+ */
+float GetCachedGroundHeight(CityHeightCache& cache, Map* map, float x, float y, float z)
+{
+    uint64 key = (uint64(uint16(int16(std::floor(x)))) << 32) |
+                 (uint64(uint16(int16(std::floor(y)))) << 16) |
+                 uint64(uint16(int16(std::floor(z / 4.0f))));
+
+    auto itr = cache.groundCells.find(key);
+    if (itr != cache.groundCells.end())
     {
-        Player* bot = ObjectAccessor::FindPlayer(returnPos.botGuid);
-        if (!bot || !bot->IsInWorld())
-            continue;
-            
-        // Safety checks before teleporting
-        if (!bot->IsAlive())
-        {
-            if (g_DebugMode)
-            {
-                LOG_INFO("server.loading", "[City Siege] Skipping return for dead bot {}", bot->GetName());
-            }
-            continue;
-        }
-        
-        // Don't teleport if bot is in a dungeon, raid, arena, or battleground
-        if (bot->GetMap()->IsDungeon() || bot->GetMap()->IsRaid() || 
-            bot->GetMap()->IsBattleground() || bot->GetMap()->IsBattleArena())
-        {
-            if (g_DebugMode)
-            {
-                LOG_INFO("server.loading", "[City Siege] Skipping return for bot {} - currently in instance/raid/arena/bg", 
-                         bot->GetName());
-            }
-            continue;
-        }
-        
-        // Don't teleport if bot is being teleported or loading
-        if (bot->IsBeingTeleported())
-        {
-            if (g_DebugMode)
-            {
-                LOG_INFO("server.loading", "[City Siege] Skipping return for bot {} - already being teleported", 
-                         bot->GetName());
-            }
-            continue;
-        }
-        
-        // Stop combat first
-        bot->CombatStop(true);
-        
-        // Restore original PvP flag status
-        bot->SetPvP(returnPos.wasPvPFlagged);
-        
-        // Restore RPG strategy if bot had one
-        if (!returnPos.rpgStrategy.empty())
-        {
-            PlayerbotAI* botAI = sPlayerbotsMgr->GetPlayerbotAI(bot);
-            if (botAI)
-            {
-                botAI->ChangeStrategy("+" + returnPos.rpgStrategy, BOT_STATE_NON_COMBAT);
-                if (g_DebugMode)
-                {
-                    LOG_INFO("server.loading", "[City Siege] Restored '{}' strategy to bot {}", 
-                             returnPos.rpgStrategy, bot->GetName());
-                }
-            }
-        }
-        
-        // Teleport back to original position
-        bot->TeleportTo(returnPos.mapId, returnPos.x, returnPos.y, returnPos.z, returnPos.o);
-        
-        if (g_DebugMode)
-        {
-            LOG_INFO("server.loading", "[City Siege] Returned bot {} to original location (map {} at [{:.2f}, {:.2f}, {:.2f}]) and restored PvP flag to {}", 
-                     bot->GetName(), returnPos.mapId, returnPos.x, returnPos.y, returnPos.z, returnPos.wasPvPFlagged ? "ON" : "OFF");
-        }
+        return itr->second;
     }
-    
-    // Clear all bot tracking data
-    event.defenderBots.clear();
-    event.attackerBots.clear();
-    event.botReturnPositions.clear();
-    
-    if (g_DebugMode)
+
+    // Keep memory bounded on long sieges
+    if (cache.groundCells.size() >= 16384)
     {
-        LOG_INFO("server.loading", "[City Siege] Deactivated all playerbots from siege and returned them to original locations");
+        cache.groundCells.clear();
     }
-#endif
+
+    float groundZ = map->GetHeight(x, y, z + 5.0f, true, 50.0f);
+    cache.groundCells[key] = groundZ;
+    return groundZ;
 }
 
 /**
- * @brief Starts a new siege event.
- * @param targetCityId Optional specific city to siege. If -1, selects random city.
+ * @brief Applies the settings every siege unit gets right after being summoned.
+ * @param creature The summoned creature.
+ * @param role Role of the creature in the siege.
+ * @param x Spawn X coordinate.
+ * @param y Spawn Y coordinate.
+ * @param z Spawn Z coordinate.
  */
-void StartSiegeEvent(int targetCityId = -1)
+void PrepareSiegeUnit(Creature* creature, SiegeUnitRole role, float x, float y, float z)
 {
-    if (!g_CitySiegeEnabled)
+    const SiegeRoleSettings& settings = g_RoleSettings[role];
+    creature->SetLevel(settings.level);
+
+    // Elites, minions and defenders keep their default scale
+    if (g_SiegeRoleTraits[role].resized)
     {
-        return;
+        creature->SetObjectScale(settings.scale);
     }
 
-    // Check if we can start a new siege
-    if (!g_AllowMultipleCities && !g_ActiveSieges.empty())
+    // Enforce ground movement
+    creature->SetDisableGravity(false);
+    creature->SetCanFly(false);
+    creature->SetHover(false);
+    creature->RemoveUnitMovementFlag(MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER);
+
+    // Prevent return to home position after combat - clear motion master
+    creature->SetWalk(false);
+    creature->GetMotionMaster()->Clear(false);
+    creature->GetMotionMaster()->MoveIdle();
+
+    // Set home position to spawn location to prevent evading back
+    creature->SetHomePosition(x, y, z, 0.0f);
+
+    // Enforce ground position immediately after spawn
+    creature->UpdateGroundPositionZ(x, y, z);
+}
+
+/**
+ * @brief Turns a siege unit hostile: sets its combat faction and react state.
+ * Defenders take the city's faction, attackers the faction of its enemy.
+ * @param event The siege event the unit belongs to.
+ * @param creature The siege creature.
+ * @param role Role of the creature in the siege.
+ */
+void ActivateSiegeUnit(const SiegeEvent& event, Creature* creature, SiegeUnitRole role)
+{
+    creature->SetFaction(g_SiegeFactions[GetSiegeUnitTeam(GetSiegeCity(event), role)].combatFaction);
+    creature->SetReactState(g_RoleSettings[role].reactState);
+}
+
+/**
+ * @brief Summons a siege unit and applies its role settings. The spawn and respawn code share it.
+ * @param event The siege event the unit belongs to.
+ * @param map The city map.
+ * @param entry Creature entry.
+ * @param role Role of the creature in the siege.
+ * @param x Spawn X coordinate.
+ * @param y Spawn Y coordinate.
+ * @param z Spawn Z coordinate.
+ * @param active True to make it hostile right away, false to keep it passive until the battle begins.
+ * @return The creature, or nullptr if it could not be summoned.
+ */
+Creature* SummonSiegeUnit(const SiegeEvent& event, Map* map, uint32 entry, SiegeUnitRole role, float x, float y, float z, bool active)
+{
+    Creature* creature = map->SummonCreature(entry, Position(x, y, z, 0));
+    if (!creature)
     {
-        // Check if any siege is still active
-        for (const auto& siege : g_ActiveSieges)
-        {
-            if (siege.isActive)
-            {
-                return; // Cannot start new siege
-            }
-        }
+        return nullptr;
     }
 
-    CityData* city = nullptr;
-    
-    // If specific city requested, use it
-    if (targetCityId >= 0 && targetCityId < CITY_MAX)
+    PrepareSiegeUnit(creature, role, x, y, z);
+
+    if (active)
     {
-        city = &g_Cities[targetCityId];
-        
-        // Check if city is enabled
-        if (!g_CityEnabled[city->name])
-        {
-            if (g_DebugMode)
-            {
-                LOG_INFO("server.loading", "[City Siege] Cannot start siege - {} is disabled", city->name);
-            }
-            return;
-        }
+        ActivateSiegeUnit(event, creature, role);
     }
     else
     {
-        // Select random city
-        city = SelectRandomCity();
+        creature->SetReactState(REACT_PASSIVE);
+        creature->SetFaction(SIEGE_FACTION_PASSIVE);
     }
-    
-    if (!city)
+
+    return creature;
+}
+
+/**
+ * @brief Splits the pending formation into attacker waves, each a cross-section of the army.
+ * The leaders and the defenders all come with the first wave.
+ * @param event The siege event, with the formation in pendingSpawns.
+ */
+void OrderSiegeWaves(SiegeEvent& event)
+{
+    event.waveEnds.clear();
+    event.wavesSent = 1;
+    event.waveFirstSlot = 0;
+    event.waveStreaming = false;
+
+    if (!g_WavesEnabled)
     {
-        if (g_DebugMode)
-        {
-            LOG_INFO("server.loading", "[City Siege] No available cities for siege event");
-        }
+        event.waveEnds.push_back(event.pendingSpawns.size());
+        event.waveSpawnEnd = event.pendingSpawns.size();
         return;
     }
 
-    uint32 currentTime = time(nullptr);
-    SiegeEvent newEvent;
-    newEvent.cityId = city->id;
-    newEvent.startTime = currentTime;
-    newEvent.endTime = currentTime + g_EventDuration;
-    newEvent.isActive = true;
-    newEvent.cinematicPhase = true;
-    newEvent.lastYellTime = currentTime;
-    newEvent.lastStatusAnnouncement = currentTime;
-    newEvent.cinematicStartTime = currentTime;
-    newEvent.countdown75Announced = false;
-    newEvent.countdown50Announced = false;
-    newEvent.countdown25Announced = false;
-    newEvent.rpScriptIndex = 0; // Start RP script at first line
-    newEvent.weatherOverridden = false; // Initialize weather override flag
-    
-    // First, find and store the city leader's GUID and name
-    Map* map = sMapMgr->FindMap(city->mapId, 0);
-    if (map)
+    auto inWaves = [](SiegeUnitRole role) { return role != SIEGE_ROLE_LEADER && role != SIEGE_ROLE_DEFENDER; };
+
+    uint32 roleCount[SIEGE_ROLE_MAX] = { };
+    uint32 waveUnits = 0;
+    for (const SiegeEvent::PendingSpawn& spawn : event.pendingSpawns)
     {
-        std::list<Creature*> leaderList;
-        CitySiege::CreatureEntryCheck check(city->targetLeaderEntry);
-        CitySiege::SimpleCreatureListSearcher<CitySiege::CreatureEntryCheck> searcher(leaderList, check);
-        Cell::VisitObjects(city->leaderX, city->leaderY, map, searcher, 100.0f);
-        
-        for (Creature* leader : leaderList)
+        roleCount[spawn.role]++;
+        if (inWaves(spawn.role))
         {
-            if (leader && leader->IsAlive())
-            {
-                newEvent.cityLeaderGuid = leader->GetGUID();
-                newEvent.cityLeaderName = leader->GetName();
-                
-                if (g_DebugMode)
-                {
-                    LOG_INFO("server.loading", "[City Siege] Found city leader: {} (Entry: {}, GUID: {})",
-                             leader->GetName(), city->targetLeaderEntry, leader->GetGUID().ToString());
-                }
-                break;
-            }
+            waveUnits++;
         }
-        
-        if (!newEvent.cityLeaderGuid)
+    }
+    uint32 waveCount = std::max<uint32>(1, (waveUnits + g_WavesSize - 1) / g_WavesSize);
+
+    // Every rank is spread evenly over the waves, the formation order is kept within a wave
+    uint32 roleIndex[SIEGE_ROLE_MAX] = { };
+    std::vector<std::pair<uint32, SiegeEvent::PendingSpawn>> ordered;
+    ordered.reserve(event.pendingSpawns.size());
+    for (const SiegeEvent::PendingSpawn& spawn : event.pendingSpawns)
+    {
+        uint32 wave = inWaves(spawn.role) ? roleIndex[spawn.role]++ * waveCount / roleCount[spawn.role] : 0;
+        ordered.emplace_back(wave, spawn);
+    }
+    std::stable_sort(ordered.begin(), ordered.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    event.pendingSpawns.clear();
+    for (const auto& entry : ordered)
+    {
+        while (event.waveEnds.size() < entry.first)
         {
-            LOG_ERROR("server.loading", "[City Siege] WARNING: Could not find city leader for {} (Entry: {}). Defenders will auto-win!",
-                     city->name, city->targetLeaderEntry);
+            event.waveEnds.push_back(event.pendingSpawns.size());
         }
+        event.pendingSpawns.push_back(entry.second);
     }
-    
-    // Now choose and process RP script with leader name replacement
-    bool isAllianceCity = (city->id <= CITY_EXODAR);
-    std::string rpScriptsConfig = isAllianceCity ? g_RPScriptsHorde : g_RPScriptsAlliance;
-    
-    // Parse available scripts (pipe-separated)
-    std::vector<std::string> availableScripts;
-    std::string scriptsStr = rpScriptsConfig;
-    size_t pipePos = 0;
-    while ((pipePos = scriptsStr.find('|')) != std::string::npos)
+    event.waveEnds.push_back(event.pendingSpawns.size());
+    event.waveSpawnEnd = event.waveEnds.front();
+}
+
+/**
+ * @brief Fills the siege army from the cached formation slots, ready to be summoned in batches.
+ * @param event The siege event to build the formation for.
+ * @param map The city map, used to fill the height cache on first use.
+ * @param leaderEntry Entry of the leader selected for this siege.
+ */
+void BuildSiegeFormation(SiegeEvent& event, Map* map, uint32 leaderEntry)
+{
+    const CityData& city = GetSiegeCity(event);
+
+    // Take an evenly spread share of each rank's cached ring for the scale of this siege
+    const std::vector<SiegeEvent::PendingSpawn>& formation = GetCityHeightCache(city, map).formation;
+    event.pendingSpawns.clear();
+    event.nextPendingSpawn = 0;
+    for (size_t begin = 0; begin < formation.size();)
     {
-        std::string script = scriptsStr.substr(0, pipePos);
-        if (!script.empty())
+        SiegeUnitRole role = formation[begin].role;
+        size_t end = begin;
+        while (end < formation.size() && formation[end].role == role)
+        {
+            ++end;
+        }
+
+        size_t cached = end - begin;
+        size_t wanted = std::min<size_t>(cached, GetSiegeRoleScaledCount(role, event.armyScale));
+        for (size_t i = 0; i < wanted; ++i)
         {
-            availableScripts.push_back(script);
+            event.pendingSpawns.push_back(formation[begin + i * cached / wanted]);
         }
-        scriptsStr.erase(0, pipePos + 1);
+        begin = end;
     }
-    if (!scriptsStr.empty())
+
+    OrderSiegeWaves(event);
+
+    // Attackers of an Alliance city are Horde units (and vice versa), defenders share the city faction
+    for (SiegeEvent::PendingSpawn& spawn : event.pendingSpawns)
     {
-        availableScripts.push_back(scriptsStr);
+        spawn.entry = spawn.role == SIEGE_ROLE_LEADER ? leaderEntry : g_RoleSettings[spawn.role].entry[GetSiegeUnitTeam(city, spawn.role)];
     }
-    
-    // Pick a random script
-    if (!availableScripts.empty())
+}
+
+/**
+ * @brief Summons the next batch of the precomputed siege formation.
+ * @param event The siege event being spawned.
+ * @param maxCount Maximum number of units to summon, 0 summons everything still pending.
+ */
+void ProcessPendingSpawns(SiegeEvent& event, uint32 maxCount)
+{
+    size_t spawnEnd = std::min(event.waveSpawnEnd, event.pendingSpawns.size());
+    if (event.nextPendingSpawn >= spawnEnd)
     {
-        uint32 randomScriptIndex = urand(0, availableScripts.size() - 1);
-        std::string chosenScript = availableScripts[randomScriptIndex];
-        
-        // Parse the chosen script into lines (semicolon-separated)
-        std::string lineStr = chosenScript;
-        size_t semiPos = 0;
-        while ((semiPos = lineStr.find(';')) != std::string::npos)
+        return;
+    }
+
+    SiegePerfScope perf(SIEGE_PERF_SPAWN);
+
+    const CityData& city = GetSiegeCity(event);
+    Map* map = sMapMgr->FindMap(city.mapId, 0);
+    if (!map)
+    {
+        return;
+    }
+
+    uint32 summoned = 0;
+    while (event.nextPendingSpawn < spawnEnd && (!maxCount || summoned < maxCount))
+    {
+        const SiegeEvent::PendingSpawn& spawn = event.pendingSpawns[event.nextPendingSpawn++];
+        ++summoned;
+
+        // Stay passive until the cinematic phase is over, a wave joining the running battle fights right away
+        Creature* creature = SummonSiegeUnit(event, map, spawn.entry, spawn.role, spawn.x, spawn.y, spawn.z, !event.cinematicPhase);
+        if (!creature)
         {
-            std::string line = lineStr.substr(0, semiPos);
-            if (!line.empty())
-            {
-                // Replace {LEADER} placeholder with actual leader name
-                size_t pos = 0;
-                while ((pos = line.find("{LEADER}", pos)) != std::string::npos)
-                {
-                    line.replace(pos, 8, newEvent.cityLeaderName.empty() ? "the leader" : newEvent.cityLeaderName);
-                    pos += newEvent.cityLeaderName.length();
-                }
-                
-                // Replace {CITY} placeholder with actual city name
-                pos = 0;
-                while ((pos = line.find("{CITY}", pos)) != std::string::npos)
-                {
-                    line.replace(pos, 6, city->name);
-                    pos += city->name.length();
-                }
-                
-                newEvent.activeRPScript.push_back(line);
-            }
-            lineStr.erase(0, semiPos + 1);
+            continue;
         }
-        if (!lineStr.empty())
+
+        if (spawn.role == SIEGE_ROLE_DEFENDER)
         {
-            // Replace {LEADER} placeholder in last line
-            size_t pos = 0;
-            while ((pos = lineStr.find("{LEADER}", pos)) != std::string::npos)
-            {
-                lineStr.replace(pos, 8, newEvent.cityLeaderName.empty() ? "the leader" : newEvent.cityLeaderName);
-                pos += newEvent.cityLeaderName.length();
-            }
-            
-            // Replace {CITY} placeholder in last line
-            pos = 0;
-            while ((pos = lineStr.find("{CITY}", pos)) != std::string::npos)
-            {
-                lineStr.replace(pos, 6, city->name);
-                pos += city->name.length();
-            }
-            
-            newEvent.activeRPScript.push_back(lineStr);
+            AddSiegeDefender(event, creature->GetGUID());
         }
-        
-        if (g_DebugMode)
+        else
         {
-            LOG_INFO("server.loading", "[City Siege] Selected RP script {} with {} lines for {} (Leader: {})",
-                     randomScriptIndex + 1, newEvent.activeRPScript.size(), city->name, 
-                     newEvent.cityLeaderName.empty() ? "NOT FOUND" : newEvent.cityLeaderName);
+            AddSiegeAttacker(event, creature->GetGUID(), spawn.role);
         }
-    }
-
-    // Announce siege is coming (before RP phase)
-    std::string preAnnounce = "|cffff0000[City Siege]|r |cffFFFF00WARNING!|r A siege force is preparing to attack " + city->name + "! The battle will begin in " + std::to_string(g_CinematicDelay) + " seconds. Defenders, prepare yourselves!";
-    sWorldSessionMgr->SendServerMessage(SERVER_MSG_STRING, preAnnounce);
-
-    g_ActiveSieges.push_back(newEvent);
-
-    // Set siege weather during RP phase
-    SetSiegeWeather(*city, g_ActiveSieges.back());
 
-#ifdef MOD_PLAYERBOTS
-    // Recruit playerbots if enabled
-    if (g_PlayerbotsEnabled)
-    {
-        g_ActiveSieges.back().defenderBots = RecruitDefendingPlayerbots(*city, g_ActiveSieges.back());
-        g_ActiveSieges.back().attackerBots = RecruitAttackingPlayerbots(*city, g_ActiveSieges.back());
-    }
-#endif
+        // A wave joining the running battle goes straight down the path
+        if (!event.cinematicPhase)
+        {
+            bool isDefender = g_SiegeRoleTraits[spawn.role].defender;
+            StartSiegeUnitMarch(event, creature, (isDefender ? event.spawnedDefenders.size() : event.spawnedCreatures.size()) - 1, isDefender);
+        }
 
-    AnnounceSiege(*city, true);
-    SpawnSiegeCreatures(g_ActiveSieges.back());
+        // Yell a random spawn message (semicolon separated in the configuration)
+        if (spawn.role == SIEGE_ROLE_LEADER && !g_LeaderSpawnYells.empty() && creature->IsAlive())
+        {
+            uint32 randomIndex = urand(0, g_LeaderSpawnYells.size() - 1);
+            creature->Yell(g_LeaderSpawnYells[randomIndex], LANG_UNIVERSAL);
+        }
 
-    // Play RP phase music if enabled
-    if (g_MusicEnabled && g_RPMusicId > 0)
-    {
-        Map* map = sMapMgr->FindMap(city->mapId, 0);
-        if (map)
+        if (g_DebugMode && (spawn.role == SIEGE_ROLE_MINION || spawn.role == SIEGE_ROLE_DEFENDER))
         {
-            // Send music to players within announce radius
-            Map::PlayerList const& players = map->GetPlayers();
-            for (auto itr = players.begin(); itr != players.end(); ++itr)
-            {
-                if (Player* player = itr->GetSource())
-                {
-                    if (player->GetDistance(city->centerX, city->centerY, city->centerZ) <= g_AnnounceRadius)
-                    {
-                        player->SendDirectMessage(WorldPackets::Misc::PlayMusic(g_RPMusicId).Write());
-                    }
-                }
-            }
-            
-            if (g_DebugMode)
-            {
-                LOG_INFO("server.loading", "[City Siege] Playing RP phase music (ID: {}) for siege of {}", g_RPMusicId, city->name);
-            }
+            LOG_INFO("server.loading", "[City Siege] Spawned {} at ({}, {}, {})",
+                     spawn.role == SIEGE_ROLE_DEFENDER ? "defender" : "minion", spawn.x, spawn.y, spawn.z);
         }
     }
 
-    if (g_DebugMode)
+    if (event.nextPendingSpawn >= event.pendingSpawns.size())
     {
-        LOG_INFO("server.loading", "[City Siege] Started siege event at {}", city->name);
+        LOG_INFO("server.loading", "[City Siege] Spawned {} total attacker creatures in military formation and {} defender creatures for siege at {}",
+                 event.spawnedCreatures.size(), event.spawnedDefenders.size(), city.name);
+
+        event.pendingSpawns.clear();
+        event.nextPendingSpawn = 0;
     }
 }
 
 /**
- * @brief Ends an active siege event.
- * @param event The siege event to end.
+ * @brief Spawns siege creatures for a city siege event.
+ * Only the first batch is summoned right away, the rest follows during the cinematic phase.
+ * @param event The siege event to spawn creatures for.
  */
-void EndSiegeEvent(SiegeEvent& event, int winningTeam = -1)
+void SpawnSiegeCreatures(SiegeEvent& event)
 {
-    if (!event.isActive)
+    const CityData& city = GetSiegeCity(event);
+    
+    if (g_DebugMode)
     {
-        return;
+        LOG_INFO("server.loading", "[City Siege] Spawning creatures for siege at {}", city.name);
+        LOG_INFO("server.loading", "[City Siege]   Army scale: {:.2f} ({} real players, world diff {:.1f} ms)",
+                 event.armyScale, event.realParticipants, g_WorldDiffAverage);
+        LOG_INFO("server.loading", "[City Siege]   Minions: {}", GetSiegeRoleScaledCount(SIEGE_ROLE_MINION, event.armyScale));
+        LOG_INFO("server.loading", "[City Siege]   Elites: {}", GetSiegeRoleScaledCount(SIEGE_ROLE_ELITE, event.armyScale));
+        LOG_INFO("server.loading", "[City Siege]   Mini-Bosses: {}", GetSiegeRoleScaledCount(SIEGE_ROLE_MINIBOSS, event.armyScale));
+        LOG_INFO("server.loading", "[City Siege]   Leaders: {}", g_SpawnCountLeaders);
     }
 
-    const CityData& city = g_Cities[event.cityId];
-    event.isActive = false;
-
-    // Check if defenders won (city leader still alive)
-    bool defendersWon = false;
-    bool leaderKilled = false;
     Map* map = sMapMgr->FindMap(city.mapId, 0);
+    if (!map)
+    {
+        LOG_ERROR("server.loading", "[City Siege] Failed to find map {} for {}", city.mapId, city.name);
+        return;
+    }
+
+    bool isAllianceCity = IsAllianceCity(GetSiegeCity(event));
     
-    if (map && event.cityLeaderGuid)
+    // Randomly select a city leader from the opposing faction's leader pool
+    uint32 leaderEntry;
+    if (isAllianceCity)
     {
-        // Use the stored GUID to get the actual leader creature
-        Creature* cityLeader = map->GetCreature(event.cityLeaderGuid);
+        // Horde attacking Alliance city - pick random Horde leader
+        uint32 randomIndex = urand(0, g_HordeCityLeaders.size() - 1);
+        leaderEntry = g_HordeCityLeaders[randomIndex];
         
-        if (cityLeader && cityLeader->IsAlive())
-        {
-            defendersWon = true;
-            
-            if (g_DebugMode)
-            {
-                LOG_INFO("server.loading", "[City Siege] City leader {} is alive. Defenders win!",
-                         cityLeader->GetName());
-            }
-        }
-        else
+        if (g_DebugMode)
         {
-            leaderKilled = true;
-            
-            if (g_DebugMode)
-            {
-                if (cityLeader)
-                {
-                    LOG_INFO("server.loading", "[City Siege] City leader {} is dead. Attackers win!",
-                             cityLeader->GetName());
-                }
-                else
-                {
-                    LOG_INFO("server.loading", "[City Siege] City leader GUID {} not found (despawned?). Attackers win!",
-                             event.cityLeaderGuid.ToString());
-                }
-            }
+            LOG_INFO("server.loading", "[City Siege] Randomly selected Horde leader entry {} for attack on Alliance city {}", 
+                     leaderEntry, city.name);
         }
     }
     else
     {
-        // No leader GUID stored or no map - defenders win by default
-        defendersWon = true;
+        // Alliance attacking Horde city - pick random Alliance leader
+        uint32 randomIndex = urand(0, g_AllianceCityLeaders.size() - 1);
+        leaderEntry = g_AllianceCityLeaders[randomIndex];
         
         if (g_DebugMode)
         {
-            LOG_INFO("server.loading", "[City Siege] No city leader GUID stored. Defenders win by default.");
+            LOG_INFO("server.loading", "[City Siege] Randomly selected Alliance leader entry {} for attack on Horde city {}", 
+                     leaderEntry, city.name);
         }
     }
     
-    // If winningTeam was explicitly passed (GM command), override the result
-    if (winningTeam != -1)
+    BuildSiegeFormation(event, map, leaderEntry);
+
+    // Leaders come first in the formation, so the first batch always brings them in for the RP phase
+    ProcessPendingSpawns(event, g_SpawnBatchSize);
+}
+
+/**
+ * @brief Despawns the creatures of a siege event, attackers first, then defenders.
+ * @param event The siege event to clean up.
+ * @param maxCount Maximum number of creatures to despawn in this call, 0 for all remaining.
+ * @return True once every creature is gone and the siege's unit data has been cleared.
+ */
+bool DespawnSiegeCreatures(SiegeEvent& event, uint32 maxCount = 0)
+{
+    SiegePerfScope perf(SIEGE_PERF_DESPAWN);
+    const CityData& city = GetSiegeCity(event);
+    Map* map = sMapMgr->FindMap(city.mapId, 0);
+    
+    size_t total = event.spawnedCreatures.size() + event.spawnedDefenders.size();
+    size_t end = maxCount ? std::min(total, event.teardownCursor + maxCount) : total;
+    for (; event.teardownCursor < end; ++event.teardownCursor)
     {
-        defendersWon = false;
-        leaderKilled = true;
-        
-        if (g_DebugMode)
+        size_t index = event.teardownCursor;
+        const ObjectGuid& guid = index < event.spawnedCreatures.size() ? event.spawnedCreatures[index] :
+            event.spawnedDefenders[index - event.spawnedCreatures.size()];
+
+        if (Creature* creature = map ? map->GetCreature(guid) : nullptr)
         {
-            LOG_INFO("server.loading", "[City Siege] GM override: winningTeam = {}", winningTeam);
+            creature->DespawnOrUnsummon();
         }
     }
 
-    DespawnSiegeCreatures(event);
-    AnnounceSiege(city, false);
+    if (event.teardownCursor < total)
+    {
+        return false;
+    }
+    event.teardownCursor = 0;
+    
+    for (const auto& guid : event.spawnedCreatures)
+    {
+        event.unitIndex.erase(guid);
+    }
+    for (const auto& guid : event.spawnedDefenders)
+    {
+        event.unitIndex.erase(guid);
+    }
 
-    // Restore original weather
-    RestoreSiegeWeather(city, event);
+    event.spawnedCreatures.clear();
+    event.creatureSlots.clear();
+    event.rpSpeakerSlots.clear();
+    event.spawnedDefenders.clear();
+    event.defenderSlots.clear();
+    event.deadCreatures.clear();
+    event.pendingSpawns.clear();
+    event.nextPendingSpawn = 0;
+    event.squads.clear();
+    event.creatureSquads.clear();
+    event.defenderSquads.clear();
 
-    // Determine which faction owns the city
-    bool isAllianceCity = (event.cityId == CITY_STORMWIND || event.cityId == CITY_IRONFORGE || 
-                          event.cityId == CITY_DARNASSUS || event.cityId == CITY_EXODAR);
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Despawned attackers and defenders for siege at {}", city.name);
+    }
+    return true;
+}
 
-    // Announce the winner (using same logic as AnnounceSiege)
-    std::string winnerAnnouncement;
-    if (defendersWon)
+/**
+ * @brief Starts a new siege event in a random city.
+ */
+/**
+ * @brief Validates and corrects ground position before movement to prevent floating/stuck units.
+ * @param x X coordinate
+ * @param y Y coordinate  
+ * @param z Reference to Z coordinate to adjust
+ * @param map Map to check ground height
+ * @return true if position is valid, false if position is invalid/unreachable
+ */
+bool ValidateGroundPosition(float x, float y, float& z, Map* map)
+{
+    if (!map)
+        return false;
+
+    // Get ground height with generous search range
+    float groundZ = map->GetHeight(x, y, z + 100.0f, true, 100.0f);
+    
+    // If ground height is invalid, try searching from below
+    if (groundZ <= INVALID_HEIGHT)
     {
-        // Defenders won - announce defending faction victory
-        std::string defendingFaction = isAllianceCity ? "Alliance" : "Horde";
-        winnerAnnouncement = "|cff00ff00[City Siege]|r The " + defendingFaction + " has successfully defended " + city.name + "! Victory to the defenders!";
+        groundZ = map->GetHeight(x, y, z - 50.0f, true, 100.0f);
     }
-    else
+    
+    // Still invalid - position is not reachable
+    if (groundZ <= INVALID_HEIGHT)
     {
-        // Attackers won (city leader killed) - announce attacking faction victory
-        std::string attackingFaction = isAllianceCity ? "Horde" : "Alliance";
-        winnerAnnouncement = "|cffff0000[City Siege]|r The " + attackingFaction + " has conquered " + city.name + "! The city has fallen!";
+        return false;
     }
     
-    // Send announcement (same logic as AnnounceSiege)
-    if (g_AnnounceRadius == 0)
+    // Clamp Z to be no more than 5 yards from ground (prevent high-altitude floating)
+    if (z > groundZ + 5.0f)
     {
-        // Announce to the entire world
-        sWorldSessionMgr->SendServerMessage(SERVER_MSG_STRING, winnerAnnouncement);
+        z = groundZ + 0.5f;
     }
-    else
+    else if (z < groundZ - 2.0f)
     {
-        // Announce to players in range
-        Map* mapForAnnounce = sMapMgr->FindMap(city.mapId, 0);
-        if (mapForAnnounce)
-        {
-            Map::PlayerList const& players = mapForAnnounce->GetPlayers();
-            for (auto itr = players.begin(); itr != players.end(); ++itr)
-            {
-                if (Player* player = itr->GetSource())
-                {
-                    if (player->GetDistance(city.centerX, city.centerY, city.centerZ) <= g_AnnounceRadius)
-                    {
-                        ChatHandler(player->GetSession()).PSendSysMessage(winnerAnnouncement.c_str());
-                    }
-                }
-            }
-        }
+        // Too far below ground, raise to ground level
+        z = groundZ + 0.5f;
     }
     
-    if (g_DebugMode)
+    return true;
+}
+
+/**
+ * @brief Snaps a siege unit to the ground below it.
+ * @param creature The siege creature.
+ */
+void GroundSiegeUnit(Creature* creature)
+{
+    float creatureX = creature->GetPositionX();
+    float creatureY = creature->GetPositionY();
+    float creatureZ = creature->GetPositionZ();
+    float groundZ = creature->GetMap()->GetHeight(creatureX, creatureY, creatureZ + 5.0f, true, 50.0f);
+
+    if (groundZ > INVALID_HEIGHT)
     {
-        LOG_INFO("server.loading", "[City Siege] {}", winnerAnnouncement);
+        creature->UpdateGroundPositionZ(creatureX, creatureY, groundZ);
+        creature->Relocate(creatureX, creatureY, groundZ, creature->GetOrientation());
     }
+}
 
-    // Play victory or defeat music if enabled
-    if (g_MusicEnabled)
+/**
+ * @brief Gets the cached navmesh path between two consecutive path points, computing it on first use.
+ * @param city The city the path belongs to.
+ * @param creature Unit used as pathfinding source for the first computation.
+ * @param fromIndex Path point the leg starts at (see GetSiegePathPoint).
+ * @param toIndex Path point the leg ends at, must be next to fromIndex.
+ * @return The path points, or nullptr if the points are not adjacent or no complete path exists.
+ */
+const Movement::PointsArray* GetCachedSiegeLeg(const CityData& city, Creature* creature, uint32 fromIndex, uint32 toIndex)
+{
+    CityPathCache& cache = *city.paths;
+    uint32 legCount = city.waypoints.size() + 1;
+    if (cache.forwardLegs.size() != legCount)
     {
-        Map* map = sMapMgr->FindMap(city.mapId, 0);
-        if (map)
-        {
-            if (defendersWon && g_VictoryMusicId > 0)
-            {
-                // Send victory music to players within announce radius
-                Map::PlayerList const& players = map->GetPlayers();
-                for (auto itr = players.begin(); itr != players.end(); ++itr)
-                {
-                    if (Player* player = itr->GetSource())
-                    {
-                        if (player->GetDistance(city.centerX, city.centerY, city.centerZ) <= g_AnnounceRadius)
-                        {
-                            player->SendDirectMessage(WorldPackets::Misc::PlayMusic(g_VictoryMusicId).Write());
-                        }
-                    }
-                }
-                
-                if (g_DebugMode)
-                {
-                    LOG_INFO("server.loading", "[City Siege] Playing victory music (ID: {}) for defenders' victory at {}", g_VictoryMusicId, city.name);
-                }
-            }
-            else if (!defendersWon && g_DefeatMusicId > 0)
-            {
-                // Send defeat music to players within announce radius
-                Map::PlayerList const& players = map->GetPlayers();
-                for (auto itr = players.begin(); itr != players.end(); ++itr)
-                {
-                    if (Player* player = itr->GetSource())
-                    {
-                        if (player->GetDistance(city.centerX, city.centerY, city.centerZ) <= g_AnnounceRadius)
-                        {
-                            player->SendDirectMessage(WorldPackets::Misc::PlayMusic(g_DefeatMusicId).Write());
-                        }
-                    }
-                }
-                
-                if (g_DebugMode)
-                {
-                    LOG_INFO("server.loading", "[City Siege] Playing defeat music (ID: {}) for attackers' victory at {}", g_DefeatMusicId, city.name);
-                }
-            }
-        }
+        cache.forwardLegs.assign(legCount, SiegePathLeg());
+        cache.backwardLegs.assign(legCount, SiegePathLeg());
     }
 
-    if (g_RewardOnDefense)
+    SiegePathLeg* leg;
+    if (toIndex == fromIndex + 1 && fromIndex < legCount)
     {
-        if (defendersWon)
+        leg = &cache.forwardLegs[fromIndex];
+    }
+    else if (fromIndex == toIndex + 1 && toIndex < legCount)
+    {
+        leg = &cache.backwardLegs[toIndex];
+    }
+    else
+    {
+        return nullptr;
+    }
+
+    if (!leg->computed)
+    {
+        leg->computed = true;
+
+        Waypoint from = GetSiegePathPoint(city, fromIndex);
+        Waypoint to = GetSiegePathPoint(city, toIndex);
+        PathGenerator path(creature);
+        if (path.CalculatePath(from.x, from.y, from.z, to.x, to.y, to.z, false) && (path.GetPathType() & PATHFIND_NORMAL))
         {
-            // Defenders won - reward defending faction (0 = Alliance, 1 = Horde)
-            int winningTeam = isAllianceCity ? 0 : 1;
-            DistributeRewards(event, city, winningTeam);
+            leg->points = path.GetPath();
         }
-        else
+
+        if (g_DebugMode)
         {
-            // Attackers won (city leader killed) - reward attacking faction
-            int winningTeam = isAllianceCity ? 1 : 0; // Opposite faction
-            DistributeRewards(event, city, winningTeam);
+            LOG_INFO("server.loading", "[City Siege] Cached path {} -> {} for {}: {} points",
+                     fromIndex, toIndex, city.name, leg->points.size());
         }
     }
 
-    // Respawn city leader if they were killed during the siege
-    if (leaderKilled && map)
+    return leg->points.size() >= 2 ? &leg->points : nullptr;
+}
+
+/**
+ * @brief Sends a siege unit from one path point to the next.
+ * Units that are still near the leg start follow the cached navmesh leg with a lateral offset,
+ * all others (e.g. after a fight pulled them off the path) get a fresh pathfind.
+ * @param creature The siege creature.
+ * @param city The city being sieged.
+ * @param fromIndex Path point the unit is coming from.
+ * @param toIndex Path point the unit is heading to.
+ * @param destX Destination X (jittered around the path point).
+ * @param destY Destination Y (jittered around the path point).
+ * @param destZ Destination Z.
+ */
+void MoveSiegeUnit(Creature* creature, const CityData& city, uint32 fromIndex, uint32 toIndex, float destX, float destY, float destZ)
+{
+    Movement::MoveSplineInit init(creature);
+
+    const Movement::PointsArray* leg = GetCachedSiegeLeg(city, creature, fromIndex, toIndex);
+    if (leg && creature->GetExactDist2d(leg->front().x, leg->front().y) <= 10.0f)
     {
-        // Search around the leader's throne coordinates directly
-        std::list<Creature*> leaderList;
-        CitySiege::CreatureEntryCheck check(city.targetLeaderEntry);
-        CitySiege::SimpleCreatureListSearcher<CitySiege::CreatureEntryCheck> searcher(leaderList, check);
-        Cell::VisitObjects(city.leaderX, city.leaderY, map, searcher, 100.0f);
-        
-        Creature* existingLeader = nullptr;
-        
-        // Find the leader at the throne
-        for (Creature* leader : leaderList)
+        Movement::PointsArray path(*leg);
+
+        // Stable offset per unit (-2 to +2 yards) so units sharing a leg march side by side
+        float offset = float(int32(creature->GetGUID().GetCounter() % 5) - 2);
+        for (size_t i = 1; i + 1 < path.size(); ++i)
         {
-            if (leader)
-            {
-                existingLeader = leader;
-                break;
-            }
+            float dx = (*leg)[i].x - (*leg)[i - 1].x;
+            float dy = (*leg)[i].y - (*leg)[i - 1].y;
+            float length = std::sqrt(dx * dx + dy * dy);
+            if (length < 0.1f)
+                continue;
+
+            path[i].x -= dy / length * offset;
+            path[i].y += dx / length * offset;
         }
-        
-        // Respawn the leader
-        if (existingLeader)
+
+        // End on the unit's own jittered destination (the first point is replaced by the unit position on launch)
+        path.back() = G3D::Vector3(destX, destY, destZ);
+        init.MovebyPath(path);
+    }
+    else
+    {
+        // Use MoveSplineInit for proper pathfinding
+        init.MoveTo(destX, destY, destZ, true, true);
+    }
+
+    init.SetWalk(false);
+    init.Launch();
+}
+
+/**
+ * @brief Resets a siege unit's waypoint progress and sends it towards its first destination.
+ * Attackers start at the first waypoint, defenders at the last one and walk the path backwards.
+ * @param event The siege event the unit belongs to.
+ * @param creature The siege creature.
+ * @param slot Slot of the creature in spawnedCreatures or spawnedDefenders.
+ * @param isDefender True for city defenders, false for attackers.
+ */
+void StartSiegeUnitMarch(SiegeEvent& event, Creature* creature, uint32 slot, bool isDefender)
+{
+    const CityData& city = GetSiegeCity(event);
+    SiegeEvent::UnitSlot& unit = GetSiegeUnitSlot(event, slot, isDefender);
+    unit.lastMoveTime = time(nullptr);
+    unit.parked = false;
+    unit.parkedLegPoint = 0;
+    unit.progressTarget = SIEGE_PROGRESS_NONE;
+
+    float destX, destY, destZ;
+    if (isDefender)
+    {
+        // Defenders start at the LAST waypoint (highest index) and go backwards
+        uint32 startWaypoint = city.waypoints.empty() ? 0 : city.waypoints.size();
+        unit.progress = { startWaypoint, SIEGE_MARCH_BACKWARD };
+
+        if (!city.waypoints.empty())
         {
-            if (!existingLeader->IsAlive())
-            {
-                existingLeader->Respawn();
-                
-                if (g_DebugMode)
-                {
-                    LOG_INFO("server.loading", "[City Siege] Respawned city leader {} (entry {}) at {}", 
-                             city.name, city.targetLeaderEntry, existingLeader->GetName());
-                }
-            }
+            destX = city.waypoints.back().x;
+            destY = city.waypoints.back().y;
+            destZ = city.waypoints.back().z;
         }
         else
         {
-            // Leader doesn't exist in world - log warning
-            if (g_DebugMode)
-            {
-                LOG_WARN("server.loading", "[City Siege] Could not find city leader {} (entry {}) to respawn!", 
-                         city.name, city.targetLeaderEntry);
-            }
+            // No waypoints, go directly to spawn point
+            destX = city.spawnX;
+            destY = city.spawnY;
+            destZ = city.spawnZ;
+        }
+    }
+    else
+    {
+        // Attackers start from waypoint 0 and move forward
+        unit.progress = { 0, SIEGE_MARCH_FORWARD };
+
+        if (!city.waypoints.empty())
+        {
+            destX = city.waypoints[0].x;
+            destY = city.waypoints[0].y;
+            destZ = city.waypoints[0].z;
+        }
+        else
+        {
+            // No waypoints, go directly to leader
+            destX = city.leaderX;
+            destY = city.leaderY;
+            destZ = city.leaderZ;
         }
     }
 
-    // Deactivate playerbots from siege
-    DeactivatePlayerbotsFromSiege(event);
+    // Randomize position within 5 yards to prevent bunching (X/Y only, the waypoint Z prevents underground pathing)
+    // Attackers head for path point 1, defenders for the last waypoint (or the spawn point without waypoints)
+    CityHeightCache& heights = GetCityHeightCache(city, creature->GetMap());
+    JitterPathPoint(heights, isDefender ? city.waypoints.size() : 1, destX, destY);
 
-    if (g_DebugMode)
+    // Update home position before movement to prevent evading
+    creature->SetHomePosition(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ(), creature->GetOrientation());
+
+    // Attackers leave the spawn point, defenders the leader position
+    if (isDefender)
     {
-        LOG_INFO("server.loading", "[City Siege] Ended siege event at {} - {} won", 
-                 city.name, defendersWon ? "Defenders" : "Attackers");
+        MoveSiegeUnit(creature, city, city.waypoints.size() + 1, city.waypoints.size(), destX, destY, destZ);
+    }
+    else
+    {
+        MoveSiegeUnit(creature, city, 0, 1, destX, destY, destZ);
     }
 }
 
 /**
- * @brief Distributes rewards to players who defended the city.
- * @param event The siege event that ended.
- * @param city The city that was defended.
- * @param winningTeam The team ID to reward (0=Alliance, 1=Horde, -1=all players)
+ * @brief Groups the units of one side from a slot on into squads of consecutive same-rank units.
+ * @param event The siege event.
+ * @param isDefender True for the defenders, false for the attackers.
+ * @param firstSlot First slot to group, the slots before it keep their squads.
  */
-void DistributeRewards(const SiegeEvent& /*event*/, const CityData& city, int winningTeam)
+void AddSiegeSquads(SiegeEvent& event, bool isDefender, uint32 firstSlot)
 {
-    Map* map = sMapMgr->FindMap(city.mapId, 0);
-    if (!map)
+    std::vector<int32>& unitSquads = isDefender ? event.defenderSquads : event.creatureSquads;
+    uint32 unitCount = isDefender ? event.spawnedDefenders.size() : event.spawnedCreatures.size();
+    unitSquads.resize(unitCount, -1);
+
+    if (g_SquadSize <= 1)
     {
         return;
     }
 
-    uint32 rewardedPlayers = 0;
-    Map::PlayerList const& players = map->GetPlayers();
-    
-    for (auto itr = players.begin(); itr != players.end(); ++itr)
+    uint32 slot = firstSlot;
+    while (slot < unitCount)
     {
-        if (Player* player = itr->GetSource())
+        SiegeUnitRole role = GetSiegeUnitSlot(event, slot, isDefender).role;
+
+        SiegeEvent::SiegeSquad squad;
+        squad.isDefender = isDefender;
+        squad.leader = 0;
+        while (slot < unitCount && squad.slots.size() < g_SquadSize &&
+               GetSiegeUnitSlot(event, slot, isDefender).role == role)
         {
-            // If winningTeam is specified, only reward players of that faction
-            if (winningTeam != -1 && player->GetTeamId() != winningTeam)
-            {
-                continue;
-            }
-            
-            // Check if player is in range and appropriate level
-            if (player->GetDistance(city.centerX, city.centerY, city.centerZ) <= g_AnnounceRadius &&
-                player->GetLevel() >= g_MinimumLevel)
-            {
-                uint32 honorAwarded = 0;
-                uint32 goldAwarded = 0;
-                
-                // Award honor
-                if (g_RewardHonor > 0)
-                {
-                    player->RewardHonor(nullptr, 1, g_RewardHonor);
-                    honorAwarded = g_RewardHonor;
-                }
-                
-                // Award gold scaled by player level
-                if (g_RewardGoldBase > 0 || g_RewardGoldPerLevel > 0)
-                {
-                    goldAwarded = g_RewardGoldBase + (g_RewardGoldPerLevel * player->GetLevel());
-                    player->ModifyMoney(goldAwarded);
-                }
-                
-                // Send detailed confirmation message with rewards
-                char rewardMsg[512];
-                uint32 goldCoins = goldAwarded / 10000;
-                uint32 silverCoins = (goldAwarded % 10000) / 100;
-                uint32 copperCoins = goldAwarded % 100;
-                
-                if (honorAwarded > 0 && goldAwarded > 0)
-                {
-                    // Both honor and gold
-                    if (goldCoins > 0)
-                    {
-                        snprintf(rewardMsg, sizeof(rewardMsg), 
-                            "|cff00ff00[City Siege]|r You have been rewarded for defending %s! Received: |cffFFD700%u Honor|r and |cffFFD700%ug %us %uc|r",
-                            city.name.c_str(), honorAwarded, goldCoins, silverCoins, copperCoins);
-                    }
-                    else if (silverCoins > 0)
-                    {
-                        snprintf(rewardMsg, sizeof(rewardMsg), 
-                            "|cff00ff00[City Siege]|r You have been rewarded for defending %s! Received: |cffFFD700%u Honor|r and |cffFFD700%us %uc|r",
-                            city.name.c_str(), honorAwarded, silverCoins, copperCoins);
-                    }
-                    else
-                    {
-                        snprintf(rewardMsg, sizeof(rewardMsg), 
-                            "|cff00ff00[City Siege]|r You have been rewarded for defending %s! Received: |cffFFD700%u Honor|r and |cffFFD700%uc|r",
-                            city.name.c_str(), honorAwarded, copperCoins);
-                    }
-                }
-                else if (honorAwarded > 0)
-                {
-                    // Only honor
-                    snprintf(rewardMsg, sizeof(rewardMsg), 
-                        "|cff00ff00[City Siege]|r You have been rewarded for defending %s! Received: |cffFFD700%u Honor|r",
-                        city.name.c_str(), honorAwarded);
-                }
-                else if (goldAwarded > 0)
-                {
-                    // Only gold
-                    if (goldCoins > 0)
-                    {
-                        snprintf(rewardMsg, sizeof(rewardMsg), 
-                            "|cff00ff00[City Siege]|r You have been rewarded for defending %s! Received: |cffFFD700%ug %us %uc|r",
-                            city.name.c_str(), goldCoins, silverCoins, copperCoins);
-                    }
-                    else if (silverCoins > 0)
-                    {
-                        snprintf(rewardMsg, sizeof(rewardMsg), 
-                            "|cff00ff00[City Siege]|r You have been rewarded for defending %s! Received: |cffFFD700%us %uc|r",
-                            city.name.c_str(), silverCoins, copperCoins);
-                    }
-                    else
-                    {
-                        snprintf(rewardMsg, sizeof(rewardMsg), 
-                            "|cff00ff00[City Siege]|r You have been rewarded for defending %s! Received: |cffFFD700%uc|r",
-                            city.name.c_str(), copperCoins);
-                    }
-                }
-                else
-                {
-                    // No rewards configured
-                    snprintf(rewardMsg, sizeof(rewardMsg), 
-                        "|cff00ff00[City Siege]|r You have been rewarded for defending %s!",
-                        city.name.c_str());
-                }
-                
-                ChatHandler(player->GetSession()).PSendSysMessage(rewardMsg);
-                
-                rewardedPlayers++;
-            }
+            squad.slots.push_back(slot++);
+        }
+
+        // A squad of one is just a unit pathing on its own
+        if (squad.slots.size() < 2)
+        {
+            continue;
+        }
+
+        squad.followedLeader.resize(squad.slots.size());
+        for (uint32 memberSlot : squad.slots)
+        {
+            unitSquads[memberSlot] = event.squads.size();
         }
+        event.squads.push_back(squad);
     }
-    
+}
+
+/**
+ * @brief Groups the siege units into squads of CitySiege.Squad.Size units of the same rank, in formation order.
+ * @param event The siege event to build the squads for.
+ */
+void BuildSiegeSquads(SiegeEvent& event)
+{
+    event.squads.clear();
+    event.creatureSquads.assign(event.spawnedCreatures.size(), -1);
+    event.defenderSquads.assign(event.spawnedDefenders.size(), -1);
+
+    if (g_SquadSize <= 1)
+    {
+        return;
+    }
+
+    AddSiegeSquads(event, false, 0);
+    AddSiegeSquads(event, true, 0);
+
     if (g_DebugMode)
     {
-        LOG_INFO("server.loading", "[City Siege] Rewarded {} players for the siege of {}", 
-                 rewardedPlayers, city.name);
+        LOG_INFO("server.loading", "[City Siege] Formed {} squads of up to {} units for siege at {}",
+                 event.squads.size(), g_SquadSize, GetSiegeCity(event).name);
     }
 }
 
-#ifdef MOD_PLAYERBOTS
 /**
- * @brief Checks for dead bots during siege and adds them to respawn queue
- * @param event The siege event
+ * @brief Keeps a squad member in formation: squad leaders path on their own, the others follow them.
+ * Promotes the next living member when the leader has died.
+ * @param event The siege event the unit belongs to.
+ * @param map The city map.
+ * @param creature The siege creature.
+ * @param slot Slot of the creature in spawnedCreatures or spawnedDefenders.
+ * @param isDefender True for city defenders, false for attackers.
+ * @return True if the creature is a follower and has been handled, false if it paths on its own.
  */
-void CheckBotDeaths(SiegeEvent& event)
+bool UpdateSquadFollower(SiegeEvent& event, Map* map, Creature* creature, uint32 slot, bool isDefender)
 {
-    if (!g_PlayerbotsEnabled)
-        return;
-        
-    uint32 currentTime = time(nullptr);
-    
-    // Check defender bots for deaths
-    for (const auto& botGuid : event.defenderBots)
+    const std::vector<int32>& unitSquads = isDefender ? event.defenderSquads : event.creatureSquads;
+    if (slot >= unitSquads.size() || unitSquads[slot] < 0)
     {
-        Player* bot = ObjectAccessor::FindPlayer(botGuid);
-        if (!bot || !bot->IsInWorld())
-            continue;
-            
-        // If bot is dead and not already in respawn queue
-        if (!bot->IsAlive())
-        {
-            // Check if already in respawn queue
-            bool alreadyQueued = false;
-            for (const auto& deadBot : event.deadBots)
-            {
-                if (deadBot.botGuid == botGuid)
-                {
-                    alreadyQueued = true;
-                    break;
-                }
-            }
-            
-            if (!alreadyQueued)
-            {
-                SiegeEvent::BotRespawnData respawnData;
-                respawnData.botGuid = botGuid;
-                respawnData.deathTime = currentTime;
-                respawnData.isDefender = true;
-                event.deadBots.push_back(respawnData);
-                
-                if (g_DebugMode)
-                {
-                    LOG_INFO("server.loading", "[City Siege] Defender bot {} died, will respawn in {} seconds",
-                             bot->GetName(), g_PlayerbotsRespawnDelay);
-                }
-            }
-        }
+        return false;
     }
-    
-    // Check attacker bots for deaths
-    for (const auto& botGuid : event.attackerBots)
+
+    SiegeEvent::SiegeSquad& squad = event.squads[unitSquads[slot]];
+    const std::vector<ObjectGuid>& guids = isDefender ? event.spawnedDefenders : event.spawnedCreatures;
+
+    Creature* leader = map->GetCreature(guids[squad.slots[squad.leader]]);
+    if (!leader || !leader->IsAlive())
     {
-        Player* bot = ObjectAccessor::FindPlayer(botGuid);
-        if (!bot || !bot->IsInWorld())
-            continue;
-            
-        // If bot is dead and not already in respawn queue
-        if (!bot->IsAlive())
+        // Promote the next living member, it carries on from the waypoint the squad had reached
+        for (uint32 i = 1; i <= squad.slots.size(); ++i)
         {
-            // Check if already in respawn queue
-            bool alreadyQueued = false;
-            for (const auto& deadBot : event.deadBots)
-            {
-                if (deadBot.botGuid == botGuid)
-                {
-                    alreadyQueued = true;
-                    break;
-                }
-            }
-            
-            if (!alreadyQueued)
+            uint32 candidate = (squad.leader + i) % squad.slots.size();
+            Creature* member = map->GetCreature(guids[squad.slots[candidate]]);
+            if (member && member->IsAlive())
             {
-                SiegeEvent::BotRespawnData respawnData;
-                respawnData.botGuid = botGuid;
-                respawnData.deathTime = currentTime;
-                respawnData.isDefender = false;
-                event.deadBots.push_back(respawnData);
-                
+                squad.leader = candidate;
+                leader = member;
+                member->GetMotionMaster()->Clear(false);
+                member->GetMotionMaster()->MoveIdle();
+
                 if (g_DebugMode)
                 {
-                    LOG_INFO("server.loading", "[City Siege] Attacker bot {} died, will respawn in {} seconds",
-                             bot->GetName(), g_PlayerbotsRespawnDelay);
+                    LOG_INFO("server.loading", "[City Siege] Promoted {} to squad leader", member->GetGUID().ToString());
                 }
+                break;
             }
         }
     }
+
+    // With no living member left the caller is the only one, it paths on its own
+    if (!leader || !leader->IsAlive() || leader == creature)
+    {
+        return false;
+    }
+
+    // Followers share the leader's waypoint progress so any of them can take over
+    uint32 member = std::find(squad.slots.begin(), squad.slots.end(), slot) - squad.slots.begin();
+    GetSiegeUnitSlot(event, slot, isDefender).progress = GetSiegeUnitSlot(event, squad.slots[squad.leader], isDefender).progress;
+
+    if (squad.followedLeader[member] != leader->GetGUID() ||
+        creature->GetMotionMaster()->GetCurrentMovementGeneratorType() != FOLLOW_MOTION_TYPE)
+    {
+        // Rows of three behind the leader
+        uint32 rank = member < squad.leader ? member : member - 1;
+        float dist = 2.5f + 2.0f * (rank / 3);
+        float angle = M_PI + 0.5f * (int32(rank % 3) - 1);
+
+        creature->GetMotionMaster()->Clear(false);
+        creature->GetMotionMaster()->MoveFollow(leader, dist, angle);
+        squad.followedLeader[member] = leader->GetGUID();
+    }
+
+    return true;
 }
 
+#ifdef MOD_PLAYERBOTS
+static const uint32 SIEGE_BOT_LEVEL_BRACKETS = 9; // Brackets of 10 levels, level 80 goes in the last one
+
+// Recruitment candidates: random bots bucketed by team and level bracket. Rebuilt a batch of
+// bots per world tick so that a siege start never has to walk the whole bot list.
+struct SiegeBotCandidateIndex
+{
+    std::vector<ObjectGuid> candidates[2]; // Per team (TeamId), ordered by level bracket
+    uint32 bracketStart[2][SIEGE_BOT_LEVEL_BRACKETS + 1] = {}; // Offset of each bracket in candidates
+    bool ready = false;
+
+    // Rebuild in progress
+    bool scanning = false;
+    std::vector<ObjectGuid> scanQueue;
+    size_t scanPos = 0;
+    std::vector<ObjectGuid> building[2][SIEGE_BOT_LEVEL_BRACKETS];
+    uint32 nextRefresh = 0;
+};
+
+static SiegeBotCandidateIndex g_BotCandidates;
+
 /**
- * @brief Processes bot respawns after delay expires
- * @param event The siege event
+ * @brief Gets the candidate index bracket of a level.
  */
-void ProcessBotRespawns(SiegeEvent& event)
+inline uint32 GetSiegeBotLevelBracket(uint32 level)
 {
-    if (!g_PlayerbotsEnabled || event.deadBots.empty())
-        return;
-        
+    return std::min<uint32>(level / 10, SIEGE_BOT_LEVEL_BRACKETS - 1);
+}
+
+/**
+ * @brief Advances the rebuild of the recruitment candidate index.
+ * A rebuild starts every CitySiege.Playerbots.IndexInterval seconds and only records team
+ * and level; everything that changes quickly is checked when a bot is drawn.
+ * @param maxCount Maximum number of bots to index, 0 to finish a (new) rebuild right away.
+ */
+void UpdateSiegeBotCandidateIndex(uint32 maxCount)
+{
+    SiegeBotCandidateIndex& index = g_BotCandidates;
     uint32 currentTime = time(nullptr);
-    const CityData& city = g_Cities[event.cityId];
-    
-    // Process respawns (iterate backwards so we can safely erase)
-    for (auto it = event.deadBots.begin(); it != event.deadBots.end();)
+
+    if (!index.scanning)
     {
-        if (currentTime - it->deathTime >= g_PlayerbotsRespawnDelay)
+        if (maxCount && currentTime < index.nextRefresh)
         {
-            Player* bot = ObjectAccessor::FindPlayer(it->botGuid);
+            return;
+        }
 
-            // If the Player object is not present or not in world anymore, keep the entry and try again later
-            if (!bot || !bot->IsInWorld())
-            {
-                ++it;
-                continue;
-            }
+        index.scanQueue.clear();
+        for (auto& pair : sRandomPlayerbotMgr->GetAllBots())
+        {
+            index.scanQueue.push_back(pair.first);
+        }
+        index.scanPos = 0;
+        index.scanning = true;
+    }
 
-            // Determine desired respawn position depending on faction
-            float desiredX, desiredY, desiredZ;
-            if (it->isDefender)
-            {
-                desiredX = city.leaderX;
-                desiredY = city.leaderY;
-                desiredZ = city.leaderZ;
-            }
-            else
-            {
-                desiredX = city.spawnX;
-                desiredY = city.spawnY;
-                desiredZ = city.spawnZ;
-            }
+    SiegePerfScope perf(SIEGE_PERF_BOT_RECRUIT);
 
-            // If bot is alive already, check whether it's at the correct location (not a graveyard)
-            if (bot->IsAlive())
-            {
-                float distToDesired = bot->GetDistance2d(desiredX, desiredY);
-                // If bot is already close to desired respawn location, consider it handled
-                if (distToDesired <= 15.0f)
-                {
-                    it = event.deadBots.erase(it);
-                    continue;
-                }
-                // Otherwise fall through and force-teleport/reissue movement so the bot goes to the siege spawn/leader
-            }
-            else
-            {
-                // Bot is dead: resurrect now
-                bot->ResurrectPlayer(1.0f); // Full health and mana
-                bot->SpawnCorpseBones();
-            }
+    size_t end = maxCount ? std::min(index.scanQueue.size(), index.scanPos + maxCount) : index.scanQueue.size();
+    for (; index.scanPos < end; ++index.scanPos)
+    {
+        Player* bot = ObjectAccessor::FindPlayer(index.scanQueue[index.scanPos]);
+        if (!bot || !bot->IsInWorld())
+            continue;
 
-            // Ensure bot is active and participating
-            bot->RemovePlayerFlag(PLAYER_FLAGS_AFK);
-            bot->SetPvP(true);
+        TeamId team = bot->GetTeamId();
+        if (team != TEAM_ALLIANCE && team != TEAM_HORDE)
+            continue;
 
-            // Teleport to desired spawn/leader position with small randomization
-            float angle = frand(0.0f, 2.0f * M_PI);
-            float distance = frand(0.0f, 10.0f);
-            float respawnX = desiredX + distance * std::cos(angle);
-            float respawnY = desiredY + distance * std::sin(angle);
-            bot->TeleportTo(city.mapId, respawnX, respawnY, desiredZ, 0.0f);
+        index.building[team][GetSiegeBotLevelBracket(bot->GetLevel())].push_back(bot->GetGUID());
+    }
 
-            // Reinitialize waypoint/travel progress depending on defender/attacker
-            PlayerbotAI* botAI = sPlayerbotsMgr->GetPlayerbotAI(bot);
-            if (it->isDefender)
-            {
-                if (!city.waypoints.empty())
-                {
-                    size_t defenderWaypoint = city.waypoints.size() - 1;
-                    event.creatureWaypointProgress[it->botGuid] = defenderWaypoint;
+    if (index.scanPos < index.scanQueue.size())
+    {
+        return;
+    }
 
-                    if (defenderWaypoint > 0 && botAI)
-                    {
-                        const Waypoint& targetWP = city.waypoints[defenderWaypoint - 1];
-                        TravelTarget* travelTarget = botAI->GetAiObjectContext()->GetValue<TravelTarget*>("travel target")->Get();
-                        if (travelTarget)
-                        {
-                            WorldPosition* destPos = new WorldPosition(city.mapId, targetWP.x, targetWP.y, targetWP.z, 0.0f);
-                            TravelDestination* siegeDest = new TravelDestination(0.0f, 5.0f);
-                            siegeDest->addPoint(destPos);
-                            travelTarget->setTarget(siegeDest, destPos);
-                            travelTarget->setForced(true);
-                        }
+    // Rebuild complete - flatten the buckets so each level bracket is a contiguous range
+    for (uint32 team = 0; team < 2; ++team)
+    {
+        index.candidates[team].clear();
+        for (uint32 bracket = 0; bracket < SIEGE_BOT_LEVEL_BRACKETS; ++bracket)
+        {
+            index.bracketStart[team][bracket] = index.candidates[team].size();
+            index.candidates[team].insert(index.candidates[team].end(), index.building[team][bracket].begin(), index.building[team][bracket].end());
+            index.building[team][bracket].clear();
+        }
+        index.bracketStart[team][SIEGE_BOT_LEVEL_BRACKETS] = index.candidates[team].size();
+    }
 
-                        if (!botAI->HasStrategy("travel", BOT_STATE_NON_COMBAT))
-                            botAI->ChangeStrategy("+travel", BOT_STATE_NON_COMBAT);
-                    }
-                }
-            }
-            else
-            {
-                if (!city.waypoints.empty())
-                {
-                    event.creatureWaypointProgress[it->botGuid] = 0;
-                    if (botAI)
-                    {
-                        const Waypoint& targetWP = city.waypoints[0];
-                        TravelTarget* travelTarget = botAI->GetAiObjectContext()->GetValue<TravelTarget*>("travel target")->Get();
-                        if (travelTarget)
-                        {
-                            WorldPosition* destPos = new WorldPosition(city.mapId, targetWP.x, targetWP.y, targetWP.z, 0.0f);
-                            TravelDestination* siegeDest = new TravelDestination(0.0f, 5.0f);
-                            siegeDest->addPoint(destPos);
-                            travelTarget->setTarget(siegeDest, destPos);
-                            travelTarget->setForced(true);
-                        }
+    index.scanQueue.clear();
+    index.scanning = false;
+    index.ready = true;
+    index.nextRefresh = currentTime + g_PlayerbotsIndexInterval;
 
-                        if (!botAI->HasStrategy("travel", BOT_STATE_NON_COMBAT))
-                            botAI->ChangeStrategy("+travel", BOT_STATE_NON_COMBAT);
-                    }
-                }
-            }
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Bot candidate index rebuilt: {} Alliance, {} Horde",
+                 index.candidates[TEAM_ALLIANCE].size(), index.candidates[TEAM_HORDE].size());
+    }
+}
+
+/**
+ * @brief Checks whether a bot can be recruited for a siege right now.
+ * @param bot The bot (may be null).
+ * @param team The team the siege needs.
+ * @return True if the bot is free to join.
+ */
+bool IsSiegeBotEligible(Player* bot, TeamId team)
+{
+    if (!bot || !bot->IsInWorld() || bot->GetTeamId() != team)
+        return false;
+
+    if (bot->GetLevel() < g_PlayerbotsMinLevel || !bot->IsAlive() || bot->IsInCombat())
+        return false;
+
+    // Not in an instance/battleground, and not in a party or raid (we want free random bots, not alts)
+    if (bot->GetMap()->IsDungeon() || bot->GetMap()->IsBattleground() || bot->GetGroup())
+        return false;
+
+    // Not already fighting in another siege
+    for (const auto& siege : g_ActiveSieges)
+    {
+        if (siege.unitIndex.count(bot->GetGUID()))
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Draws random eligible bots from the candidate index.
+ * Partial Fisher-Yates over the brackets at or above the minimum level: only drawn bots are
+ * checked, so taking N bots costs O(N) plus the rejected draws.
+ * @param team The team to recruit from.
+ * @param maxCount Number of bots wanted.
+ * @param rejected Receives the number of drawn bots that were not eligible.
+ * @return The recruited bots.
+ */
+std::vector<Player*> SampleSiegeBotCandidates(TeamId team, uint32 maxCount, uint32& rejected)
+{
+    if (!g_BotCandidates.ready)
+    {
+        // First siege before the background rebuild finished
+        UpdateSiegeBotCandidateIndex(0);
+    }
+
+    std::vector<Player*> sampled;
+    std::vector<ObjectGuid>& candidates = g_BotCandidates.candidates[team];
+    uint32 first = g_BotCandidates.bracketStart[team][GetSiegeBotLevelBracket(g_PlayerbotsMinLevel)];
+    uint32 end = candidates.size();
+    rejected = 0;
 
-            // Put back into combat state
-            bot->SetInCombatState(true);
+    for (uint32 i = first; i < end && sampled.size() < maxCount; ++i)
+    {
+        std::swap(candidates[i], candidates[urand(i, end - 1)]);
 
-            // Remove from respawn queue
-            it = event.deadBots.erase(it);
+        Player* bot = ObjectAccessor::FindPlayer(candidates[i]);
+        if (!IsSiegeBotEligible(bot, team))
+        {
+            ++rejected;
+            continue;
         }
-        else
+
+        sampled.push_back(bot);
+    }
+
+    return sampled;
+}
+
+/**
+ * @brief Teleports the next batch of recruited bots into position.
+ * @param event The siege event.
+ * @param maxCount Maximum number of bots to teleport, 0 for all remaining.
+ */
+void ProcessPendingBotTeleports(SiegeEvent& event, uint32 maxCount)
+{
+    size_t remaining = event.pendingBotTeleports.size() - event.nextBotTeleport;
+    size_t count = (maxCount == 0) ? remaining : std::min<size_t>(remaining, maxCount);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const SiegeEvent::PendingBotTeleport& teleport = event.pendingBotTeleports[event.nextBotTeleport++];
+        Player* bot = ObjectAccessor::FindPlayer(teleport.botGuid);
+        if (bot && bot->IsInWorld())
         {
-            ++it;
+            bot->TeleportTo(GetSiegeCity(event).mapId, teleport.x, teleport.y, teleport.z, 0.0f);
         }
     }
+
+    if (event.nextBotTeleport >= event.pendingBotTeleports.size())
+    {
+        event.pendingBotTeleports.clear();
+        event.nextBotTeleport = 0;
+    }
 }
+#endif
 
 /**
- * @brief Updates bot waypoint movement during siege
- * @param event The siege event
- * Moves bots along waypoints when they reach their destination
+ * @brief Recruits defending playerbots to teleport to the city being sieged
+ * @param city The city structure containing position and faction info
+ * @param event The siege event to store bot return positions
+ * @return Vector of GUIDs of recruited defender bots
  */
-void UpdateBotWaypointMovement(SiegeEvent& event)
+std::vector<ObjectGuid> RecruitDefendingPlayerbots(CityData const& city, SiegeEvent& event)
 {
+    SiegePerfScope perf(SIEGE_PERF_BOT_RECRUIT);
+    std::vector<ObjectGuid> recruitedBots;
+    
+#ifdef MOD_PLAYERBOTS
     if (!g_PlayerbotsEnabled)
-        return;
-        
-    const CityData& city = g_Cities[event.cityId];
+    {
+        return recruitedBots;
+    }
     
-    if (city.waypoints.empty())
-        return;
+    // Get the defending faction for this city
+    TeamId defendingFaction = city.team;
     
-    // Update defender bot movement (move backward along waypoints toward spawn)
-    for (const auto& botGuid : event.defenderBots)
+    if (g_DebugMode)
     {
-        Player* bot = ObjectAccessor::FindPlayer(botGuid);
-        if (!bot || !bot->IsInWorld() || !bot->IsAlive())
-            continue;
-        
-        // Check if bot has reached their waypoint
-        auto wpIter = event.creatureWaypointProgress.find(botGuid);
-        if (wpIter == event.creatureWaypointProgress.end())
-            continue;
-        
-        uint32 currentWP = wpIter->second;
+        LOG_INFO("server.loading", "[City Siege] Recruiting defenders for {} - Need faction: {} ({})", 
+                 city.name, defendingFaction == TEAM_HORDE ? "HORDE" : "ALLIANCE", static_cast<int>(defendingFaction));
+    }
+    
+    // Draw random bots from the pre-filtered candidate index
+    uint32 rejected = 0;
+    std::vector<Player*> eligibleBots = SampleSiegeBotCandidates(defendingFaction, ScaleSiegeCount(g_PlayerbotsMaxDefenders, event.armyScale), rejected);
+    
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Defender recruitment stats - Candidates: {}, Rejected draws: {}, Recruited: {}", 
+                 g_BotCandidates.candidates[defendingFaction].size(), rejected, eligibleBots.size());
+    }
+    
+    // Store original positions and teleport bots to city center
+    for (Player* bot : eligibleBots)
+    {
+        // Store original position and PvP status for return later
+        SiegeEvent::BotReturnPosition returnPos;
+        returnPos.botGuid = bot->GetGUID();
+        returnPos.mapId = bot->GetMapId();
+        returnPos.x = bot->GetPositionX();
+        returnPos.y = bot->GetPositionY();
+        returnPos.z = bot->GetPositionZ();
+        returnPos.o = bot->GetOrientation();
+        returnPos.wasPvPFlagged = bot->IsPvP(); // Store original PvP status
         
-        // Always ensure bot has an active travel target if not at final destination
+        // Check for and store RPG strategy
         PlayerbotAI* botAI = sPlayerbotsMgr->GetPlayerbotAI(bot);
         if (botAI)
         {
-            TravelTarget* travelTarget = botAI->GetAiObjectContext()->GetValue<TravelTarget*>("travel target")->Get();
-            if (travelTarget)
+            // Check for "rpg" or "new rpg" strategy
+            if (botAI->HasStrategy("new rpg", BOT_STATE_NON_COMBAT))
             {
-                // For defenders: if not at spawn (waypoint 0) and not currently traveling, set next waypoint
-                if (currentWP > 0 && !travelTarget->isTraveling())
+                returnPos.rpgStrategy = "new rpg";
+                botAI->ChangeStrategy("-new rpg", BOT_STATE_NON_COMBAT); // Remove RPG strategy during siege
+                if (g_DebugMode)
                 {
-                    const Waypoint& nextWP = city.waypoints[currentWP - 1];
-                    WorldPosition* destPos = new WorldPosition(city.mapId, nextWP.x, nextWP.y, nextWP.z, 0.0f);
-                    TravelDestination* siegeDest = new TravelDestination(0.0f, 5.0f);
-                    siegeDest->addPoint(destPos);
-                    travelTarget->setTarget(siegeDest, destPos);
-                    travelTarget->setForced(true);
-                    
+                    LOG_INFO("server.loading", "[City Siege] Removed 'new rpg' strategy from defender bot {}", bot->GetName());
                 }
-                
-                // Check if bot reached current target waypoint by distance
-                if (currentWP > 0)
+            }
+            else if (botAI->HasStrategy("rpg", BOT_STATE_NON_COMBAT))
+            {
+                returnPos.rpgStrategy = "rpg";
+                botAI->ChangeStrategy("-rpg", BOT_STATE_NON_COMBAT); // Remove RPG strategy during siege
+                if (g_DebugMode)
                 {
-                    const Waypoint& targetWP = city.waypoints[currentWP - 1];
-                    // Use full 3D distance to account for small Z differences between config and actual ground
-                    float dist = bot->GetDistance(targetWP.x, targetWP.y, targetWP.z);
-
-                    // If bot is within 10 yards of target waypoint, advance immediately
-                    if (dist <= 10.0f)
-                    {
-                        currentWP--;
-                        event.creatureWaypointProgress[botGuid] = currentWP;
-
-
-                        // Immediately set next waypoint if not at spawn
-                        if (currentWP > 0)
-                        {
-                            const Waypoint& nextWP = city.waypoints[currentWP - 1];
-                            WorldPosition* destPos = new WorldPosition(city.mapId, nextWP.x, nextWP.y, nextWP.z, 0.0f);
-                            TravelDestination* siegeDest = new TravelDestination(0.0f, 5.0f);
-                            siegeDest->addPoint(destPos);
-                            travelTarget->setTarget(siegeDest, destPos);
-                            travelTarget->setForced(true);
-                        }
-                    }
+                    LOG_INFO("server.loading", "[City Siege] Removed 'rpg' strategy from defender bot {}", bot->GetName());
                 }
             }
+            else
+            {
+                returnPos.rpgStrategy = ""; // No RPG strategy active
+            }
         }
-    }
-    
-    // Update attacker bot movement (move forward along waypoints toward leader)
-    for (const auto& botGuid : event.attackerBots)
-    {
-        Player* bot = ObjectAccessor::FindPlayer(botGuid);
-        if (!bot || !bot->IsInWorld() || !bot->IsAlive())
-            continue;
         
-        // Check if bot has reached their waypoint
-        auto wpIter = event.creatureWaypointProgress.find(botGuid);
-        if (wpIter == event.creatureWaypointProgress.end())
-            continue;
+        event.botReturnPositions.push_back(returnPos);
+        
+        // Randomize position within ~10 yards of the leader
+        float angle = frand(0.0f, 2.0f * M_PI);
+        float distance = frand(0.0f, 10.0f);
+        float defenderX = city.leaderX + distance * std::cos(angle);
+        float defenderY = city.leaderY + distance * std::sin(angle);
+        float defenderZ = city.leaderZ; // Keep same Z as leader (will be adjusted by server)
         
-        uint32 currentWP = wpIter->second;
+        // Teleport to randomized position near city leader (throne room), spread over the cinematic
+        event.pendingBotTeleports.push_back({ bot->GetGUID(), defenderX, defenderY, defenderZ });
+        recruitedBots.push_back(bot->GetGUID());
         
-        // Always ensure bot has an active travel target if not at final destination
-        PlayerbotAI* botAI = sPlayerbotsMgr->GetPlayerbotAI(bot);
-        if (botAI)
+        if (g_DebugMode)
         {
-            TravelTarget* travelTarget = botAI->GetAiObjectContext()->GetValue<TravelTarget*>("travel target")->Get();
-            if (travelTarget)
-            {
-                // For attackers: if not at final waypoint and not currently traveling, set current waypoint
-                if (currentWP < city.waypoints.size() && !travelTarget->isTraveling())
-                {
-                    const Waypoint& currentWPData = city.waypoints[currentWP];
-                    WorldPosition* destPos = new WorldPosition(city.mapId, currentWPData.x, currentWPData.y, currentWPData.z, 0.0f);
-                    TravelDestination* siegeDest = new TravelDestination(0.0f, 5.0f);
-                    siegeDest->addPoint(destPos);
-                    travelTarget->setTarget(siegeDest, destPos);
-                    travelTarget->setForced(true);
-                }
-                
-                // Check if bot reached current target waypoint by distance
-                if (currentWP < city.waypoints.size())
-                {
-                    const Waypoint& targetWP = city.waypoints[currentWP];
-                    // Use full 3D distance to account for small Z differences between config and actual ground
-                    float dist = bot->GetDistance(targetWP.x, targetWP.y, targetWP.z);
-
-                    // If bot is within 10 yards of target waypoint, advance immediately
-                    if (dist <= 10.0f)
-                    {
-                        currentWP++;
-                        event.creatureWaypointProgress[botGuid] = currentWP;
-
-                        // Immediately set next waypoint if not at leader yet
-                        if (currentWP < city.waypoints.size())
-                        {
-                            const Waypoint& nextWP = city.waypoints[currentWP];
-                            WorldPosition* destPos = new WorldPosition(city.mapId, nextWP.x, nextWP.y, nextWP.z, 0.0f);
-                            TravelDestination* siegeDest = new TravelDestination(0.0f, 5.0f);
-                            siegeDest->addPoint(destPos);
-                            travelTarget->setTarget(siegeDest, destPos);
-                            travelTarget->setForced(true);
-                        }
-                    }
-                }
-            }
+            LOG_INFO("server.loading", "[City Siege] Recruited defender bot {} (Level {}) to {} near leader at [{:.2f}, {:.2f}, {:.2f}] (will return to map {} at [{:.2f}, {:.2f}, {:.2f}])", 
+                     bot->GetName(), bot->GetLevel(), city.name, defenderX, defenderY, defenderZ, returnPos.mapId, returnPos.x, returnPos.y, returnPos.z);
         }
     }
-}
+    
+    if (g_DebugMode && !recruitedBots.empty())
+    {
+        LOG_INFO("server.loading", "[City Siege] Total {} defender bots recruited to {}", 
+                 recruitedBots.size(), city.name);
+    }
 #endif
+    
+    return recruitedBots;
+}
 
 /**
- * @brief Updates all active siege events.
- * @param diff Time since last update in milliseconds.
+ * @brief Recruits attacking playerbots to teleport to the spawn point
+ * @param city The city structure containing spawn position
+ * @param event The siege event to store bot return positions
+ * @return Vector of GUIDs of recruited attacker bots
  */
-void UpdateSiegeEvents(uint32 /*diff*/)
+std::vector<ObjectGuid> RecruitAttackingPlayerbots(CityData const& city, SiegeEvent& event)
 {
-    uint32 currentTime = time(nullptr);
-
-    // Update active sieges
-    for (auto& event : g_ActiveSieges)
+    SiegePerfScope perf(SIEGE_PERF_BOT_RECRUIT);
+    std::vector<ObjectGuid> recruitedBots;
+    
+#ifdef MOD_PLAYERBOTS
+    if (!g_PlayerbotsEnabled)
     {
-        if (!event.isActive)
-        {
-            continue;
-        }
-
-        // Countdown announcements during cinematic phase (percentage-based)
-        if (event.cinematicPhase)
+        return recruitedBots;
+    }
+    
+    // Get the attacking faction (opposite of defending)
+    TeamId attackingFaction = GetSiegeAttackingTeam(city);
+    
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Recruiting attackers for {} - Need faction: {} ({})", 
+                 city.name, attackingFaction == TEAM_HORDE ? "HORDE" : "ALLIANCE", static_cast<int>(attackingFaction));
+    }
+    
+    // Draw random bots from the pre-filtered candidate index
+    uint32 rejected = 0;
+    std::vector<Player*> eligibleBots = SampleSiegeBotCandidates(attackingFaction, ScaleSiegeCount(g_PlayerbotsMaxAttackers, event.armyScale), rejected);
+    
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Attacker recruitment stats - Candidates: {}, Rejected draws: {}, Recruited: {}", 
+                 g_BotCandidates.candidates[attackingFaction].size(), rejected, eligibleBots.size());
+    }
+    
+    // Store original positions and teleport bots to spawn point (randomized within radius)
+    for (Player* bot : eligibleBots)
+    {
+        // Store original position and PvP status for return later
+        SiegeEvent::BotReturnPosition returnPos;
+        returnPos.botGuid = bot->GetGUID();
+        returnPos.mapId = bot->GetMapId();
+        returnPos.x = bot->GetPositionX();
+        returnPos.y = bot->GetPositionY();
+        returnPos.z = bot->GetPositionZ();
+        returnPos.o = bot->GetOrientation();
+        returnPos.wasPvPFlagged = bot->IsPvP(); // Store original PvP status
+        
+        // Check for and store RPG strategy
+        PlayerbotAI* botAI = sPlayerbotsMgr->GetPlayerbotAI(bot);
+        if (botAI)
         {
-            const CityData& city = g_Cities[event.cityId];
-            uint32 elapsed = currentTime - event.cinematicStartTime;
-            uint32 remaining = g_CinematicDelay > elapsed ? g_CinematicDelay - elapsed : 0;
-            
-            // Calculate percentage of time remaining
-            float percentRemaining = g_CinematicDelay > 0 ? (static_cast<float>(remaining) / static_cast<float>(g_CinematicDelay)) * 100.0f : 0.0f;
-            
-            // Announce at 75%, 50%, and 25% time remaining
-            if (percentRemaining <= 75.0f && !event.countdown75Announced)
-            {
-                event.countdown75Announced = true;
-                std::string countdownMsg = "|cffff0000[City Siege]|r |cffFFFF00" + std::to_string(remaining) + " seconds|r until the siege of " + city.name + " begins! Defenders, prepare!";
-                sWorldSessionMgr->SendServerMessage(SERVER_MSG_STRING, countdownMsg);
-            }
-            else if (percentRemaining <= 50.0f && !event.countdown50Announced)
-            {
-                event.countdown50Announced = true;
-                std::string countdownMsg = "|cffff0000[City Siege]|r |cffFF8800" + std::to_string(remaining) + " seconds|r until the siege of " + city.name + " begins! Defenders, to your posts!";
-                sWorldSessionMgr->SendServerMessage(SERVER_MSG_STRING, countdownMsg);
-            }
-            else if (percentRemaining <= 25.0f && !event.countdown25Announced)
+            // Check for "rpg" or "new rpg" strategy
+            if (botAI->HasStrategy("new rpg", BOT_STATE_NON_COMBAT))
             {
-                event.countdown25Announced = true;
-                std::string countdownMsg = "|cffff0000[City Siege]|r |cffFF0000" + std::to_string(remaining) + " seconds|r until the siege of " + city.name + " begins! FINAL WARNING!";
-                sWorldSessionMgr->SendServerMessage(SERVER_MSG_STRING, countdownMsg);
+                returnPos.rpgStrategy = "new rpg";
+                botAI->ChangeStrategy("-new rpg", BOT_STATE_NON_COMBAT); // Remove RPG strategy during siege
+                if (g_DebugMode)
+                {
+                    LOG_INFO("server.loading", "[City Siege] Removed 'new rpg' strategy from attacker bot {}", bot->GetName());
+                }
             }
-            
-            // RP Script execution during cinematic phase (sequential dialogue from leaders/mini-bosses)
-            if ((currentTime - event.lastYellTime) >= g_YellFrequency)
+            else if (botAI->HasStrategy("rpg", BOT_STATE_NON_COMBAT))
             {
-                event.lastYellTime = currentTime;
-                
-                // Play through the pre-chosen RP script sequentially
-                if (!event.activeRPScript.empty() && event.rpScriptIndex < event.activeRPScript.size())
+                returnPos.rpgStrategy = "rpg";
+                botAI->ChangeStrategy("-rpg", BOT_STATE_NON_COMBAT); // Remove RPG strategy during siege
+                if (g_DebugMode)
                 {
-                    const CityData& city = g_Cities[event.cityId];
-                    Map* map = sMapMgr->FindMap(city.mapId, 0);
-                    if (map)
-                    {
-                        std::vector<Creature*> rpCreatures;
-                        for (const auto& guid : event.spawnedCreatures)
-                        {
-                            if (Creature* creature = map->GetCreature(guid))
-                            {
-                                uint32 entry = creature->GetEntry();
-                                // Only leaders and mini-bosses do RP - check if entry is in leader pools or is a mini-boss
-                                bool isLeader = (std::find(g_AllianceCityLeaders.begin(), g_AllianceCityLeaders.end(), entry) != g_AllianceCityLeaders.end()) ||
-                                               (std::find(g_HordeCityLeaders.begin(), g_HordeCityLeaders.end(), entry) != g_HordeCityLeaders.end());
-                                bool isMiniBoss = (entry == g_CreatureAllianceMiniBoss || entry == g_CreatureHordeMiniBoss);
-                                
-                                if (creature->IsAlive() && (isLeader || isMiniBoss))
-                                {
-                                    rpCreatures.push_back(creature);
-                                }
-                            }
-                        }
-                        
-                        if (!rpCreatures.empty())
-                        {
-                            // Pick a random creature to say the current line
-                            uint32 randomCreatureIndex = urand(0, rpCreatures.size() - 1);
-                            Creature* yellingCreature = rpCreatures[randomCreatureIndex];
-                            yellingCreature->Yell(event.activeRPScript[event.rpScriptIndex], LANG_UNIVERSAL);
-                            
-                            if (g_DebugMode)
-                            {
-                                LOG_INFO("server.loading", "[City Siege] RP Line {}/{}: '{}'",
-                                         event.rpScriptIndex + 1, event.activeRPScript.size(), 
-                                         event.activeRPScript[event.rpScriptIndex]);
-                            }
-                            
-                            // Move to next line in script
-                            event.rpScriptIndex++;
-                        }
-                    }
+                    LOG_INFO("server.loading", "[City Siege] Removed 'rpg' strategy from attacker bot {}", bot->GetName());
                 }
             }
+            else
+            {
+                returnPos.rpgStrategy = ""; // No RPG strategy active
+            }
+        }
+        
+        event.botReturnPositions.push_back(returnPos);
+        
+        // Randomize position within ~10 yards of the spawn point
+        float angle = frand(0.0f, 2.0f * M_PI);
+        float distance = frand(0.0f, 10.0f);
+        float spawnX = city.spawnX + distance * std::cos(angle);
+        float spawnY = city.spawnY + distance * std::sin(angle);
+        float spawnZ = city.spawnZ; // Keep same Z as spawn (will be adjusted by server)
+        
+        // Teleport to randomized spawn point, spread over the cinematic
+        event.pendingBotTeleports.push_back({ bot->GetGUID(), spawnX, spawnY, spawnZ });
+        recruitedBots.push_back(bot->GetGUID());
+        
+        if (g_DebugMode)
+        {
+            LOG_INFO("server.loading", "[City Siege] Recruited attacker bot {} (Level {}) for siege on {} at [{:.2f}, {:.2f}, {:.2f}] (will return to map {} at [{:.2f}, {:.2f}, {:.2f}])", 
+                     bot->GetName(), bot->GetLevel(), city.name, spawnX, spawnY, spawnZ, returnPos.mapId, returnPos.x, returnPos.y, returnPos.z);
         }
+    }
+    
+    if (g_DebugMode && !recruitedBots.empty())
+    {
+        LOG_INFO("server.loading", "[City Siege] Total {} attacker bots recruited for siege on {}", 
+                 recruitedBots.size(), city.name);
+    }
+#endif
+    
+    return recruitedBots;
+}
 
-        // Check if cinematic phase is over
-        if (event.cinematicPhase && (currentTime - event.startTime) >= g_CinematicDelay)
+#ifdef MOD_PLAYERBOTS
+/**
+ * @brief Points a bot's travel target at a city waypoint.
+ * Uses the siege's shared destinations, so moving bots along the path allocates nothing.
+ * @param event The siege event the bot fights in.
+ * @param travelTarget The bot's travel target.
+ * @param waypointIndex Index into the city waypoints.
+ */
+void SetSiegeBotTravelTarget(SiegeEvent& event, TravelTarget* travelTarget, uint32 waypointIndex)
+{
+    if (event.botDestinations.empty())
+    {
+        const CityData& city = GetSiegeCity(event);
+        for (const Waypoint& wp : city.waypoints)
         {
-            event.cinematicPhase = false;
-            
-            const CityData& city = g_Cities[event.cityId];
-            
-            // Announce battle has begun!
-            std::string battleStart = "|cffff0000[City Siege]|r |cffFF0000THE BATTLE HAS BEGUN!|r The siege of " + city.name + " is now underway! Defenders, to arms!";
-            sWorldSessionMgr->SendServerMessage(SERVER_MSG_STRING, battleStart);
+            SiegeEvent::BotWaypointDestination dest;
+            dest.position = new WorldPosition(city.mapId, wp.x, wp.y, wp.z, 0.0f);
+            dest.destination = new TravelDestination(0.0f, 5.0f); // 5 yard radius
+            dest.destination->addPoint(dest.position);
+            event.botDestinations.push_back(dest);
+        }
+    }
+
+    if (waypointIndex >= event.botDestinations.size())
+    {
+        return;
+    }
+
+    const SiegeEvent::BotWaypointDestination& dest = event.botDestinations[waypointIndex];
+    travelTarget->setTarget(dest.destination, dest.position);
+    travelTarget->setForced(true);
+}
+#endif
+
+/**
+ * @brief Activates siege combat mode for playerbots
+ * @param event The siege event
+ * Puts bots into combat mode and gives them initial movement orders
+ */
+void ActivatePlayerbotsForSiege(SiegeEvent& event)
+{
+#ifdef MOD_PLAYERBOTS
+    if (!g_PlayerbotsEnabled)
+    {
+        return;
+    }
+    
+    CityData const* city = &GetSiegeCity(event);
+    
+    // Activate defender bots - move them toward spawn to intercept attackers
+    if (!city->waypoints.empty())
+    {
+        // Defenders start at leader and move backward along waypoints toward spawn
+        size_t defenderWaypoint = city->waypoints.size() - 1; // Start at last waypoint (near leader)
+        
+        for (const auto& botGuid : event.defenderBots)
+        {
+            Player* bot = ObjectAccessor::FindPlayer(botGuid);
+            if (!bot || !bot->IsInWorld())
+                continue;
+                
+            PlayerbotAI* botAI = sPlayerbotsMgr->GetPlayerbotAI(bot);
+            if (!botAI)
+                continue;
             
-            // Play combat phase music if enabled
-            if (g_MusicEnabled && g_CombatMusicId > 0)
-            {
-                Map* map = sMapMgr->FindMap(city.mapId, 0);
-                if (map)
-                {
-                    // Send combat music to players within announce radius
-                    Map::PlayerList const& players = map->GetPlayers();
-                    for (auto itr = players.begin(); itr != players.end(); ++itr)
-                    {
-                        if (Player* player = itr->GetSource())
-                        {
-                            if (player->GetDistance(city.centerX, city.centerY, city.centerZ) <= g_AnnounceRadius)
-                            {
-                                player->SendDirectMessage(WorldPackets::Misc::PlayMusic(g_CombatMusicId).Write());
-                            }
-                        }
-                    }
-                    
-                    if (g_DebugMode)
-                    {
-                        LOG_INFO("server.loading", "[City Siege] Playing combat phase music (ID: {}) for siege of {}", g_CombatMusicId, city.name);
-                    }
-                }
-            }
+            // Enable PvP mode for siege combat
+            bot->SetPvP(true);
             
-            // Activate playerbots for combat
-            ActivatePlayerbotsForSiege(event);
+            // Remove away status to ensure bot is active
+            bot->RemovePlayerFlag(PLAYER_FLAGS_AFK);
             
-            if (g_DebugMode)
+            // Enable PvP strategy so bots attack enemy players while traveling
+            if (!botAI->HasStrategy("pvp", BOT_STATE_NON_COMBAT))
             {
-                LOG_INFO("server.loading", "[City Siege] Cinematic phase ended, combat begins");
+                botAI->ChangeStrategy("+pvp", BOT_STATE_NON_COMBAT);
             }
             
-            // Determine the city faction
-            bool isAllianceCity = (event.cityId <= CITY_EXODAR);
+            // Initialize waypoint tracking for defenders
+            event.botWaypointProgress[botGuid] = { uint32(defenderWaypoint), SIEGE_MARCH_BACKWARD };
             
-            // Make creatures aggressive after cinematic phase
-            Map* map = sMapMgr->FindMap(city.mapId, 0);
-            if (map)
+            // Move bot toward a waypoint closer to spawn (backward movement) using playerbots travel system
+            if (defenderWaypoint > 0)
             {
-                for (const auto& guid : event.spawnedCreatures)
+                // Set travel destination using playerbots travel manager
+                TravelTarget* travelTarget = botAI->GetAiObjectContext()->GetValue<TravelTarget*>("travel target")->Get();
+                if (travelTarget)
                 {
-                    if (Creature* creature = map->GetCreature(guid))
-                    {
-                        // Set proper hostile faction: Horde attacks Alliance cities, Alliance attacks Horde cities
-                        creature->SetFaction(isAllianceCity ? 83 : 84); // 83 = Horde, 84 = Alliance
-                        
-                        // Set react state based on configuration
-                        if (g_AggroPlayers && g_AggroNPCs)
-                        {
-                            creature->SetReactState(REACT_AGGRESSIVE);
-                        }
-                        else if (g_AggroPlayers)
-                        {
-                            creature->SetReactState(REACT_DEFENSIVE);
-                        }
-                        else
-                        {
-                            creature->SetReactState(REACT_DEFENSIVE);
-                        }
-                        
-                        // Ensure creature is grounded and cannot fly
-                        creature->SetDisableGravity(false);
-                        creature->SetCanFly(false);
-                        creature->SetHover(false);
-                        creature->RemoveUnitMovementFlag(MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER);
-                        
-                        // Force creature to ground level before starting movement
-                        float creatureX = creature->GetPositionX();
-                        float creatureY = creature->GetPositionY();
-                        float creatureZ = creature->GetPositionZ();
-                        float groundZ = creature->GetMap()->GetHeight(creatureX, creatureY, creatureZ + 5.0f, true, 50.0f);
-                        
-                        if (groundZ > INVALID_HEIGHT)
-                        {
-                            creature->UpdateGroundPositionZ(creatureX, creatureY, groundZ);
-                            creature->Relocate(creatureX, creatureY, groundZ, creature->GetOrientation());
-                        }
-                        
-                        // Prevent return to home position after combat - clear motion master
-                        creature->SetWalk(false);
-                        creature->GetMotionMaster()->Clear(false);
-                        creature->GetMotionMaster()->MoveIdle();
-                        
-                        // Initialize waypoint progress for this creature
-                        event.creatureWaypointProgress[guid] = 0;
-                        
-                        // Determine first destination
-                        float destX, destY, destZ;
-                        if (!city.waypoints.empty())
-                        {
-                            // Start with first waypoint
-                            destX = city.waypoints[0].x;
-                            destY = city.waypoints[0].y;
-                            destZ = city.waypoints[0].z;
-                        }
-                        else
-                        {
-                            // No waypoints, go directly to leader
-                            destX = city.leaderX;
-                            destY = city.leaderY;
-                            destZ = city.leaderZ;
-                        }
-                        
-                        // Store original Z coordinate
-                        float waypointZ = destZ;
-                        
-                        // Randomize position within 5 yards to prevent bunching (X/Y only)
-                        Map* creatureMap = creature->GetMap();
-                        RandomizePosition(destX, destY, destZ, creatureMap, 5.0f);
-                        
-                        // Restore original Z to prevent underground pathing
-                        destZ = waypointZ;
-                        
-                        // Update home position before movement to prevent evading
-                        creature->SetHomePosition(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ(), creature->GetOrientation());
-                        
-                        // Use MoveSplineInit for proper pathfinding
-                        Movement::MoveSplineInit init(creature);
-                        init.MoveTo(destX, destY, destZ, true, true);
-                        init.SetWalk(false);
-                        init.Launch();
-                    }
+                    SetSiegeBotTravelTarget(event, travelTarget, defenderWaypoint - 1);
                 }
                 
-                // Initialize defenders - they move in REVERSE order through waypoints
-                for (const auto& guid : event.spawnedDefenders)
+                // Enable travel strategy for proper pathfinding
+                if (!botAI->HasStrategy("travel", BOT_STATE_NON_COMBAT))
                 {
-                    if (Creature* creature = map->GetCreature(guid))
-                    {
-                        // Set proper defender faction (same as city faction)
-                        creature->SetFaction(isAllianceCity ? 84 : 83); // 84 = Alliance, 83 = Horde
-                        creature->SetReactState(REACT_AGGRESSIVE);
-                        
-                        // Ensure creature is grounded
-                        creature->SetDisableGravity(false);
-                        creature->SetCanFly(false);
-                        creature->SetHover(false);
-                        creature->RemoveUnitMovementFlag(MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER);
-                        
-                        // Ground the creature
-                        float creatureX = creature->GetPositionX();
-                        float creatureY = creature->GetPositionY();
-                        float creatureZ = creature->GetPositionZ();
-                        float groundZ = creature->GetMap()->GetHeight(creatureX, creatureY, creatureZ + 5.0f, true, 50.0f);
-                        
-                        if (groundZ > INVALID_HEIGHT)
-                        {
-                            creature->UpdateGroundPositionZ(creatureX, creatureY, groundZ);
-                            creature->Relocate(creatureX, creatureY, groundZ, creature->GetOrientation());
-                        }
-                        
-                        creature->SetWalk(false);
-                        creature->GetMotionMaster()->Clear(false);
-                        creature->GetMotionMaster()->MoveIdle();
-                        
-                        // Defenders start at the LAST waypoint (highest index) and go backwards
-                        // Set progress to MAX so they start at the end
-                        uint32 startWaypoint = city.waypoints.empty() ? 0 : city.waypoints.size();
-                        event.creatureWaypointProgress[guid] = startWaypoint + 10000; // Add 10000 to mark as defender
-                        
-                        // Determine first destination (last waypoint, or spawn point if no waypoints)
-                        float destX, destY, destZ;
-                        if (!city.waypoints.empty())
-                        {
-                            // Start at last waypoint and move backwards
-                            destX = city.waypoints[city.waypoints.size() - 1].x;
-                            destY = city.waypoints[city.waypoints.size() - 1].y;
-                            destZ = city.waypoints[city.waypoints.size() - 1].z;
-                        }
-                        else
-                        {
-                            // No waypoints, go directly to spawn point
-                            destX = city.spawnX;
-                            destY = city.spawnY;
-                            destZ = city.spawnZ;
-                        }
-                        
-                        // Store original Z coordinate
-                        float waypointZ = destZ;
-                        
-                        // Randomize position to prevent bunching (X/Y only)
-                        Map* creatureMap = creature->GetMap();
-                        RandomizePosition(destX, destY, destZ, creatureMap, 5.0f);
-                        
-                        // Restore original Z to prevent underground pathing
-                        destZ = waypointZ;
-                        
-                        // Update home position
-                        creature->SetHomePosition(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ(), creature->GetOrientation());
-                        
-                        // Start movement
-                        Movement::MoveSplineInit init(creature);
-                        init.MoveTo(destX, destY, destZ, true, true);
-                        init.SetWalk(false);
-                        init.Launch();
-                    }
+                    botAI->ChangeStrategy("+travel", BOT_STATE_NON_COMBAT);
                 }
+                
+                // if (g_DebugMode)
+                // {
+                //     LOG_INFO("server.loading", "[City Siege] Defender bot {} flagged for PvP and traveling to waypoint {} [{:.2f}, {:.2f}, {:.2f}]",
+                //              bot->GetName(), defenderWaypoint - 1, targetWP.x, targetWP.y, targetWP.z);
+                // }
             }
         }
-
-        // Handle periodic yells
-        if ((currentTime - event.lastYellTime) >= g_YellFrequency)
+    }
+    
+    // Activate attacker bots - move them toward leader along waypoints
+    if (!city->waypoints.empty())
+    {
+        // Attackers start at spawn and move forward along waypoints toward leader
+        for (const auto& botGuid : event.attackerBots)
         {
-            event.lastYellTime = currentTime;
+            Player* bot = ObjectAccessor::FindPlayer(botGuid);
+            if (!bot || !bot->IsInWorld())
+                continue;
+                
+            PlayerbotAI* botAI = sPlayerbotsMgr->GetPlayerbotAI(bot);
+            if (!botAI)
+                continue;
             
-            const CityData& city = g_Cities[event.cityId];
-            Map* map = sMapMgr->FindMap(city.mapId, 0);
-            if (map)
-            {
-                // Make siege leaders yell
-                for (const auto& guid : event.spawnedCreatures)
-                {
-                    if (Creature* creature = map->GetCreature(guid))
-                    {
-                        uint32 entry = creature->GetEntry();
-                        // Only leaders and mini-bosses yell (and they must be alive)
-                        bool isLeader = (std::find(g_AllianceCityLeaders.begin(), g_AllianceCityLeaders.end(), entry) != g_AllianceCityLeaders.end()) ||
-                                       (std::find(g_HordeCityLeaders.begin(), g_HordeCityLeaders.end(), entry) != g_HordeCityLeaders.end());
-                        bool isMiniBoss = (entry == g_CreatureAllianceMiniBoss || entry == g_CreatureHordeMiniBoss);
-                        if (creature->IsAlive() && (isLeader || isMiniBoss))
-                        {
-                            // Parse combat yells from configuration (semicolon separated)
-                            std::vector<std::string> yells;
-                            std::string yellStr = g_YellsCombat;
-                            size_t pos = 0;
-                            while ((pos = yellStr.find(';')) != std::string::npos)
-                            {
-                                std::string yell = yellStr.substr(0, pos);
-                                if (!yell.empty())
-                                {
-                                    yells.push_back(yell);
-                                }
-                                yellStr.erase(0, pos + 1);
-                            }
-                            if (!yellStr.empty())
-                            {
-                                yells.push_back(yellStr);
-                            }
-                            
-                            if (!yells.empty())
+            // Enable PvP mode for siege combat
+            bot->SetPvP(true);
+            
+            // Remove away status to ensure bot is active
+            bot->RemovePlayerFlag(PLAYER_FLAGS_AFK);
+            
+            // Enable PvP strategy so bots attack enemy players while traveling
+            if (!botAI->HasStrategy("pvp", BOT_STATE_NON_COMBAT))
+            {
+                botAI->ChangeStrategy("+pvp", BOT_STATE_NON_COMBAT);
+            }
+            
+            // Initialize waypoint tracking for attackers (start at first waypoint)
+            event.botWaypointProgress[botGuid] = { 0, SIEGE_MARCH_FORWARD };
+            
+            // Move bot toward first waypoint using playerbots travel system
+            // Set travel destination using playerbots travel manager
+            TravelTarget* travelTarget = botAI->GetAiObjectContext()->GetValue<TravelTarget*>("travel target")->Get();
+            if (travelTarget)
+            {
+                SetSiegeBotTravelTarget(event, travelTarget, 0);
+            }
+            
+            // Enable travel strategy for proper pathfinding
+            if (!botAI->HasStrategy("travel", BOT_STATE_NON_COMBAT))
+            {
+                botAI->ChangeStrategy("+travel", BOT_STATE_NON_COMBAT);
+            }
+            
+            // if (g_DebugMode)
+            // {
+            //     LOG_INFO("server.loading", "[City Siege] Attacker bot {} flagged for PvP and traveling to waypoint 0 [{:.2f}, {:.2f}, {:.2f}]",
+            //              bot->GetName(), targetWP.x, targetWP.y, targetWP.z);
+            // }
+        }
+    }
+    
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Activated {} defender and {} attacker bots for siege on {}",
+                 event.defenderBots.size(), event.attackerBots.size(), city->name);
+    }
+#endif
+}
+
+/**
+ * @brief Deactivates siege combat mode for playerbots and releases them
+ * @param event The siege event
+ * @param maxCount Maximum number of bots to send back in this call, 0 for all remaining
+ * @return True once every bot has been released
+ * Stops combat, teleports bots back to original locations, and releases all participating bots
+ */
+bool DeactivatePlayerbotsFromSiege(SiegeEvent& event, uint32 maxCount = 0)
+{
+#ifdef MOD_PLAYERBOTS
+    if (!g_PlayerbotsEnabled)
+    {
+        return true;
+    }
+
+    // Bots still waiting for their teleport in stay where they are
+    event.pendingBotTeleports.clear();
+    event.nextBotTeleport = 0;
+
+    // Release the shared waypoint destinations - no bot may keep pointing at them
+    if (event.teardownCursor == 0 && !event.botDestinations.empty())
+    {
+        auto releaseTravelTarget = [](ObjectGuid botGuid)
+        {
+            Player* bot = ObjectAccessor::FindPlayer(botGuid);
+            PlayerbotAI* botAI = bot ? sPlayerbotsMgr->GetPlayerbotAI(bot) : nullptr;
+            if (!botAI)
+                return;
+
+            TravelTarget* travelTarget = botAI->GetAiObjectContext()->GetValue<TravelTarget*>("travel target")->Get();
+            if (travelTarget)
+            {
+                travelTarget->setTarget(sTravelMgr->nullTravelDestination, sTravelMgr->nullWorldPosition);
+                travelTarget->setForced(false);
+            }
+        };
+
+        for (const auto& botGuid : event.defenderBots)
+        {
+            releaseTravelTarget(botGuid);
+        }
+        for (const auto& botGuid : event.attackerBots)
+        {
+            releaseTravelTarget(botGuid);
+        }
+
+        for (const auto& dest : event.botDestinations)
+        {
+            delete dest.destination;
+            delete dest.position;
+        }
+        event.botDestinations.clear();
+    }
+    
+    // Teleport the bots back to their original positions, a batch per call
+    size_t total = event.botReturnPositions.size();
+    size_t end = maxCount ? std::min(total, event.teardownCursor + maxCount) : total;
+    for (; event.teardownCursor < end; ++event.teardownCursor)
+    {
+        const SiegeEvent::BotReturnPosition& returnPos = event.botReturnPositions[event.teardownCursor];
+        Player* bot = ObjectAccessor::FindPlayer(returnPos.botGuid);
+        if (!bot || !bot->IsInWorld())
+            continue;
+            
+        // Safety checks before teleporting
+        if (!bot->IsAlive())
+        {
+            if (g_DebugMode)
+            {
+                LOG_INFO("server.loading", "[City Siege] Skipping return for dead bot {}", bot->GetName());
+            }
+            continue;
+        }
+        
+        // Don't teleport if bot is in a dungeon, raid, arena, or battleground
+        if (bot->GetMap()->IsDungeon() || bot->GetMap()->IsRaid() || 
+            bot->GetMap()->IsBattleground() || bot->GetMap()->IsBattleArena())
+        {
+            if (g_DebugMode)
+            {
+                LOG_INFO("server.loading", "[City Siege] Skipping return for bot {} - currently in instance/raid/arena/bg", 
+                         bot->GetName());
+            }
+            continue;
+        }
+        
+        // Don't teleport if bot is being teleported or loading
+        if (bot->IsBeingTeleported())
+        {
+            if (g_DebugMode)
+            {
+                LOG_INFO("server.loading", "[City Siege] Skipping return for bot {} - already being teleported", 
+                         bot->GetName());
+            }
+            continue;
+        }
+        
+        // Stop combat first
+        bot->CombatStop(true);
+        
+        // Restore original PvP flag status
+        bot->SetPvP(returnPos.wasPvPFlagged);
+        
+        // Restore RPG strategy if bot had one
+        if (!returnPos.rpgStrategy.empty())
+        {
+            PlayerbotAI* botAI = sPlayerbotsMgr->GetPlayerbotAI(bot);
+            if (botAI)
+            {
+                botAI->ChangeStrategy("+" + returnPos.rpgStrategy, BOT_STATE_NON_COMBAT);
+                if (g_DebugMode)
+                {
+                    LOG_INFO("server.loading", "[City Siege] Restored '{}' strategy to bot {}", 
+                             returnPos.rpgStrategy, bot->GetName());
+                }
+            }
+        }
+        
+        // Teleport back to original position
+        bot->TeleportTo(returnPos.mapId, returnPos.x, returnPos.y, returnPos.z, returnPos.o);
+        
+        if (g_DebugMode)
+        {
+            LOG_INFO("server.loading", "[City Siege] Returned bot {} to original location (map {} at [{:.2f}, {:.2f}, {:.2f}]) and restored PvP flag to {}", 
+                     bot->GetName(), returnPos.mapId, returnPos.x, returnPos.y, returnPos.z, returnPos.wasPvPFlagged ? "ON" : "OFF");
+        }
+    }
+    
+    if (event.teardownCursor < total)
+    {
+        return false;
+    }
+    event.teardownCursor = 0;
+
+    // Clear all bot tracking data
+    for (const auto& botGuid : event.defenderBots)
+    {
+        event.unitIndex.erase(botGuid);
+    }
+    for (const auto& botGuid : event.attackerBots)
+    {
+        event.unitIndex.erase(botGuid);
+    }
+
+    event.defenderBots.clear();
+    event.attackerBots.clear();
+    event.deadBots.clear();
+    event.botReturnPositions.clear();
+    
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Deactivated all playerbots from siege and returned them to original locations");
+    }
+#endif
+    return true;
+}
+
+/**
+ * @brief Searches the throne area for the city leader (grid scan).
+ * @param city The city whose leader to find.
+ * @param map The city map.
+ * @param aliveOnly Only accept a living leader.
+ * @return The leader, or nullptr if none is in range.
+ */
+Creature* FindSiegeCityLeader(CityData const& city, Map* map, bool aliveOnly)
+{
+    std::list<Creature*> leaderList;
+    CitySiege::CreatureEntryCheck check(city.targetLeaderEntry);
+    CitySiege::SimpleCreatureListSearcher<CitySiege::CreatureEntryCheck> searcher(leaderList, check);
+    Cell::VisitObjects(city.leaderX, city.leaderY, map, searcher, 100.0f);
+
+    for (Creature* leader : leaderList)
+    {
+        if (leader && (!aliveOnly || leader->IsAlive()))
+        {
+            return leader;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Returns the city leader of a siege by its stored GUID.
+ * Falls back to a throttled grid scan only if the GUID is missing or stale
+ * (leader not found at siege start, or its grid was unloaded).
+ * @param event The siege event.
+ * @param map The city map.
+ * @return The leader, or nullptr if it cannot be found right now.
+ */
+Creature* GetSiegeCityLeader(SiegeEvent& event, Map* map)
+{
+    if (event.cityLeaderGuid)
+    {
+        if (Creature* leader = map->GetCreature(event.cityLeaderGuid))
+        {
+            return leader;
+        }
+    }
+
+    uint32 currentTime = time(nullptr);
+    if (currentTime < event.nextLeaderScan)
+    {
+        return nullptr;
+    }
+    event.nextLeaderScan = currentTime + 10;
+
+    Creature* leader = FindSiegeCityLeader(GetSiegeCity(event), map, false);
+    if (leader)
+    {
+        if (g_DebugMode && leader->GetGUID() != event.cityLeaderGuid)
+        {
+            LOG_INFO("server.loading", "[City Siege] City leader of {} re-resolved: {} -> {}",
+                     GetSiegeCity(event).name, event.cityLeaderGuid.ToString(), leader->GetGUID().ToString());
+        }
+        event.cityLeaderGuid = leader->GetGUID();
+    }
+    return leader;
+}
+
+/**
+ * @brief Starts a new siege event.
+ * @param targetCityId Optional specific city to siege. If -1, selects random city.
+ */
+void StartSiegeEvent(int targetCityId = -1)
+{
+    if (!g_CitySiegeEnabled)
+    {
+        return;
+    }
+
+    // Check if we can start a new siege
+    if (!g_AllowMultipleCities && !g_ActiveSieges.empty())
+    {
+        // Check if any siege is still active
+        for (const auto& siege : g_ActiveSieges)
+        {
+            if (siege.isActive)
+            {
+                return; // Cannot start new siege
+            }
+        }
+    }
+
+    const CityData* city = nullptr;
+    
+    // If specific city requested, use it
+    if (targetCityId >= 0 && targetCityId < int(g_Config->cities.size()))
+    {
+        city = &g_Config->cities[targetCityId];
+        
+        // Check if city is enabled
+        if (!g_Config->cityEnabled.test(city->id))
+        {
+            if (g_DebugMode)
+            {
+                LOG_INFO("server.loading", "[City Siege] Cannot start siege - {} is disabled", city->name);
+            }
+            return;
+        }
+    }
+    else
+    {
+        // Select random city
+        city = SelectRandomCity();
+    }
+    
+    if (!city)
+    {
+        if (g_DebugMode)
+        {
+            LOG_INFO("server.loading", "[City Siege] No available cities for siege event");
+        }
+        return;
+    }
+
+    uint32 currentTime = time(nullptr);
+    SiegeEvent newEvent;
+    newEvent.cityId = city->id;
+    newEvent.config = g_Config;
+    newEvent.startTime = currentTime;
+    newEvent.endTime = currentTime + g_EventDuration;
+    newEvent.isActive = true;
+    newEvent.cinematicPhase = true;
+    newEvent.lastYellTime = currentTime;
+    newEvent.lastStatusAnnouncement = currentTime;
+    newEvent.cinematicStartTime = currentTime;
+    newEvent.countdown75Announced = false;
+    newEvent.countdown50Announced = false;
+    newEvent.countdown25Announced = false;
+    newEvent.rpScriptIndex = 0; // Start RP script at first line
+    newEvent.weatherOverridden = false; // Initialize weather override flag
+    
+    // First, find and store the city leader's GUID and name
+    Map* map = sMapMgr->FindMap(city->mapId, 0);
+    if (map)
+    {
+        if (Creature* leader = FindSiegeCityLeader(*city, map, true))
+        {
+            newEvent.cityLeaderGuid = leader->GetGUID();
+            newEvent.cityLeaderName = leader->GetName();
+
+            if (g_DebugMode)
+            {
+                LOG_INFO("server.loading", "[City Siege] Found city leader: {} (Entry: {}, GUID: {})",
+                         leader->GetName(), city->targetLeaderEntry, leader->GetGUID().ToString());
+            }
+        }
+        
+        if (!newEvent.cityLeaderGuid)
+        {
+            LOG_ERROR("server.loading", "[City Siege] WARNING: Could not find city leader for {} (Entry: {}). Defenders will auto-win!",
+                     city->name, city->targetLeaderEntry);
+        }
+    }
+    
+    // Resolve the siege messages and a random RP script for this siege (compiled at config load)
+    bool isAllianceCity = IsAllianceCity(*city);
+    std::string leaderName = newEvent.cityLeaderName.empty() ? "the leader" : newEvent.cityLeaderName;
+    newEvent.startMessage = ResolveSiegeText(g_MessageSiegeStartTemplate, city->name, leaderName);
+    newEvent.endMessage = ResolveSiegeText(g_MessageSiegeEndTemplate, city->name, leaderName);
+    
+    const std::vector<std::vector<SiegeTextTemplate>>& availableScripts = isAllianceCity ? g_RPScriptTemplatesHorde : g_RPScriptTemplatesAlliance;
+    if (!availableScripts.empty())
+    {
+        uint32 randomScriptIndex = urand(0, availableScripts.size() - 1);
+        for (const SiegeTextTemplate& line : availableScripts[randomScriptIndex])
+        {
+            newEvent.activeRPScript.push_back(ResolveSiegeText(line, city->name, leaderName));
+        }
+        
+        if (g_DebugMode)
+        {
+            LOG_INFO("server.loading", "[City Siege] Selected RP script {} with {} lines for {} (Leader: {})",
+                     randomScriptIndex + 1, newEvent.activeRPScript.size(), city->name, 
+                     newEvent.cityLeaderName.empty() ? "NOT FOUND" : newEvent.cityLeaderName);
+        }
+    }
+
+    // Announce siege is coming (before RP phase)
+    const std::string& preAnnounce = RenderSiegeMessage(newEvent, SIEGE_MSG_PRE_ANNOUNCE, g_CinematicDelay, [&](auto out)
+    {
+        fmt::format_to(out, "|cffff0000[City Siege]|r |cffFFFF00WARNING!|r A siege force is preparing to attack {}! "
+            "The battle will begin in {} seconds. Defenders, prepare yourselves!", city->name, g_CinematicDelay);
+    });
+    sWorldSessionMgr->SendServerMessage(SERVER_MSG_STRING, preAnnounce);
+
+    g_ActiveSieges.push_back(newEvent);
+
+    // Size the army for the current load and the players around the city
+    RefreshSiegeParticipants(g_ActiveSieges.back());
+    g_ActiveSieges.back().armyScale = ComputeSiegeArmyScale(g_ActiveSieges.back().realParticipants);
+
+    // Set siege weather during RP phase
+    SetSiegeWeather(*city, g_ActiveSieges.back());
+
+#ifdef MOD_PLAYERBOTS
+    // Recruit playerbots if enabled
+    if (g_PlayerbotsEnabled)
+    {
+        SiegeEvent& siege = g_ActiveSieges.back();
+        siege.defenderBots = RecruitDefendingPlayerbots(*city, siege);
+        siege.attackerBots = RecruitAttackingPlayerbots(*city, siege);
+
+        // Index the recruited bots so the death hook can find them
+        for (const auto& botGuid : siege.defenderBots)
+        {
+            siege.unitIndex[botGuid] = { 0, true, true };
+        }
+        for (const auto& botGuid : siege.attackerBots)
+        {
+            siege.unitIndex[botGuid] = { 0, false, true };
+        }
+    }
+#endif
+
+    AnnounceSiege(g_ActiveSieges.back(), true);
+    SpawnSiegeCreatures(g_ActiveSieges.back());
+
+    // Play RP phase music if enabled
+    if (g_MusicEnabled && g_RPMusicId > 0)
+    {
+        // Send music to players within announce radius
+        PlaySiegeMusic(g_ActiveSieges.back(), g_RPMusicId);
+        
+        if (g_DebugMode)
+        {
+            LOG_INFO("server.loading", "[City Siege] Playing RP phase music (ID: {}) for siege of {}", g_RPMusicId, city->name);
+        }
+    }
+
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Started siege event at {}", city->name);
+    }
+}
+
+/**
+ * @brief Ends an active siege event.
+ * @param event The siege event to end.
+ */
+void EndSiegeEvent(SiegeEvent& event, int winningTeam = -1)
+{
+    if (!event.isActive)
+    {
+        return;
+    }
+
+    const CityData& city = GetSiegeCity(event);
+    event.isActive = false;
+
+    // Check if defenders won (city leader still alive)
+    bool defendersWon = false;
+    bool leaderKilled = false;
+    Map* map = sMapMgr->FindMap(city.mapId, 0);
+    event.nextLeaderScan = 0; // The outcome must not depend on the scan throttle
+    Creature* cityLeader = (map && event.cityLeaderGuid) ? GetSiegeCityLeader(event, map) : nullptr;
+    
+    if (map && event.cityLeaderGuid)
+    {
+        if (cityLeader && cityLeader->IsAlive() && !event.cityLeaderKilled)
+        {
+            defendersWon = true;
+            
+            if (g_DebugMode)
+            {
+                LOG_INFO("server.loading", "[City Siege] City leader {} is alive. Defenders win!",
+                         cityLeader->GetName());
+            }
+        }
+        else
+        {
+            leaderKilled = true;
+            
+            if (g_DebugMode)
+            {
+                if (cityLeader)
+                {
+                    LOG_INFO("server.loading", "[City Siege] City leader {} is dead. Attackers win!",
+                             cityLeader->GetName());
+                }
+                else
+                {
+                    LOG_INFO("server.loading", "[City Siege] City leader GUID {} not found (despawned?). Attackers win!",
+                             event.cityLeaderGuid.ToString());
+                }
+            }
+        }
+    }
+    else
+    {
+        // No leader GUID stored or no map - defenders win by default
+        defendersWon = true;
+        
+        if (g_DebugMode)
+        {
+            LOG_INFO("server.loading", "[City Siege] No city leader GUID stored. Defenders win by default.");
+        }
+    }
+    
+    // If winningTeam was explicitly passed (GM command), override the result
+    if (winningTeam != -1)
+    {
+        defendersWon = false;
+        leaderKilled = true;
+        
+        if (g_DebugMode)
+        {
+            LOG_INFO("server.loading", "[City Siege] GM override: winningTeam = {}", winningTeam);
+        }
+    }
+
+    // Pick up everyone who came to watch the final moments before announcing and rewarding
+    RefreshSiegeParticipants(event);
+    if (g_TelemetryEnabled)
+    {
+        SampleSiegeTelemetry(event, time(nullptr));
+    }
+    AnnounceSiege(event, false);
+
+    // Restore original weather
+    RestoreSiegeWeather(city, event);
+
+    // Announce the winner (using same logic as AnnounceSiege)
+    const std::string& winnerAnnouncement = RenderSiegeMessage(event, SIEGE_MSG_RESULT, defendersWon ? 1 : 0, [&](auto out)
+    {
+        if (defendersWon)
+        {
+            // Defenders won - announce defending faction victory
+            fmt::format_to(out, "|cff00ff00[City Siege]|r The {} has successfully defended {}! Victory to the defenders!",
+                g_SiegeFactions[city.team].name, city.name);
+        }
+        else
+        {
+            // Attackers won (city leader killed) - announce attacking faction victory
+            fmt::format_to(out, "|cffff0000[City Siege]|r The {} has conquered {}! The city has fallen!",
+                g_SiegeFactions[GetSiegeAttackingTeam(city)].name, city.name);
+        }
+    });
+    
+    // Send announcement (same logic as AnnounceSiege)
+    SendSiegeMessage(event, winnerAnnouncement);
+    
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] {}", winnerAnnouncement);
+    }
+
+    // Play victory or defeat music if enabled
+    if (g_MusicEnabled)
+    {
+        if (defendersWon && g_VictoryMusicId > 0)
+        {
+            // Send victory music to players within announce radius
+            PlaySiegeMusic(event, g_VictoryMusicId);
+            
+            if (g_DebugMode)
+            {
+                LOG_INFO("server.loading", "[City Siege] Playing victory music (ID: {}) for defenders' victory at {}", g_VictoryMusicId, city.name);
+            }
+        }
+        else if (!defendersWon && g_DefeatMusicId > 0)
+        {
+            // Send defeat music to players within announce radius
+            PlaySiegeMusic(event, g_DefeatMusicId);
+            
+            if (g_DebugMode)
+            {
+                LOG_INFO("server.loading", "[City Siege] Playing defeat music (ID: {}) for attackers' victory at {}", g_DefeatMusicId, city.name);
+            }
+        }
+    }
+
+    // Defenders won - reward defending faction (0 = Alliance, 1 = Horde),
+    // attackers won (city leader killed) - reward attacking faction
+    BeginSiegeResult(event, defendersWon ? city.team : GetSiegeAttackingTeam(city), defendersWon);
+
+    // Respawn city leader if they were killed during the siege
+    if (leaderKilled && map)
+    {
+        // The leader resolved above, or a throne search if there was no GUID to go by
+        Creature* existingLeader = cityLeader ? cityLeader : FindSiegeCityLeader(city, map, false);
+        
+        // Respawn the leader
+        if (existingLeader)
+        {
+            if (!existingLeader->IsAlive())
+            {
+                existingLeader->Respawn();
+                
+                if (g_DebugMode)
+                {
+                    LOG_INFO("server.loading", "[City Siege] Respawned city leader {} (entry {}) at {}", 
+                             city.name, city.targetLeaderEntry, existingLeader->GetName());
+                }
+            }
+        }
+        else
+        {
+            // Leader doesn't exist in world - log warning
+            if (g_DebugMode)
+            {
+                LOG_WARN("server.loading", "[City Siege] Could not find city leader {} (entry {}) to respawn!", 
+                         city.name, city.targetLeaderEntry);
+            }
+        }
+    }
+
+    // Despawning, rewards and sending the bots home are spread over the next ticks
+    event.teardownStage = SIEGE_TEARDOWN_DESPAWN;
+    event.teardownCursor = 0;
+
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Ended siege event at {} - {} won", 
+                 city.name, defendersWon ? "Defenders" : "Attackers");
+    }
+}
+
+/**
+ * @brief Mails the gold reward to a participant who logged out before the rewards were handed out.
+ * Honor cannot be granted to an offline character, so only the gold is sent. The mail goes into
+ * the siege's result transaction and is saved together with the results row.
+ * @param event The ended siege event.
+ * @param guid GUID of the offline participant.
+ * @param city The city of the siege.
+ * @param winningTeam The team ID to reward (0=Alliance, 1=Horde, -1=all players)
+ * @return True if a reward was mailed.
+ */
+bool MailSiegeReward(SiegeEvent& event, ObjectGuid guid, const CityData& city, int winningTeam)
+{
+    if (!g_RewardMailOffline || !event.resultTransaction)
+    {
+        return false;
+    }
+
+    CharacterCacheEntry const* character = sCharacterCache->GetCharacterCacheByGuid(guid);
+    if (!character)
+    {
+        return false;
+    }
+
+    if (winningTeam != -1 && Player::TeamIdForRace(character->Race) != winningTeam)
+    {
+        return false;
+    }
+
+    if (character->Level < g_MinimumLevel)
+    {
+        return false;
+    }
+
+    uint32 goldAwarded = g_RewardGoldBase + (g_RewardGoldPerLevel * character->Level);
+    if (goldAwarded == 0)
+    {
+        return false;
+    }
+
+    MailDraft("City Siege Reward", "Your reward for the siege of " + city.name + ". You had left before it could be handed out.")
+        .AddMoney(goldAwarded)
+        .SendMailTo(event.resultTransaction, MailReceiver(guid.GetCounter()), MailSender(MAIL_NORMAL, 0, MAIL_STATIONERY_DEFAULT));
+
+    event.moneyAwarded += goldAwarded;
+    event.mailedRewards++;
+    return true;
+}
+
+/**
+ * @brief Rewards one siege participant if they qualify.
+ * Honor and money only change the player in memory; they are saved with the player as usual.
+ * Participants who have logged out since are mailed their gold instead (see MailSiegeReward).
+ * @param event The ended siege event, which collects the reward totals.
+ * @param guid GUID of the participant.
+ * @param city The city of the siege.
+ * @param winningTeam The team ID to reward (0=Alliance, 1=Horde, -1=all players)
+ * @return True if the player was rewarded.
+ */
+bool RewardSiegeParticipant(SiegeEvent& event, ObjectGuid guid, const CityData& city, int winningTeam)
+{
+    Player* player = ObjectAccessor::FindConnectedPlayer(guid);
+    if (!player)
+    {
+        return MailSiegeReward(event, guid, city, winningTeam);
+    }
+
+    if (!player->IsInWorld() || player->GetMapId() != city.mapId)
+    {
+        return false;
+    }
+
+    // If winningTeam is specified, only reward players of that faction
+    if (winningTeam != -1 && player->GetTeamId() != winningTeam)
+    {
+        return false;
+    }
+
+    // Check if player is of appropriate level
+    if (player->GetLevel() < g_MinimumLevel)
+    {
+        return false;
+    }
+
+    uint32 honorAwarded = 0;
+    uint32 goldAwarded = 0;
+    
+    // Award honor
+    if (g_RewardHonor > 0)
+    {
+        player->RewardHonor(nullptr, 1, g_RewardHonor);
+        honorAwarded = g_RewardHonor;
+    }
+    
+    // Award gold scaled by player level
+    if (g_RewardGoldBase > 0 || g_RewardGoldPerLevel > 0)
+    {
+        goldAwarded = g_RewardGoldBase + (g_RewardGoldPerLevel * player->GetLevel());
+        player->ModifyMoney(goldAwarded);
+    }
+
+    event.honorAwarded += honorAwarded;
+    event.moneyAwarded += goldAwarded;
+    
+    // Send detailed confirmation message with rewards
+    char rewardMsg[512];
+    uint32 goldCoins = goldAwarded / 10000;
+    uint32 silverCoins = (goldAwarded % 10000) / 100;
+    uint32 copperCoins = goldAwarded % 100;
+    
+    if (honorAwarded > 0 && goldAwarded > 0)
+    {
+        // Both honor and gold
+        if (goldCoins > 0)
+        {
+            snprintf(rewardMsg, sizeof(rewardMsg), 
+                "|cff00ff00[City Siege]|r You have been rewarded for defending %s! Received: |cffFFD700%u Honor|r and |cffFFD700%ug %us %uc|r",
+                city.name.c_str(), honorAwarded, goldCoins, silverCoins, copperCoins);
+        }
+        else if (silverCoins > 0)
+        {
+            snprintf(rewardMsg, sizeof(rewardMsg), 
+                "|cff00ff00[City Siege]|r You have been rewarded for defending %s! Received: |cffFFD700%u Honor|r and |cffFFD700%us %uc|r",
+                city.name.c_str(), honorAwarded, silverCoins, copperCoins);
+        }
+        else
+        {
+            snprintf(rewardMsg, sizeof(rewardMsg), 
+                "|cff00ff00[City Siege]|r You have been rewarded for defending %s! Received: |cffFFD700%u Honor|r and |cffFFD700%uc|r",
+                city.name.c_str(), honorAwarded, copperCoins);
+        }
+    }
+    else if (honorAwarded > 0)
+    {
+        // Only honor
+        snprintf(rewardMsg, sizeof(rewardMsg), 
+            "|cff00ff00[City Siege]|r You have been rewarded for defending %s! Received: |cffFFD700%u Honor|r",
+            city.name.c_str(), honorAwarded);
+    }
+    else if (goldAwarded > 0)
+    {
+        // Only gold
+        if (goldCoins > 0)
+        {
+            snprintf(rewardMsg, sizeof(rewardMsg), 
+                "|cff00ff00[City Siege]|r You have been rewarded for defending %s! Received: |cffFFD700%ug %us %uc|r",
+                city.name.c_str(), goldCoins, silverCoins, copperCoins);
+        }
+        else if (silverCoins > 0)
+        {
+            snprintf(rewardMsg, sizeof(rewardMsg), 
+                "|cff00ff00[City Siege]|r You have been rewarded for defending %s! Received: |cffFFD700%us %uc|r",
+                city.name.c_str(), silverCoins, copperCoins);
+        }
+        else
+        {
+            snprintf(rewardMsg, sizeof(rewardMsg), 
+                "|cff00ff00[City Siege]|r You have been rewarded for defending %s! Received: |cffFFD700%uc|r",
+                city.name.c_str(), copperCoins);
+        }
+    }
+    else
+    {
+        // No rewards configured
+        snprintf(rewardMsg, sizeof(rewardMsg), 
+            "|cff00ff00[City Siege]|r You have been rewarded for defending %s!",
+            city.name.c_str());
+    }
+    
+    ChatHandler(player->GetSession()).PSendSysMessage(rewardMsg);
+    return true;
+}
+
+/**
+ * @brief Distributes rewards to players who defended the city.
+ * @param event The siege event that ended.
+ * @param city The city that was defended.
+ * @param winningTeam The team ID to reward (0=Alliance, 1=Horde, -1=all players)
+ */
+void DistributeRewards(SiegeEvent& event, const CityData& city, int winningTeam)
+{
+    // Only the siege participants (players within the announce radius) are rewarded
+    for (const ObjectGuid& guid : event.participants)
+    {
+        if (RewardSiegeParticipant(event, guid, city, winningTeam))
+        {
+            event.rewardedPlayers++;
+        }
+    }
+    
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Rewarded {} players for the siege of {}", 
+                 event.rewardedPlayers, city.name);
+    }
+}
+
+/**
+ * @brief Records the outcome of a siege that just ended and opens the transaction that
+ * collects its reward mails and results row.
+ * @param event The ended siege event.
+ * @param winningTeam The winning team (0=Alliance, 1=Horde), which is also the team rewarded.
+ * @param defendersWon True if the city held.
+ */
+void BeginSiegeResult(SiegeEvent& event, int winningTeam, bool defendersWon)
+{
+    event.rewardTeam = winningTeam;
+    event.defendersWon = defendersWon;
+    event.endedAt = time(nullptr);
+    event.rewardedPlayers = 0;
+    event.honorAwarded = 0;
+    event.moneyAwarded = 0;
+    event.mailedRewards = 0;
+    event.resultTransaction = CharacterDatabase.BeginTransaction();
+}
+
+/**
+ * @brief Adds the results row of an ended siege to its result transaction and commits it.
+ * The commit is asynchronous: the database worker writes the reward mails and the row in
+ * one transaction, off the world update.
+ * @param event The ended siege event.
+ */
+void SaveSiegeResult(SiegeEvent& event)
+{
+    if (!event.resultTransaction)
+    {
+        return;
+    }
+
+    if (g_ResultsEnabled)
+    {
+        std::string cityName = GetSiegeCity(event).name;
+        CharacterDatabase.EscapeString(cityName);
+
+        event.resultTransaction->Append(
+            "INSERT INTO `city_siege_results` (`city_id`, `city_name`, `start_time`, `end_time`, `winner_team`, `defenders_won`, "
+            "`participants`, `attacker_deaths`, `defender_deaths`, `rewarded_players`, `mailed_rewards`, `honor_awarded`, `money_awarded`) "
+            "VALUES ({}, '{}', {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {})",
+            uint32(event.cityId), cityName, event.startTime, event.endedAt, event.rewardTeam, event.defendersWon ? 1 : 0,
+            event.participants.size(), event.attackerDeaths.Get(), event.defenderDeaths.Get(), event.rewardedPlayers,
+            event.mailedRewards, event.honorAwarded, event.moneyAwarded);
+    }
+
+    CharacterDatabase.CommitTransaction(event.resultTransaction);
+    event.resultTransaction = nullptr;
+
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Saved the results of the siege of {} ({} rewards mailed)",
+                 GetSiegeCity(event).name, event.mailedRewards);
+    }
+}
+
+/**
+ * @brief Runs one tick of the teardown of an ended siege: despawning the army, rewarding
+ * the winners, then sending the playerbots home, CitySiege.Scheduler.TeardownBatch at a time.
+ * @param event The ended siege event.
+ */
+void UpdateSiegeTeardown(SiegeEvent& event)
+{
+    const CityData& city = GetSiegeCity(event);
+
+    switch (event.teardownStage)
+    {
+        case SIEGE_TEARDOWN_DESPAWN:
+            if (DespawnSiegeCreatures(event, g_TeardownBatch))
+            {
+                if (g_RewardOnDefense)
+                {
+                    event.teardownStage = SIEGE_TEARDOWN_REWARDS;
+                }
+                else
+                {
+                    SaveSiegeResult(event);
+                    event.teardownStage = SIEGE_TEARDOWN_BOTS;
+                }
+            }
+            break;
+        case SIEGE_TEARDOWN_REWARDS:
+        {
+            size_t total = event.participants.size();
+            size_t end = g_TeardownBatch ? std::min(total, event.teardownCursor + g_TeardownBatch) : total;
+            for (; event.teardownCursor < end; ++event.teardownCursor)
+            {
+                if (RewardSiegeParticipant(event, event.participants[event.teardownCursor], city, event.rewardTeam))
+                {
+                    event.rewardedPlayers++;
+                }
+            }
+
+            if (event.teardownCursor >= total)
+            {
+                event.teardownCursor = 0;
+                event.teardownStage = SIEGE_TEARDOWN_BOTS;
+                SaveSiegeResult(event);
+
+                if (g_DebugMode)
+                {
+                    LOG_INFO("server.loading", "[City Siege] Rewarded {} players for the siege of {}",
+                             event.rewardedPlayers, city.name);
+                }
+            }
+            break;
+        }
+        case SIEGE_TEARDOWN_BOTS:
+            if (DeactivatePlayerbotsFromSiege(event, g_TeardownBatch))
+            {
+                event.teardownStage = SIEGE_TEARDOWN_DONE;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+#ifdef MOD_PLAYERBOTS
+/**
+ * @brief Processes bot respawns after delay expires
+ * @param event The siege event
+ */
+void ProcessBotRespawns(SiegeEvent& event)
+{
+    if (!g_PlayerbotsEnabled || event.deadBots.empty())
+        return;
+        
+    uint32 currentTime = time(nullptr);
+    const CityData& city = GetSiegeCity(event);
+    Map* cityMap = sMapMgr->FindMap(city.mapId, 0);
+    
+    // Only pop the bots whose respawn delay has expired - the queue is ordered by due time
+    std::vector<SiegeEvent::BotRespawnData> retryLater;
+    SiegeEvent::BotRespawnData respawnData;
+    while (PopDueRespawnEntry(event.deadBots, currentTime, respawnData))
+    {
+        Player* bot = ObjectAccessor::FindPlayer(respawnData.botGuid);
+
+        // If the Player object is not present or not in world anymore, keep the entry and try again later
+        if (!bot || !bot->IsInWorld())
+        {
+            respawnData.respawnTime = currentTime + 1;
+            retryLater.push_back(respawnData);
+            continue;
+        }
+
+        // This runs from the city map's update: a bot that is on another map (relogged, teleported away)
+        // belongs to another thread and is left alone until it is back
+        if (bot->GetMap() != cityMap)
+        {
+            respawnData.respawnTime = currentTime + 5;
+            retryLater.push_back(respawnData);
+            continue;
+        }
+
+        // Determine desired respawn position depending on faction
+        float desiredX, desiredY, desiredZ;
+        if (respawnData.isDefender)
+        {
+            desiredX = city.leaderX;
+            desiredY = city.leaderY;
+            desiredZ = city.leaderZ;
+        }
+        else
+        {
+            desiredX = city.spawnX;
+            desiredY = city.spawnY;
+            desiredZ = city.spawnZ;
+        }
+
+        // If bot is alive already, check whether it's at the correct location (not a graveyard)
+        if (bot->IsAlive())
+        {
+            float distToDesired = bot->GetDistance2d(desiredX, desiredY);
+            // If bot is already close to desired respawn location, consider it handled
+            if (distToDesired <= 15.0f)
+            {
+                continue;
+            }
+            // Otherwise fall through and force-teleport/reissue movement so the bot goes to the siege spawn/leader
+        }
+        else
+        {
+            // Bot is dead: resurrect now
+            bot->ResurrectPlayer(1.0f); // Full health and mana
+            bot->SpawnCorpseBones();
+            event.respawns.Add();
+        }
+
+        // Ensure bot is active and participating
+        bot->RemovePlayerFlag(PLAYER_FLAGS_AFK);
+        bot->SetPvP(true);
+
+        // Teleport to desired spawn/leader position with small randomization
+        float angle = frand(0.0f, 2.0f * M_PI);
+        float distance = frand(0.0f, 10.0f);
+        float respawnX = desiredX + distance * std::cos(angle);
+        float respawnY = desiredY + distance * std::sin(angle);
+        bot->TeleportTo(city.mapId, respawnX, respawnY, desiredZ, 0.0f);
+
+        // Reinitialize waypoint/travel progress depending on defender/attacker
+        PlayerbotAI* botAI = sPlayerbotsMgr->GetPlayerbotAI(bot);
+        if (respawnData.isDefender)
+        {
+            if (!city.waypoints.empty())
+            {
+                size_t defenderWaypoint = city.waypoints.size() - 1;
+                event.botWaypointProgress[respawnData.botGuid] = { uint32(defenderWaypoint), SIEGE_MARCH_BACKWARD };
+
+                if (defenderWaypoint > 0 && botAI)
+                {
+                    TravelTarget* travelTarget = botAI->GetAiObjectContext()->GetValue<TravelTarget*>("travel target")->Get();
+                    if (travelTarget)
+                    {
+                        SetSiegeBotTravelTarget(event, travelTarget, defenderWaypoint - 1);
+                    }
+
+                    if (!botAI->HasStrategy("travel", BOT_STATE_NON_COMBAT))
+                        botAI->ChangeStrategy("+travel", BOT_STATE_NON_COMBAT);
+                }
+            }
+        }
+        else
+        {
+            if (!city.waypoints.empty())
+            {
+                event.botWaypointProgress[respawnData.botGuid] = { 0, SIEGE_MARCH_FORWARD };
+                if (botAI)
+                {
+                    TravelTarget* travelTarget = botAI->GetAiObjectContext()->GetValue<TravelTarget*>("travel target")->Get();
+                    if (travelTarget)
+                    {
+                        SetSiegeBotTravelTarget(event, travelTarget, 0);
+                    }
+
+                    if (!botAI->HasStrategy("travel", BOT_STATE_NON_COMBAT))
+                        botAI->ChangeStrategy("+travel", BOT_STATE_NON_COMBAT);
+                }
+            }
+        }
+
+        // Put back into combat state
+        bot->SetInCombatState(true);
+    }
+
+    for (const auto& retry : retryLater)
+    {
+        PushRespawnEntry(event.deadBots, retry);
+    }
+}
+
+/**
+ * @brief Updates bot waypoint movement during siege
+ * @param event The siege event
+ * Moves bots along waypoints when they reach their destination
+ */
+void UpdateBotWaypointMovement(SiegeEvent& event)
+{
+    if (!g_PlayerbotsEnabled)
+        return;
+        
+    const CityData& city = GetSiegeCity(event);
+    
+    if (city.waypoints.empty())
+        return;
+    
+    // Update defender bot movement (move backward along waypoints toward spawn)
+    for (const auto& botGuid : event.defenderBots)
+    {
+        Player* bot = ObjectAccessor::FindPlayer(botGuid);
+        // Bots elsewhere belong to another map's update thread
+        if (!bot || !bot->IsInWorld() || !bot->IsAlive() || bot->GetMapId() != city.mapId)
+            continue;
+        
+        // Check if bot has reached their waypoint
+        auto wpIter = event.botWaypointProgress.find(botGuid);
+        if (wpIter == event.botWaypointProgress.end())
+            continue;
+        
+        uint32 currentWP = wpIter->second.waypoint;
+        
+        // Always ensure bot has an active travel target if not at final destination
+        PlayerbotAI* botAI = sPlayerbotsMgr->GetPlayerbotAI(bot);
+        if (botAI)
+        {
+            TravelTarget* travelTarget = botAI->GetAiObjectContext()->GetValue<TravelTarget*>("travel target")->Get();
+            if (travelTarget)
+            {
+                // For defenders: if not at spawn (waypoint 0) and not currently traveling, set next waypoint
+                if (currentWP > 0 && !travelTarget->isTraveling())
+                {
+                    SetSiegeBotTravelTarget(event, travelTarget, currentWP - 1);
+                }
+                
+                // Check if bot reached current target waypoint by distance
+                if (currentWP > 0)
+                {
+                    const Waypoint& targetWP = city.waypoints[currentWP - 1];
+                    // Use full 3D distance to account for small Z differences between config and actual ground
+                    float dist = bot->GetDistance(targetWP.x, targetWP.y, targetWP.z);
+
+                    // If bot is within 10 yards of target waypoint, advance immediately
+                    if (dist <= 10.0f)
+                    {
+                        currentWP--;
+                        wpIter->second.waypoint = currentWP;
+
+
+                        // Immediately set next waypoint if not at spawn
+                        if (currentWP > 0)
+                        {
+                            SetSiegeBotTravelTarget(event, travelTarget, currentWP - 1);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    
+    // Update attacker bot movement (move forward along waypoints toward leader)
+    for (const auto& botGuid : event.attackerBots)
+    {
+        Player* bot = ObjectAccessor::FindPlayer(botGuid);
+        // Bots elsewhere belong to another map's update thread
+        if (!bot || !bot->IsInWorld() || !bot->IsAlive() || bot->GetMapId() != city.mapId)
+            continue;
+        
+        // Check if bot has reached their waypoint
+        auto wpIter = event.botWaypointProgress.find(botGuid);
+        if (wpIter == event.botWaypointProgress.end())
+            continue;
+        
+        uint32 currentWP = wpIter->second.waypoint;
+        
+        // Always ensure bot has an active travel target if not at final destination
+        PlayerbotAI* botAI = sPlayerbotsMgr->GetPlayerbotAI(bot);
+        if (botAI)
+        {
+            TravelTarget* travelTarget = botAI->GetAiObjectContext()->GetValue<TravelTarget*>("travel target")->Get();
+            if (travelTarget)
+            {
+                // For attackers: if not at final waypoint and not currently traveling, set current waypoint
+                if (currentWP < city.waypoints.size() && !travelTarget->isTraveling())
+                {
+                    SetSiegeBotTravelTarget(event, travelTarget, currentWP);
+                }
+                
+                // Check if bot reached current target waypoint by distance
+                if (currentWP < city.waypoints.size())
+                {
+                    const Waypoint& targetWP = city.waypoints[currentWP];
+                    // Use full 3D distance to account for small Z differences between config and actual ground
+                    float dist = bot->GetDistance(targetWP.x, targetWP.y, targetWP.z);
+
+                    // If bot is within 10 yards of target waypoint, advance immediately
+                    if (dist <= 10.0f)
+                    {
+                        currentWP++;
+                        wpIter->second.waypoint = currentWP;
+
+                        // Immediately set next waypoint if not at leader yet
+                        if (currentWP < city.waypoints.size())
+                        {
+                            SetSiegeBotTravelTarget(event, travelTarget, currentWP);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+#endif
+
+/**
+ * @brief Plays the countdown announcements, RP dialogue and combat yells of a siege.
+ * @param event The siege event to update.
+ * @param currentTime Current server time in seconds.
+ */
+void UpdateSiegeYells(SiegeEvent& event, uint32 currentTime)
+{
+    // Countdown announcements during cinematic phase (percentage-based)
+    if (event.cinematicPhase)
+    {
+        const CityData& city = GetSiegeCity(event);
+        uint32 elapsed = currentTime - event.cinematicStartTime;
+        uint32 remaining = g_CinematicDelay > elapsed ? g_CinematicDelay - elapsed : 0;
+        
+        // Calculate percentage of time remaining
+        float percentRemaining = g_CinematicDelay > 0 ? (static_cast<float>(remaining) / static_cast<float>(g_CinematicDelay)) * 100.0f : 0.0f;
+        
+        // Announce at 75%, 50%, and 25% time remaining
+        const char* color = nullptr;
+        const char* call = nullptr;
+        if (percentRemaining <= 75.0f && !event.countdown75Announced)
+        {
+            event.countdown75Announced = true;
+            color = "FFFF00";
+            call = "Defenders, prepare!";
+        }
+        else if (percentRemaining <= 50.0f && !event.countdown50Announced)
+        {
+            event.countdown50Announced = true;
+            color = "FF8800";
+            call = "Defenders, to your posts!";
+        }
+        else if (percentRemaining <= 25.0f && !event.countdown25Announced)
+        {
+            event.countdown25Announced = true;
+            color = "FF0000";
+            call = "FINAL WARNING!";
+        }
+
+        if (call)
+        {
+            const std::string& countdownMsg = RenderSiegeMessage(event, SIEGE_MSG_COUNTDOWN, remaining, [&](auto out)
+            {
+                fmt::format_to(out, "|cffff0000[City Siege]|r |cff{}{} seconds|r until the siege of {} begins! {}",
+                    color, remaining, city.name, call);
+            });
+            sWorldSessionMgr->SendServerMessage(SERVER_MSG_STRING, countdownMsg);
+        }
+        
+        // RP Script execution during cinematic phase (sequential dialogue from leaders/mini-bosses)
+        if ((currentTime - event.lastYellTime) >= g_YellFrequency)
+        {
+            event.lastYellTime = currentTime;
+            
+            // Play through the pre-chosen RP script sequentially
+            if (!event.activeRPScript.empty() && event.rpScriptIndex < event.activeRPScript.size())
+            {
+                const CityData& city = GetSiegeCity(event);
+                Map* map = sMapMgr->FindMap(city.mapId, 0);
+                if (map)
+                {
+                    // Only leaders and mini-bosses do RP
+                    std::vector<Creature*> rpCreatures;
+                    for (uint32 slot : event.rpSpeakerSlots)
+                    {
+                        if (Creature* creature = map->GetCreature(event.spawnedCreatures[slot]))
+                        {
+                            if (creature->IsAlive())
                             {
-                                uint32 randomIndex = urand(0, yells.size() - 1);
-                                creature->Yell(yells[randomIndex].c_str(), LANG_UNIVERSAL);
+                                rpCreatures.push_back(creature);
                             }
-                            break; // Only one creature yells per cycle
                         }
                     }
+                    
+                    if (!rpCreatures.empty())
+                    {
+                        // Pick a random creature to say the current line
+                        uint32 randomCreatureIndex = urand(0, rpCreatures.size() - 1);
+                        Creature* yellingCreature = rpCreatures[randomCreatureIndex];
+                        yellingCreature->Yell(event.activeRPScript[event.rpScriptIndex], LANG_UNIVERSAL);
+                        
+                        if (g_DebugMode)
+                        {
+                            LOG_INFO("server.loading", "[City Siege] RP Line {}/{}: '{}'",
+                                     event.rpScriptIndex + 1, event.activeRPScript.size(), 
+                                     event.activeRPScript[event.rpScriptIndex]);
+                        }
+                        
+                        // Move to next line in script
+                        event.rpScriptIndex++;
+                    }
+                }
+            }
+        }
+    }
+
+    // Handle periodic yells
+    if ((currentTime - event.lastYellTime) >= g_YellFrequency)
+    {
+        event.lastYellTime = currentTime;
+        
+        const CityData& city = GetSiegeCity(event);
+        Map* map = sMapMgr->FindMap(city.mapId, 0);
+        if (map)
+        {
+            // Make siege leaders yell - only leaders and mini-bosses yell (and they must be alive)
+            for (uint32 slot : event.rpSpeakerSlots)
+            {
+                if (Creature* creature = map->GetCreature(event.spawnedCreatures[slot]))
+                {
+                    if (creature->IsAlive())
+                    {
+                        // Combat yells are split from the configuration once at load
+                        if (!g_CombatYells.empty())
+                        {
+                            uint32 randomIndex = urand(0, g_CombatYells.size() - 1);
+                            creature->Yell(g_CombatYells[randomIndex], LANG_UNIVERSAL);
+                        }
+                        break; // Only one creature yells per cycle
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Ends the cinematic phase, turns the siege forces hostile and sends them down their paths.
+ * @param event The siege event entering combat.
+ */
+void BeginSiegeCombat(SiegeEvent& event)
+{
+    // Whatever part of the army (or of its first wave) is still waiting to be summoned joins the battle now.
+    // Flushed while the cinematic flag is still set, so the loops below activate and march it once.
+    ProcessPendingSpawns(event, 0);
+    event.cinematicPhase = false;
+    
+    const CityData& city = GetSiegeCity(event);
+    
+    // Announce battle has begun!
+    const std::string& battleStart = RenderSiegeMessage(event, SIEGE_MSG_BATTLE_START, 0, [&](auto out)
+    {
+        fmt::format_to(out, "|cffff0000[City Siege]|r |cffFF0000THE BATTLE HAS BEGUN!|r The siege of {} is now underway! Defenders, to arms!", city.name);
+    });
+    sWorldSessionMgr->SendServerMessage(SERVER_MSG_STRING, battleStart);
+    
+    // Play combat phase music if enabled
+    if (g_MusicEnabled && g_CombatMusicId > 0)
+    {
+        // Send combat music to players within announce radius
+        PlaySiegeMusic(event, g_CombatMusicId);
+        
+        if (g_DebugMode)
+        {
+            LOG_INFO("server.loading", "[City Siege] Playing combat phase music (ID: {}) for siege of {}", g_CombatMusicId, city.name);
+        }
+    }
+    
+    // Activate playerbots for combat, teleporting any that are still waiting first
+#ifdef MOD_PLAYERBOTS
+    ProcessPendingBotTeleports(event, 0);
+#endif
+    ActivatePlayerbotsForSiege(event);
+    
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Cinematic phase ended, combat begins");
+    }
+    
+    event.nextWaveTime = time(nullptr) + g_WavesInterval;
+    
+    // Make creatures aggressive after cinematic phase
+    Map* map = sMapMgr->FindMap(city.mapId, 0);
+    if (map)
+    {
+        BuildSiegeSquads(event);
+
+        for (uint32 slot = 0; slot < event.spawnedCreatures.size(); ++slot)
+        {
+            Creature* creature = map->GetCreature(event.spawnedCreatures[slot]);
+            if (creature && creature->IsAlive())
+            {
+                ActivateSiegeUnit(event, creature, event.creatureSlots[slot].role);
+                
+                // Force creature to ground level before starting movement
+                GroundSiegeUnit(creature);
+                
+                // Squad followers fall in behind their leader (which comes first) instead of pathing
+                if (!UpdateSquadFollower(event, map, creature, slot, false))
+                {
+                    StartSiegeUnitMarch(event, creature, slot, false);
+                }
+            }
+        }
+        
+        // Initialize defenders - they move in REVERSE order through waypoints
+        for (uint32 slot = 0; slot < event.spawnedDefenders.size(); ++slot)
+        {
+            Creature* creature = map->GetCreature(event.spawnedDefenders[slot]);
+            if (creature && creature->IsAlive())
+            {
+                ActivateSiegeUnit(event, creature, SIEGE_ROLE_DEFENDER);
+                GroundSiegeUnit(creature);
+                if (!UpdateSquadFollower(event, map, creature, slot, true))
+                {
+                    StartSiegeUnitMarch(event, creature, slot, true);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Streams the attacker waves of a running siege. The next wave is summoned once every
+ * living unit of the last one has left the spawn point, or after CitySiege.Waves.Interval,
+ * as long as the live attackers stay below CitySiege.Waves.MaxLive.
+ * @param event The siege event.
+ * @param currentTime Current server time.
+ */
+void UpdateSiegeWaves(SiegeEvent& event, uint32 currentTime)
+{
+    // The latest wave is still being summoned, it gets its squads once complete
+    if (event.waveStreaming)
+    {
+        ProcessPendingSpawns(event, g_SpawnBatchSize);
+        if (!event.pendingSpawns.empty() && event.nextPendingSpawn < event.waveSpawnEnd)
+        {
+            return;
+        }
+
+        event.waveStreaming = false;
+        AddSiegeSquads(event, false, event.waveFirstSlot);
+        return;
+    }
+
+    if (event.wavesSent >= event.waveEnds.size())
+    {
+        return;
+    }
+
+    Map* map = sMapMgr->FindMap(GetSiegeCity(event).mapId, 0);
+    if (!map)
+    {
+        return;
+    }
+
+    uint32 live = 0;
+    bool advanced = true;
+    for (uint32 slot = 0; slot < event.spawnedCreatures.size(); ++slot)
+    {
+        Creature* creature = map->GetCreature(event.spawnedCreatures[slot]);
+        if (!creature || !creature->IsAlive())
+        {
+            continue;
+        }
+
+        live++;
+        if (slot >= event.waveFirstSlot && event.creatureSlots[slot].progress.waypoint == 0)
+        {
+            advanced = false;
+        }
+    }
+
+    if ((g_WavesMaxLive && live >= g_WavesMaxLive) || (!advanced && currentTime < event.nextWaveTime))
+    {
+        return;
+    }
+
+    event.waveFirstSlot = event.spawnedCreatures.size();
+    event.waveSpawnEnd = event.waveEnds[event.wavesSent++];
+    event.nextWaveTime = currentTime + g_WavesInterval;
+    event.waveStreaming = true;
+
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Sending wave {} of {} ({} attackers, {} alive) to {}",
+                 event.wavesSent, event.waveEnds.size(), event.waveSpawnEnd - event.nextPendingSpawn, live, GetSiegeCity(event).name);
+    }
+
+    ProcessPendingSpawns(event, g_SpawnBatchSize);
+}
+
+/**
+ * @brief Summons pending formation batches and respawns siege creatures and bots whose respawn timer has expired.
+ * @param event The siege event to update.
+ * @param currentTime Current server time in seconds.
+ */
+void UpdateSiegeRespawns(SiegeEvent& event, uint32 currentTime)
+{
+    // Summon the next batch of the army while the cinematic phase is playing
+    if (event.cinematicPhase)
+    {
+        ProcessPendingSpawns(event, g_SpawnBatchSize);
+    }
+    else if (g_WavesEnabled)
+    {
+        UpdateSiegeWaves(event, currentTime);
+    }
+
+    // Handle respawning of dead creatures (only during active siege, not during cinematic)
+    if (!event.cinematicPhase && g_RespawnEnabled && !event.deadCreatures.empty())
+    {
+        SiegePerfScope perf(SIEGE_PERF_RESPAWN);
+        const CityData& city = GetSiegeCity(event);
+        Map* map = sMapMgr->FindMap(city.mapId, 0);
+        if (map)
+        {
+            CityHeightCache& heights = GetCityHeightCache(city, map);
+
+            // A shrunk army holds its due respawns back until its live units are down to the new size
+            bool adaptive = g_AdaptiveEnabled && g_AdaptiveDuringSiege;
+            bool holdRespawns = adaptive || g_WavesEnabled;
+            uint32 alive[2] = { uint32(event.spawnedCreatures.size()), uint32(event.spawnedDefenders.size()) };
+            uint32 armySize[2] = { std::numeric_limits<uint32>::max(), std::numeric_limits<uint32>::max() };
+            if (holdRespawns)
+            {
+                for (const SiegeEvent::RespawnData& dead : event.deadCreatures)
+                {
+                    alive[dead.isDefender]--;
+                }
+
+                if (adaptive)
+                {
+                    armySize[0] = GetSiegeArmySize(false, event.armyScale);
+                    armySize[1] = GetSiegeArmySize(true, event.armyScale);
+                }
+
+                // Fallen attackers are replaced by the coming waves, after the last wave the live cap applies
+                if (g_WavesEnabled)
+                {
+                    if (event.wavesSent < event.waveEnds.size() || event.waveStreaming)
+                    {
+                        armySize[0] = 0;
+                    }
+                    else if (g_WavesMaxLive)
+                    {
+                        armySize[0] = std::min(armySize[0], g_WavesMaxLive);
+                    }
+                }
+            }
+            std::vector<SiegeEvent::RespawnData> heldRespawns;
+
+            // Only pop the creatures whose respawn time has come - the queue is ordered by due time
+            SiegeEvent::RespawnData respawnData;
+            while (PopDueRespawnEntry(event.deadCreatures, currentTime, respawnData))
+            {
+                if (holdRespawns && respawnData.role != SIEGE_ROLE_LEADER && alive[respawnData.isDefender] >= armySize[respawnData.isDefender])
+                {
+                    respawnData.respawnTime = currentTime + GetSiegeRespawnDelay(event, respawnData.role);
+                    heldRespawns.push_back(respawnData);
+                    continue;
+                }
+                alive[respawnData.isDefender]++;
+
+                // Calculate spawn position based on whether this is a defender or attacker
+                float spawnX, spawnY, spawnZ;
+                
+                if (respawnData.isDefender)
+                {
+                    // Defenders respawn on a cached ring 10-15 yards around the city leader
+                    const Waypoint& point = heights.defenderRespawnPoints[urand(0, heights.defenderRespawnPoints.size() - 1)];
+                    spawnX = point.x;
+                    spawnY = point.y;
+                    spawnZ = point.z;
+                }
+                else
+                {
+                    // Attackers respawn at the siege spawn point
+                    spawnX = city.spawnX;
+                    spawnY = city.spawnY;
+                    spawnZ = heights.spawnGroundZ;
+                }
+                
+                // Respawn the creature
+                if (Creature* creature = SummonSiegeUnit(event, map, respawnData.entry, respawnData.role, spawnX, spawnY, spawnZ, true))
+                {
+                    
+                    // The respawned creature takes over the slot of the dead one
+                    if (respawnData.isDefender)
+                    {
+                        event.spawnedDefenders[respawnData.slot] = creature->GetGUID();
+                    }
+                    else
+                    {
+                        event.spawnedCreatures[respawnData.slot] = creature->GetGUID();
+                    }
+                    event.unitIndex.erase(respawnData.guid);
+                    event.unitIndex[creature->GetGUID()] = { respawnData.slot, respawnData.isDefender, false };
+                    
+                    // Reset the slot's waypoint progress and send it on its way
+                    GetSiegeUnitSlot(event, respawnData.slot, respawnData.isDefender).awaitingRespawn = false;
+                    StartSiegeUnitMarch(event, creature, respawnData.slot, respawnData.isDefender);
+                    event.respawns.Add();
+                    
+                    if (g_DebugMode)
+                    {
+                        LOG_INFO("server.loading", "[City Siege] Respawned {} {} at {} ({}, {}, {}), starting movement to {} waypoint",
+                                 respawnData.isDefender ? "defender" : "attacker",
+                                 creature->GetGUID().ToString(),
+                                 respawnData.isDefender ? "leader position" : "siege spawn point",
+                                 spawnX, spawnY, spawnZ,
+                                 respawnData.isDefender ? "last" : "first");
+                    }
+                }
+            }
+
+            for (const SiegeEvent::RespawnData& held : heldRespawns)
+            {
+                PushRespawnEntry(event.deadCreatures, held);
+            }
+        }
+    }
+
+#ifdef MOD_PLAYERBOTS
+    if (!event.cinematicPhase)
+    {
+        SiegePerfScope perf(SIEGE_PERF_BOT_RESPAWN);
+        ProcessBotRespawns(event);
+    }
+#endif
+}
+
+/**
+ * @brief Collects the positions of the siege participants (players and playerbots on the city map).
+ * Siege units that are not within CitySiege.Interest.Radius of any of them are parked.
+ * @param event The siege event.
+ * @param observers Filled with the participant positions.
+ */
+void GatherSiegeObservers(const SiegeEvent& event, std::vector<Waypoint>& observers)
+{
+    observers.clear();
+    ForEachSiegeParticipant(event, [&](Player* player)
+    {
+        observers.push_back({ player->GetPositionX(), player->GetPositionY(), player->GetPositionZ() });
+    });
+}
+
+/**
+ * @brief Checks whether a position is within CitySiege.Interest.Radius of a participant.
+ * @param observers Participant positions (see GatherSiegeObservers).
+ * @param x X coordinate of the siege unit.
+ * @param y Y coordinate of the siege unit.
+ * @return True if a unit there must be fully simulated.
+ */
+bool IsSiegeObserverNear(const std::vector<Waypoint>& observers, float x, float y)
+{
+    float radiusSq = g_InterestRadius * g_InterestRadius;
+    for (const Waypoint& observer : observers)
+    {
+        float dx = observer.x - x;
+        float dy = observer.y - y;
+        if (dx * dx + dy * dy <= radiusSq)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Moves a position a given distance along the siege path, point by point along the
+ * cached navmesh legs where there are any. Arriving at a path point advances the waypoint
+ * progress the same way the full movement update does.
+ * @param city The city being sieged.
+ * @param getLeg Returns the cached leg between two path points, or nullptr to go straight.
+ * @param progress Waypoint progress of the unit, advanced on arrival.
+ * @param legPoint Next point of the current leg, 0 = resolve from the position.
+ * @param x X coordinate, moved.
+ * @param y Y coordinate, moved.
+ * @param z Z coordinate, moved.
+ * @param orientation Facing, set to the direction of travel.
+ * @param distance Distance to cover in yards.
+ */
+template <class LegFunc>
+void StepAlongSiegePath(const CityData& city, LegFunc&& getLeg, SiegeUnitProgress& progress, uint32& legPoint,
+    float& x, float& y, float& z, float& orientation, float distance)
+{
+    uint32 lastIndex = city.waypoints.size() + 1;
+
+    while (distance > 0.0f)
+    {
+        bool forward = progress.direction == SIEGE_MARCH_FORWARD;
+        uint32 target = forward ? progress.waypoint + 1 : progress.waypoint;
+        if (target > lastIndex)
+            break; // Invalid state
+
+        const Movement::PointsArray* leg = getLeg(forward ? target - 1 : target + 1, target);
+        if (leg && legPoint == 0)
+        {
+            // Resume from the leg point closest to where the unit was parked
+            uint32 closest = 0;
+            float closestDistSq = std::numeric_limits<float>::max();
+            for (uint32 i = 0; i < leg->size(); ++i)
+            {
+                float dx = (*leg)[i].x - x;
+                float dy = (*leg)[i].y - y;
+                if (dx * dx + dy * dy < closestDistSq)
+                {
+                    closestDistSq = dx * dx + dy * dy;
+                    closest = i;
+                }
+            }
+            legPoint = std::min<uint32>(closest + 1, leg->size() - 1);
+        }
+
+        // Without a cached leg the unit heads straight for the path point
+        G3D::Vector3 next;
+        if (leg)
+        {
+            next = (*leg)[legPoint];
+        }
+        else
+        {
+            Waypoint point = GetSiegePathPoint(city, target);
+            next = G3D::Vector3(point.x, point.y, point.z);
+        }
+
+        float dx = next.x - x;
+        float dy = next.y - y;
+        float dz = next.z - z;
+        float dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+        if (dist > 0.1f)
+            orientation = std::atan2(dy, dx);
+
+        if (dist > distance)
+        {
+            float fraction = distance / dist;
+            x += dx * fraction;
+            y += dy * fraction;
+            z += dz * fraction;
+            break;
+        }
+
+        x = next.x;
+        y = next.y;
+        z = next.z;
+        distance -= dist;
+
+        if (leg && legPoint + 1 < leg->size())
+        {
+            legPoint++;
+            continue;
+        }
+
+        // Attackers hold at the leader, defenders at the spawn point
+        if (forward ? target == lastIndex : target == 0)
+            break;
+
+        progress.waypoint = forward ? progress.waypoint + 1 : progress.waypoint - 1;
+        legPoint = 1; // Point 0 of the next leg is the path point just reached
+    }
+}
+
+/**
+ * @brief Advances a parked siege unit. Nobody is near enough to see it, so instead of launching
+ * splines and probing the ground it is relocated along the cached navmesh leg every
+ * CitySiege.Interest.ParkedInterval seconds, as far as it would have run in the meantime.
+ * @param event The siege event the unit belongs to.
+ * @param map The city map.
+ * @param creature The living siege creature, out of combat.
+ * @param slot Slot of the creature in spawnedCreatures or spawnedDefenders.
+ * @param isDefender True for city defenders, false for attackers.
+ */
+void UpdateParkedSiegeUnit(SiegeEvent& event, Map* map, Creature* creature, uint32 slot, bool isDefender)
+{
+    const CityData& city = GetSiegeCity(event);
+    SiegeEvent::UnitSlot& unit = GetSiegeUnitSlot(event, slot, isDefender);
+    uint32 now = time(nullptr);
+
+    if (!unit.parked)
+    {
+        // Drop the current leg (or squad follow), the parked steps take over from here
+        unit.parked = true;
+        unit.parkedLegPoint = 0;
+        unit.lastMoveTime = now;
+        creature->GetMotionMaster()->Clear(false);
+        creature->GetMotionMaster()->MoveIdle();
+        creature->StopMoving();
+        return;
+    }
+
+    if (now - unit.lastMoveTime < g_InterestParkedInterval)
+        return;
+
+    float budget = creature->GetSpeed(MOVE_RUN) * (now - unit.lastMoveTime);
+    unit.lastMoveTime = now;
+
+    float x = creature->GetPositionX();
+    float y = creature->GetPositionY();
+    float z = creature->GetPositionZ();
+    float orientation = creature->GetOrientation();
+    SiegeUnitProgress progress = unit.progress;
+    uint32 legPoint = unit.parkedLegPoint;
+    StepAlongSiegePath(city, [&](uint32 fromIndex, uint32 toIndex) { return GetCachedSiegeLeg(city, creature, fromIndex, toIndex); },
+        progress, legPoint, x, y, z, orientation, budget);
+
+    // Relocating into an unloaded grid would make the core remove the summon, so the unit
+    // holds at the edge of the loaded grids until the grid ahead is loaded
+    if (!map->IsGridLoaded(x, y))
+        return;
+
+    unit.progress = progress;
+    unit.parkedLegPoint = legPoint;
+
+    // The leg points lie on the navmesh, so no ground probe is needed
+    map->CreatureRelocation(creature, x, y, z, orientation);
+    creature->SetHomePosition(x, y, z, orientation);
+}
+
+// What the movement update does with a siege unit that is not moving (see CheckSiegeUnitProgress)
+enum SiegeProgressAction : uint8
+{
+    SIEGE_PROGRESS_LAUNCH = 0, // Launch the leg towards the target
+    SIEGE_PROGRESS_WAIT,       // The last leg made no progress, wait for the backoff to pass
+    SIEGE_PROGRESS_STUCK       // No progress for CitySiege.Stuck.Timeout seconds, recover the unit
+};
+
+/**
+ * @brief Decides whether a siege unit that is not moving launches its next leg.
+ * Reaching a new target or getting 2 yards closer to the current one is progress and launches at
+ * once. Without progress the unit waits 1, 2, 4, ... seconds (up to CitySiege.Stuck.MaxBackoff)
+ * between launches, so a leg the pathfinder cannot complete is not relaunched every pass.
+ * @param unit Slot of the siege unit.
+ * @param target Path point the unit is heading to.
+ * @param distance Distance of the unit to the target.
+ * @param now Current server time in seconds.
+ * @return What to do with the unit.
+ */
+SiegeProgressAction CheckSiegeUnitProgress(SiegeEvent::UnitSlot& unit, uint32 target, float distance, uint32 now)
+{
+    if (unit.progressTarget != target || distance < unit.progressDistance - 2.0f)
+    {
+        unit.progressTarget = target;
+        unit.progressDistance = distance;
+        unit.progressTime = now;
+        unit.retryTime = 0;
+        unit.retries = 0;
+        return SIEGE_PROGRESS_LAUNCH;
+    }
+
+    if (now - unit.progressTime >= g_StuckTimeout)
+        return SIEGE_PROGRESS_STUCK;
+
+    if (now < unit.retryTime)
+        return SIEGE_PROGRESS_WAIT;
+
+    unit.retryTime = now + std::min<uint32>(1u << std::min<uint32>(unit.retries, 16), g_StuckMaxBackoff);
+    unit.retries++;
+    return SIEGE_PROGRESS_LAUNCH;
+}
+
+/**
+ * @brief Recovers a siege unit that made no progress for CitySiege.Stuck.Timeout seconds:
+ * teleports it to its target path point, or despawns it and queues it for respawn.
+ * @param event The siege event the creature belongs to.
+ * @param creature The stuck siege creature.
+ * @param slot Slot of the creature in spawnedCreatures or spawnedDefenders.
+ * @param isDefender True for city defenders, false for attackers.
+ * @param point The path point the unit was heading to.
+ * @param now Current server time in seconds.
+ */
+void RecoverStuckSiegeUnit(SiegeEvent& event, Creature* creature, uint32 slot, bool isDefender, const Waypoint& point, uint32 now)
+{
+    SiegeEvent::UnitSlot& unit = GetSiegeUnitSlot(event, slot, isDefender);
+    unit.progressTarget = SIEGE_PROGRESS_NONE;
+    event.stuckRecoveries.Add();
+
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] {} {} made no progress for {} seconds, {}",
+                 isDefender ? "Defender" : "Attacker", creature->GetGUID().ToString(), g_StuckTimeout,
+                 g_StuckAction == 1 && g_RespawnEnabled ? "queued for respawn" : "teleported to its target");
+    }
+
+    if (g_StuckAction == 1 && g_RespawnEnabled)
+    {
+        QueueSiegeRespawn(event, creature->GetGUID(), creature->GetEntry(), slot, isDefender, now);
+        creature->DespawnOrUnsummon();
+        return;
+    }
+
+    // Arriving at the path point lets the next movement pass head for the one after it
+    creature->NearTeleportTo(point.x, point.y, point.z, creature->GetOrientation());
+}
+
+/**
+ * @brief Advances one siege creature along the waypoint path.
+ * Attackers march forwards and defenders backwards through the same states:
+ * fighting or following a squad leader (no path movement), walking a leg, and
+ * arriving at a path point - then heading for the next one or holding at the end.
+ * Units nobody is near are parked instead (see UpdateParkedSiegeUnit).
+ * @param event The siege event the creature belongs to.
+ * @param map The city map.
+ * @param heights Height cache of the city.
+ * @param creature The living siege creature.
+ * @param slot Slot of the creature in spawnedCreatures or spawnedDefenders.
+ * @param isDefender True for city defenders, false for attackers.
+ * @param inInterest False if no participant is near the unit (or its squad leader).
+ */
+void UpdateSiegeUnitMovement(SiegeEvent& event, Map* map, CityHeightCache& heights, Creature* creature, uint32 slot, bool isDefender, bool inInterest)
+{
+    const CityData& city = GetSiegeCity(event);
+    SiegeEvent::UnitSlot& unit = GetSiegeUnitSlot(event, slot, isDefender);
+
+    // IMPORTANT: ALWAYS set home position to current position to prevent evading/returning
+    // This must be done continuously - even during combat - because combat reset can restore original home
+    creature->SetHomePosition(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ(), creature->GetOrientation());
+
+    // Skip movement updates if creature is currently in combat
+    // (something is fighting it, so it is simulated in full again afterwards)
+    // Time spent fighting, parked or following does not count against the stuck timeout
+    if (creature->IsInCombat())
+    {
+        unit.parked = false;
+        unit.progressTarget = SIEGE_PROGRESS_NONE;
+        return;
+    }
+
+    if (!inInterest)
+    {
+        unit.progressTarget = SIEGE_PROGRESS_NONE;
+        UpdateParkedSiegeUnit(event, map, creature, slot, isDefender);
+        return;
+    }
+
+    // Back in sight: the update below paths on from wherever the unit was parked
+    unit.parked = false;
+
+    // Squad followers move with their leader
+    if (UpdateSquadFollower(event, map, creature, slot, isDefender))
+    {
+        unit.progressTarget = SIEGE_PROGRESS_NONE;
+        return;
+    }
+
+    // Check if creature is currently moving - if so, don't interrupt
+    if (!creature->movespline->Finalized())
+        return;
+
+    // Force creature to ground level to prevent floating/clipping
+    // The memoized cell height only decides whether the exact probe is needed
+    float groundZ = GetCachedGroundHeight(heights, map, creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ());
+    if (groundZ > INVALID_HEIGHT && std::abs(creature->GetPositionZ() - groundZ) > 2.0f)
+    {
+        GroundSiegeUnit(creature);
+    }
+
+    // Continuously enforce ground movement flags
+    creature->SetDisableGravity(false);
+    creature->SetCanFly(false);
+    creature->SetHover(false);
+    creature->RemoveUnitMovementFlag(MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER);
+
+    SiegeUnitProgress& progress = unit.progress;
+    bool forward = progress.direction == SIEGE_MARCH_FORWARD;
+    uint32 lastIndex = city.waypoints.size() + 1;
+    uint32 target = forward ? progress.waypoint + 1 : progress.waypoint;
+    if (target > lastIndex)
+        return; // Invalid state
+
+    Waypoint point = GetSiegePathPoint(city, target);
+
+    // Within 10 yards of the current target counts as reached
+    float distance = creature->GetDistance(point.x, point.y, point.z);
+    if (distance <= 10.0f)
+    {
+        // Attackers hold at the leader, defenders at the spawn point
+        if (forward ? target == lastIndex : target == 0)
+            return;
+
+        progress.waypoint = forward ? progress.waypoint + 1 : progress.waypoint - 1;
+        target = forward ? target + 1 : target - 1;
+        point = GetSiegePathPoint(city, target);
+        distance = creature->GetDistance(point.x, point.y, point.z);
+    }
+
+    // A leg that ended short of the target is retried with backoff instead of every pass
+    if (g_StuckTimeout)
+    {
+        uint32 now = time(nullptr);
+        SiegeProgressAction action = CheckSiegeUnitProgress(unit, target, distance, now);
+        if (action == SIEGE_PROGRESS_WAIT)
+            return;
+
+        if (action == SIEGE_PROGRESS_STUCK)
+        {
+            RecoverStuckSiegeUnit(event, creature, slot, isDefender, point, now);
+            return;
+        }
+    }
+
+    // Not moving: start (or resume) the leg towards the target.
+    // Randomize X/Y only to prevent bunching, keeping the waypoint Z to prevent underground pathing
+    float destX = point.x;
+    float destY = point.y;
+    JitterPathPoint(heights, target, destX, destY);
+
+    // Update home position before movement to prevent evading
+    creature->SetHomePosition(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ(), creature->GetOrientation());
+
+    MoveSiegeUnit(creature, city, forward ? target - 1 : target + 1, target, destX, destY, point.z);
+    unit.lastMoveTime = time(nullptr);
+}
+
+/**
+ * @brief Moves siege creatures and bots along the city waypoint path.
+ * @param event The siege event to update.
+ */
+void UpdateSiegeMovement(SiegeEvent& event)
+{
+    if (event.cinematicPhase)
+    {
+        return;
+    }
+
+    const CityData& city = GetSiegeCity(event);
+    Map* map = sMapMgr->FindMap(city.mapId, 0);
+    if (!map)
+    {
+        return;
+    }
+
+    CityHeightCache& heights = GetCityHeightCache(city, map);
+
+    // Interest management: a squad is parked or simulated as a whole, depending on its leader
+    std::vector<Waypoint> observers;
+    if (g_InterestEnabled)
+    {
+        GatherSiegeObservers(event, observers);
+        for (SiegeEvent::SiegeSquad& squad : event.squads)
+        {
+            const std::vector<ObjectGuid>& guids = squad.isDefender ? event.spawnedDefenders : event.spawnedCreatures;
+            Creature* leader = map->GetCreature(guids[squad.slots[squad.leader]]);
+
+            // A dead leader is replaced by the full update, which promotes the next member
+            squad.inInterest = !leader || !leader->IsAlive() || IsSiegeObserverNear(observers, leader->GetPositionX(), leader->GetPositionY());
+        }
+    }
+
+    auto isInInterest = [&](Creature* creature, uint32 slot, bool isDefender)
+    {
+        if (!g_InterestEnabled)
+            return true;
+
+        const std::vector<int32>& unitSquads = isDefender ? event.defenderSquads : event.creatureSquads;
+        if (slot < unitSquads.size() && unitSquads[slot] >= 0)
+            return event.squads[unitSquads[slot]].inInterest;
+
+        return IsSiegeObserverNear(observers, creature->GetPositionX(), creature->GetPositionY());
+    };
+
+    // Each creature is visited once; attackers and defenders share the same per-unit update
+    SiegePerfScope attackerPerf(SIEGE_PERF_ATTACKER_MOVEMENT);
+    for (uint32 slot = 0; slot < event.spawnedCreatures.size(); ++slot)
+    {
+        // Dead creatures are queued for respawn by the death hook
+        if (event.creatureSlots[slot].awaitingRespawn)
+            continue;
+
+        Creature* creature = map->GetCreature(event.spawnedCreatures[slot]);
+        if (creature && creature->IsAlive())
+        {
+            UpdateSiegeUnitMovement(event, map, heights, creature, slot, false, isInInterest(creature, slot, false));
+        }
+        else if (!creature)
+        {
+            // Removed by the core without dying (e.g. its grid was unloaded), the slot is filled again
+            QueueSiegeRespawn(event, event.spawnedCreatures[slot], event.spawnedCreatures[slot].GetEntry(), slot, false, time(nullptr));
+        }
+    }
+
+    attackerPerf.Finish();
+
+    SiegePerfScope defenderPerf(SIEGE_PERF_DEFENDER_MOVEMENT);
+    for (uint32 slot = 0; slot < event.spawnedDefenders.size(); ++slot)
+    {
+        if (event.defenderSlots[slot].awaitingRespawn)
+            continue;
+
+        Creature* creature = map->GetCreature(event.spawnedDefenders[slot]);
+        if (creature && creature->IsAlive())
+        {
+            UpdateSiegeUnitMovement(event, map, heights, creature, slot, true, isInInterest(creature, slot, true));
+        }
+        else if (!creature)
+        {
+            QueueSiegeRespawn(event, event.spawnedDefenders[slot], event.spawnedDefenders[slot].GetEntry(), slot, true, time(nullptr));
+        }
+    }
+
+    defenderPerf.Finish();
+
+#ifdef MOD_PLAYERBOTS
+    SiegePerfScope botPerf(SIEGE_PERF_BOT_MOVEMENT);
+    UpdateBotWaypointMovement(event);
+#endif
+}
+
+/**
+ * @brief Handles phase transitions, status announcements and the win conditions of a siege.
+ * @param event The siege event to update.
+ * @param currentTime Current server time in seconds.
+ */
+void UpdateSiegeStatus(SiegeEvent& event, uint32 currentTime)
+{
+#ifdef MOD_PLAYERBOTS
+    // Recruited bots come from all over the world, so they are teleported in from the world update
+    if (event.cinematicPhase)
+    {
+        ProcessPendingBotTeleports(event, g_PlayerbotsTeleportBatch);
+    }
+#endif
+
+    // Check if cinematic phase is over
+    if (event.cinematicPhase && (currentTime - event.startTime) >= g_CinematicDelay)
+    {
+        BeginSiegeCombat(event);
+    }
+
+    if (g_TelemetryEnabled && currentTime >= event.nextTelemetryTime)
+    {
+        SampleSiegeTelemetry(event, currentTime);
+    }
+
+    // Status announcements every 5 minutes (300 seconds) during active combat
+    if (!event.cinematicPhase && (currentTime - event.lastStatusAnnouncement) >= 300)
+    {
+        event.lastStatusAnnouncement = currentTime;
+        
+        const CityData& city = GetSiegeCity(event);
+        Map* map = sMapMgr->FindMap(city.mapId, 0);
+        
+        // Calculate time remaining
+        uint32 timeRemaining = event.endTime > currentTime ? event.endTime - currentTime : 0;
+        uint32 minutesLeft = timeRemaining / 60;
+        
+        // Try to get leader health percentage
+        uint32 leaderHealthPct = 100;
+        bool leaderHealthAvailable = false;
+        
+        if (map)
+        {
+            Creature* leader = GetSiegeCityLeader(event, map);
+            if (leader && leader->IsAlive())
+            {
+                leaderHealthPct = leader->GetHealthPct();
+                leaderHealthAvailable = true;
+            }
+        }
+        
+        // Build announcement message, rendered again only when the minutes or the health change
+        uint32 numbers = (std::min<uint32>(minutesLeft, 0xFFFFFF) << 8) | (leaderHealthAvailable ? leaderHealthPct : 0xFF);
+        const std::string& statusMsg = RenderSiegeMessage(event, SIEGE_MSG_STATUS, numbers, [&](auto out)
+        {
+            fmt::format_to(out, "|cffff0000[City Siege]|r |cffFFFF00STATUS UPDATE:|r {} siege - {} minutes remaining. ",
+                city.name, minutesLeft);
+
+            if (leaderHealthAvailable)
+            {
+                // Color code based on health
+                const char* color = "FF0000"; // Red
+                if (leaderHealthPct > 75)
+                    color = "00FF00"; // Green
+                else if (leaderHealthPct > 50)
+                    color = "FFFF00"; // Yellow
+                else if (leaderHealthPct > 25)
+                    color = "FF8800"; // Orange
+
+                fmt::format_to(out, "Leader health: |cff{}{}%|r", color, leaderHealthPct);
+
+                // Add dramatic messages for critical health
+                if (leaderHealthPct <= 25)
+                    fmt::format_to(out, " |cffFF0000CRITICAL!|r The city leader is in grave danger!");
+                else if (leaderHealthPct <= 50)
+                    fmt::format_to(out, " The city leader is under heavy assault!");
+            }
+            else
+            {
+                fmt::format_to(out, "Leader status: Unknown (not in combat yet)");
+            }
+
+            // Add time warning if less than 10 minutes left
+            if (minutesLeft <= 5 && minutesLeft > 0)
+                fmt::format_to(out, " |cffFFFF00FINAL MINUTES!|r");
+        });
+
+        sWorldSessionMgr->SendServerMessage(SERVER_MSG_STRING, statusMsg);
+    }
+
+    // Check if city leader is dead (attackers win). The death hook flags the kill; the
+    // GUID lookup covers a leader killed while the hook could not see it (e.g. .die)
+    if (!event.cinematicPhase)
+    {
+        const CityData& city = GetSiegeCity(event);
+        bool leaderDead = event.cityLeaderKilled;
+
+        if (!leaderDead)
+        {
+            Map* map = sMapMgr->FindMap(city.mapId, 0);
+            Creature* cityLeader = map ? GetSiegeCityLeader(event, map) : nullptr;
+
+            // Only end the siege if we actually FOUND the leader and they are DEAD
+            leaderDead = cityLeader && !cityLeader->IsAlive();
+        }
+
+        if (leaderDead)
+        {
+            if (g_DebugMode)
+            {
+                LOG_INFO("server.loading", "[City Siege] City leader killed! Attackers win. Ending siege of {}", city.name);
+            }
+
+            // Determine winning team: opposite of the city's faction
+            int winningTeam = GetSiegeAttackingTeam(GetSiegeCity(event)); // 0 = Alliance, 1 = Horde
+
+            EndSiegeEvent(event, winningTeam);
+            return; // Nothing left to update for this siege
+        }
+    }
+
+    // Check if event should end (time limit reached - defenders win)
+    if (currentTime >= event.endTime)
+    {
+        EndSiegeEvent(event);
+    }
+}
+
+/**
+ * @brief Runs a single scheduler stage for a siege.
+ * @param event The siege event to update.
+ * @param stage The stage whose interval has elapsed.
+ * @param currentTime Current server time in seconds.
+ */
+void RunSiegeStage(SiegeEvent& event, SiegeStage stage, uint32 currentTime)
+{
+    switch (stage)
+    {
+        case SIEGE_STAGE_STATUS:
+        {
+            SiegePerfScope perf(SIEGE_PERF_STATUS);
+            UpdateSiegeStatus(event, currentTime);
+            break;
+        }
+        case SIEGE_STAGE_YELLS:
+        {
+            SiegePerfScope perf(SIEGE_PERF_YELLS);
+            UpdateSiegeYells(event, currentTime);
+            break;
+        }
+        case SIEGE_STAGE_RESPAWN:
+            // Split into spawn, respawn and bot respawn sections inside
+            UpdateSiegeRespawns(event, currentTime);
+            break;
+        case SIEGE_STAGE_MOVEMENT:
+            // Split into attacker, defender and bot movement sections inside
+            UpdateSiegeMovement(event);
+            break;
+        case SIEGE_STAGE_PARTICIPANTS:
+        {
+            SiegePerfScope perf(SIEGE_PERF_PARTICIPANTS);
+            RefreshSiegeParticipants(event);
+            if (g_AdaptiveEnabled && g_AdaptiveDuringSiege)
+            {
+                event.armyScale = ComputeSiegeArmyScale(event.realParticipants);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Checks whether a scheduler stage runs from the city map's update instead of the world update.
+ * Stages that make world-wide announcements or reach players on other maps stay on the world update.
+ * @param stage The scheduler stage.
+ * @return True if the stage runs on the map update thread.
+ */
+inline bool IsSiegeMapStage(uint8 stage)
+{
+    return g_MapThreadUpdates &&
+        (stage == SIEGE_STAGE_RESPAWN || stage == SIEGE_STAGE_MOVEMENT || stage == SIEGE_STAGE_PARTICIPANTS);
+}
+
+/**
+ * @brief Runs the due stages of a siege that belong to the calling update.
+ * @param event The active siege event.
+ * @param diff Time since the caller's last update in milliseconds.
+ * @param mapThread True when called from the city map's update, false from the world update.
+ * @param updateStartMs getMSTime() at the start of the caller's update, for the budget.
+ * @param currentTime Current server time in seconds.
+ * @return False if the budget deferred a due stage.
+ */
+bool RunDueSiegeStages(SiegeEvent& event, uint32 diff, bool mapThread, uint32 updateStartMs, uint32 currentTime)
+{
+    bool complete = true;
+    for (uint8 stage = 0; stage < SIEGE_STAGE_MAX; ++stage)
+    {
+        if (IsSiegeMapStage(stage) != mapThread)
+            continue;
+
+        event.stageTimers[stage] += diff;
+        if (event.stageTimers[stage] < g_StageIntervals[stage])
+            continue;
+
+        // Out of budget: keep the timer elapsed so the stage runs first thing next tick.
+        // Status carries the win conditions and is never deferred.
+        if (stage != SIEGE_STAGE_STATUS && g_UpdateBudget > 0 &&
+            getMSTimeDiff(updateStartMs, getMSTime()) >= g_UpdateBudget)
+        {
+            complete = false;
+            continue;
+        }
+
+        event.stageTimers[stage] = 0;
+        RunSiegeStage(event, static_cast<SiegeStage>(stage), currentTime);
+
+        if (!event.isActive)
+            break;
+    }
+
+    return complete;
+}
+
+// -----------------------------------------------------------------------------
+// CITY CACHE FILE
+// -----------------------------------------------------------------------------
+
+static const uint32 SIEGE_CACHE_MAGIC = 0x43534743; // "CSGC"
+static const uint32 SIEGE_CACHE_VERSION = 1; // Bump whenever the cached data or the way it is computed changes
+static const uint32 SIEGE_MAX_CITY_PATH_POINTS = 1024; // Bound on the path sizes read from the file
+
+// Caches of one city as read from the cache file
+struct SiegeCityCacheEntry
+{
+    uint64 key = 0;
+    CityHeightCache heights;
+    CityPathCache paths;
+};
+typedef std::unordered_map<uint32, SiegeCityCacheEntry> SiegeCacheFileData; // Keyed by CityId
+
+static std::future<SiegeCacheFileData> g_CacheLoad; // Reading the cache file for g_CacheLoadConfig
+static std::shared_ptr<const SiegeConfigSnapshot> g_CacheLoadConfig;
+static std::future<bool> g_CacheWrite;
+static bool g_CachePrecompute = false; // Map threads fill the caches still missing, set by the world thread only
+static std::atomic<bool> g_CacheDirty(false); // A map thread finished a city, the file is rewritten
+
+/**
+ * @brief Hashes everything the caches of a city are computed from, so a stale cache is never used.
+ * @param city The city.
+ * @return The cache key of the city.
+ */
+uint64 GetSiegeCityCacheKey(const CityData& city)
+{
+    // FNV-1a
+    uint64 hash = 14695981039346656037ULL;
+    auto mix = [&hash](const void* data, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= static_cast<const uint8*>(data)[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    mix(&SIEGE_CACHE_VERSION, sizeof(SIEGE_CACHE_VERSION));
+    mix(&city.mapId, sizeof(city.mapId));
+    float points[] = { city.spawnX, city.spawnY, city.spawnZ, city.leaderX, city.leaderY, city.leaderZ };
+    mix(points, sizeof(points));
+    for (const Waypoint& wp : city.waypoints)
+    {
+        mix(&wp, sizeof(wp));
+    }
+
+    // The formation rings are sized by the spawn counts
+    for (const SiegeFormationRank& rank : g_FormationRanks)
+    {
+        uint32 count = GetSiegeRoleScaledCount(rank.role, g_AdaptiveEnabled ? g_AdaptiveMaxScale : 1.0f);
+        mix(&count, sizeof(count));
+    }
+
+    return hash;
+}
+
+// Appends plain values to a byte buffer
+struct SiegeCacheWriter
+{
+    std::string data;
+
+    template <class T>
+    void Put(const T& value)
+    {
+        data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <class T>
+    void PutArray(const std::vector<T>& values)
+    {
+        Put(uint32(values.size()));
+        data.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+};
+
+// Reads plain values back from a byte buffer, failing once past its end
+struct SiegeCacheReader
+{
+    const std::string& data;
+    size_t pos = 0;
+    bool ok = true;
+
+    explicit SiegeCacheReader(const std::string& buffer) : data(buffer) { }
+
+    template <class T>
+    T Get()
+    {
+        T value = T();
+        if (!ok || data.size() - pos < sizeof(T))
+        {
+            ok = false;
+            return value;
+        }
+
+        memcpy(&value, data.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    template <class T>
+    void GetArray(std::vector<T>& values)
+    {
+        uint32 count = Get<uint32>();
+        if (!ok || (data.size() - pos) / sizeof(T) < count)
+        {
+            ok = false;
+            return;
+        }
+
+        values.resize(count);
+        memcpy(values.data(), data.data() + pos, count * sizeof(T));
+        pos += count * sizeof(T);
+    }
+};
+
+/**
+ * @brief Serializes the finished caches of every city of a config snapshot.
+ * @param config The snapshot.
+ * @return The cache file contents.
+ */
+std::string SerializeSiegeCaches(const SiegeConfigSnapshot& config)
+{
+    SiegeCacheWriter writer;
+    writer.Put(SIEGE_CACHE_MAGIC);
+    writer.Put(SIEGE_CACHE_VERSION);
+
+    uint32 count = 0;
+    for (const CityData& city : config.cities)
+    {
+        if (city.heights->built && city.paths->precomputed)
+        {
+            count++;
+        }
+    }
+    writer.Put(count);
+
+    for (const CityData& city : config.cities)
+    {
+        const CityHeightCache& heights = *city.heights;
+        const CityPathCache& paths = *city.paths;
+        if (!heights.built || !paths.precomputed)
+        {
+            continue;
+        }
+
+        writer.Put(uint32(city.id));
+        writer.Put(GetSiegeCityCacheKey(city));
+        writer.PutArray(heights.formation);
+        writer.PutArray(heights.defenderRespawnPoints);
+        writer.Put(heights.spawnGroundZ);
+        writer.Put(uint32(heights.pathJitter.size()));
+        for (const std::vector<Waypoint>& jitter : heights.pathJitter)
+        {
+            writer.PutArray(jitter);
+        }
+
+        writer.Put(uint32(paths.forwardLegs.size()));
+        for (const std::vector<SiegePathLeg>* legs : { &paths.forwardLegs, &paths.backwardLegs })
+        {
+            for (const SiegePathLeg& leg : *legs)
+            {
+                writer.PutArray(leg.points);
+            }
+        }
+    }
+
+    return std::move(writer.data);
+}
+
+/**
+ * @brief Reads the cache file. Runs on a worker thread and touches no shared state.
+ * @param fileName The cache file.
+ * @return The caches in the file, empty if it is missing, of another version or damaged.
+ */
+SiegeCacheFileData ReadSiegeCacheFile(std::string fileName)
+{
+    SiegeCacheFileData result;
+
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file)
+    {
+        return result;
+    }
+
+    std::string buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    SiegeCacheReader reader(buffer);
+    if (reader.Get<uint32>() != SIEGE_CACHE_MAGIC || reader.Get<uint32>() != SIEGE_CACHE_VERSION)
+    {
+        return result;
+    }
+
+    uint32 count = reader.Get<uint32>();
+    for (uint32 i = 0; i < count && reader.ok; ++i)
+    {
+        uint32 cityId = reader.Get<uint32>();
+        SiegeCityCacheEntry entry;
+        entry.key = reader.Get<uint64>();
+        reader.GetArray(entry.heights.formation);
+        reader.GetArray(entry.heights.defenderRespawnPoints);
+        entry.heights.spawnGroundZ = reader.Get<float>();
+        entry.heights.pathJitter.resize(std::min<uint32>(reader.Get<uint32>(), SIEGE_MAX_CITY_PATH_POINTS));
+        for (std::vector<Waypoint>& jitter : entry.heights.pathJitter)
+        {
+            reader.GetArray(jitter);
+        }
+
+        uint32 legCount = std::min<uint32>(reader.Get<uint32>(), SIEGE_MAX_CITY_PATH_POINTS);
+        entry.paths.forwardLegs.resize(legCount);
+        entry.paths.backwardLegs.resize(legCount);
+        for (std::vector<SiegePathLeg>* legs : { &entry.paths.forwardLegs, &entry.paths.backwardLegs })
+        {
+            for (SiegePathLeg& leg : *legs)
+            {
+                reader.GetArray(leg.points);
+                leg.computed = true;
+            }
+        }
+
+        entry.heights.built = true;
+        entry.paths.precomputed = true;
+        if (reader.ok)
+        {
+            result[cityId] = std::move(entry);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Starts reading the cache file for the current config snapshot on a worker thread.
+ * The caches are installed by UpdateSiegeCacheFile once read.
+ */
+void StartSiegeCacheLoad()
+{
+    g_CachePrecompute = false;
+    g_CacheLoadConfig = g_Config;
+    if (!g_CacheEnabled)
+    {
+        g_CacheLoad = std::future<SiegeCacheFileData>();
+        return;
+    }
+
+    g_CacheLoad = std::async(std::launch::async, ReadSiegeCacheFile, g_CacheFile);
+}
+
+/**
+ * @brief World update part of the cache file: installs the caches read from it, has the map
+ * threads precompute the missing cities and writes the file again once they are done.
+ */
+void UpdateSiegeCacheFile()
+{
+    if (!g_CacheEnabled)
+    {
+        return;
+    }
+
+    if (g_CacheLoad.valid())
+    {
+        if (g_CacheLoad.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            return;
+        }
+
+        SiegeCacheFileData loaded = g_CacheLoad.get();
+        uint32 installed = 0;
+
+        // Nothing to do if a reload replaced the snapshot meanwhile, its own load is on the way
+        if (g_CacheLoadConfig == g_Config)
+        {
+            uint32 formationSize = GetSiegeFormationSize();
+            for (const CityData& city : g_Config->cities)
+            {
+                auto itr = loaded.find(city.id);
+                // A siege that started before the file was read has built this city live already
+                if (itr == loaded.end() || itr->second.key != GetSiegeCityCacheKey(city) || city.heights->built ||
+                    itr->second.heights.pathJitter.size() != city.waypoints.size() + 2 ||
+                    itr->second.heights.defenderRespawnPoints.size() != SIEGE_DEFENDER_RESPAWN_POINTS ||
+                    itr->second.heights.formation.size() != formationSize ||
+                    itr->second.paths.forwardLegs.size() != city.waypoints.size() + 1)
+                {
+                    continue;
                 }
+
+                *city.heights = std::move(itr->second.heights);
+                *city.paths = std::move(itr->second.paths);
+                installed++;
+            }
+        }
+        g_CacheLoadConfig.reset();
+        g_CachePrecompute = true;
+
+        LOG_INFO("server.loading", "[City Siege] Loaded caches of {} of {} cities from {}", installed, g_Config->cities.size(), g_CacheFile);
+    }
+
+    if (!g_CachePrecompute)
+    {
+        return;
+    }
+
+    // The previous write is still going
+    if (g_CacheWrite.valid() && g_CacheWrite.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        return;
+    }
+
+    if (g_CacheWrite.valid() && !g_CacheWrite.get())
+    {
+        LOG_ERROR("server.loading", "[City Siege] Could not write the cache file {}", g_CacheFile);
+    }
+
+    bool complete = std::all_of(g_Config->cities.begin(), g_Config->cities.end(),
+        [](const CityData& city) { return city.heights->built && city.paths->precomputed; });
+
+    if (g_CacheDirty.exchange(false))
+    {
+        std::string data = SerializeSiegeCaches(*g_Config);
+        std::string fileName = g_CacheFile;
+        g_CacheWrite = std::async(std::launch::async, [data = std::move(data), fileName]()
+        {
+            std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+            file.write(data.data(), data.size());
+            return bool(file);
+        });
+    }
+
+    if (complete)
+    {
+        g_CachePrecompute = false;
+    }
+}
+
+/**
+ * @brief Precomputes the caches of one city of the given map, run from the map's update so the
+ * terrain and navmesh queries stay on the map's own thread. The map updates run in parallel on
+ * the map worker pool, so every continent fills its cities at the same time.
+ * @param map The updated map.
+ */
+void PrecomputeSiegeCityCaches(Map* map)
+{
+    uint32 currentTime = time(nullptr);
+    for (const CityData& city : g_Config->cities)
+    {
+        if (city.mapId != map->GetId())
+        {
+            continue;
+        }
+
+        if (!city.heights->built)
+        {
+            GetCityHeightCache(city, map);
+            return;
+        }
+
+        CityPathCache& paths = *city.paths;
+        if (paths.precomputed || currentTime < paths.precomputeRetryTime)
+        {
+            continue;
+        }
+
+        // The navmesh queries need a unit of the map as source, the city leader will do
+        Creature* leader = FindSiegeCityLeader(city, map, false);
+        if (!leader)
+        {
+            paths.precomputeRetryTime = currentTime + 10;
+            continue;
+        }
+
+        uint32 legCount = city.waypoints.size() + 1;
+        for (uint32 leg = 0; leg < legCount; ++leg)
+        {
+            GetCachedSiegeLeg(city, leader, leg, leg + 1);
+            GetCachedSiegeLeg(city, leader, leg + 1, leg);
+        }
+
+        paths.precomputed = true;
+        g_CacheDirty = true;
+
+        if (g_DebugMode)
+        {
+            LOG_INFO("server.loading", "[City Siege] Precomputed caches of {}", city.name);
+        }
+        return;
+    }
+}
+
+/**
+ * @brief Runs the map stages (see IsSiegeMapStage) of the sieges on one map, from that map's update.
+ *
+ * Maps are updated in parallel by the map update threads, so sieges on different maps
+ * update at the same time. Each siege is only touched by the thread of its own city map,
+ * and the world update never overlaps the map updates (MapMgr waits for all of them),
+ * so sieges are only started, ended and removed while none of this runs.
+ *
+ * @param map The map being updated.
+ * @param diff Time since the map's last update in milliseconds.
+ */
+void UpdateSiegeMapEvents(Map* map, uint32 diff)
+{
+    if (!g_MapThreadUpdates || map->GetInstanceId() != 0)
+    {
+        return;
+    }
+
+    std::vector<SiegeEvent*> sieges;
+    for (SiegeEvent& event : g_ActiveSieges)
+    {
+        if (event.isActive && GetSiegeCity(event).mapId == map->GetId())
+        {
+            sieges.push_back(&event);
+        }
+    }
+
+    if (sieges.empty())
+    {
+        return;
+    }
+
+    uint32 currentTime = time(nullptr);
+    uint32 updateStartMs = getMSTime();
+    SiegePerfScope perf(SIEGE_PERF_MAP_TICK);
+
+    // Sieges the budget cut short last time go first, so a tight budget cannot starve one
+    std::stable_partition(sieges.begin(), sieges.end(), [](const SiegeEvent* event) { return event->mapStagesDeferred; });
+    for (SiegeEvent* event : sieges)
+    {
+        event->mapStagesDeferred = !RunDueSiegeStages(*event, diff, true, updateStartMs, currentTime);
+    }
+}
+
+/**
+ * @brief Updates all active siege events.
+ *
+ * Each siege stage runs on its own interval. Once the per-tick budget is spent the
+ * remaining stages are deferred to the next world tick, and the first siege updated
+ * rotates every tick so a tight budget cannot starve the same siege. The map stages
+ * are left to UpdateSiegeMapEvents when CitySiege.Scheduler.MapThreadUpdates is on.
+ *
+ * @param diff Time since last update in milliseconds.
+ */
+void UpdateSiegeEvents(uint32 diff)
+{
+    uint32 currentTime = time(nullptr);
+    uint32 updateStartMs = getMSTime();
+
+#ifdef MOD_PLAYERBOTS
+    // Keep the recruitment candidate index fresh a few bots at a time, sieges or not
+    if (g_PlayerbotsEnabled)
+    {
+        UpdateSiegeBotCandidateIndex(g_PlayerbotsIndexBatch);
+    }
+#endif
+
+    UpdateSiegeCacheFile();
+
+    SiegePerfScope tickPerf(SIEGE_PERF_TICK);
+
+    // Update active sieges
+    size_t siegeCount = g_ActiveSieges.size();
+    for (size_t i = 0; i < siegeCount; ++i)
+    {
+        SiegeEvent& event = g_ActiveSieges[(g_SiegeUpdateCursor + i) % siegeCount];
+        if (!event.isActive)
+        {
+            UpdateSiegeTeardown(event);
+            continue;
+        }
+
+        RunDueSiegeStages(event, diff, false, updateStartMs, currentTime);
+    }
+
+    if (siegeCount > 0)
+    {
+        g_SiegeUpdateCursor = (g_SiegeUpdateCursor + 1) % siegeCount;
+        tickPerf.Finish();
+
+        // Periodic profiler summary while sieges are running
+        g_PerfLogTimer += diff;
+        if (g_PerfEnabled && g_PerfLogInterval > 0 && g_PerfLogTimer >= g_PerfLogInterval * 1000)
+        {
+            g_PerfLogTimer = 0;
+            for (const std::string& line : BuildSiegePerfReport())
+            {
+                LOG_INFO("server.loading", "[City Siege] Perf: {}", line);
+            }
+        }
+    }
+    else
+    {
+        // Idle ticks are not worth recording
+        tickPerf.Cancel();
+    }
+
+    // Clean up ended events
+    g_ActiveSieges.erase(
+        std::remove_if(g_ActiveSieges.begin(), g_ActiveSieges.end(),
+            [currentTime](const SiegeEvent& event) {
+                return !event.isActive && event.teardownStage == SIEGE_TEARDOWN_DONE && (currentTime - event.endTime) > 60;
+            }),
+        g_ActiveSieges.end()
+    );
+
+    // Check if it's time to start a new siege
+    if (currentTime >= g_NextSiegeTime)
+    {
+        StartSiegeEvent();
+        // Schedule next siege
+        uint32 nextDelay = urand(g_TimerMin, g_TimerMax);
+        g_NextSiegeTime = currentTime + nextDelay;
+
+        if (g_DebugMode)
+        {
+            LOG_INFO("server.loading", "[City Siege] Next siege scheduled in {} minutes", nextDelay / 60);
+        }
+    }
+}
+
+/**
+ * @brief Queues a dead siege creature or bot for respawning.
+ *
+ * Called from the unit death hook, which runs on the thread updating the unit's
+ * map. A siege only ever receives deaths from its own city map, and sieges are only
+ * added or removed by the world update, so the lookup reads shared state only.
+ *
+ * @param unit The unit that died.
+ * @param killer The unit that dealt the killing blow, if any.
+ */
+void HandleSiegeUnitDeath(Unit* unit, Unit* killer)
+{
+    uint32 mapId = unit->GetMapId();
+    uint32 currentTime = time(nullptr);
+
+    for (auto& event : g_ActiveSieges)
+    {
+        if (!event.isActive || GetSiegeCity(event).mapId != mapId)
+        {
+            continue;
+        }
+
+        // The city leader ends the siege on the next status check
+        if (unit->GetGUID() == event.cityLeaderGuid ||
+            (!event.cityLeaderGuid && unit->IsCreature() && unit->GetEntry() == GetSiegeCity(event).targetLeaderEntry))
+        {
+            event.cityLeaderKilled = true;
+
+            if (g_DebugMode)
+            {
+                LOG_INFO("server.loading", "[City Siege] City leader {} of {} died", unit->GetName(), GetSiegeCity(event).name);
             }
+            return;
         }
 
-        // Handle waypoint progression - check if creatures have reached their current waypoint
-        if (!event.cinematicPhase)
+        auto itr = event.unitIndex.find(unit->GetGUID());
+        if (itr == event.unitIndex.end())
         {
-            const CityData& city = g_Cities[event.cityId];
-            Map* map = sMapMgr->FindMap(city.mapId, 0);
-            if (map)
+            continue;
+        }
+
+        SiegeEvent::UnitRef const& ref = itr->second;
+
+        if (ref.isDefender)
+        {
+            event.defenderDeaths.Add();
+        }
+        else
+        {
+            event.attackerDeaths.Add();
+        }
+
+        if (ref.isBot)
+        {
+            event.botDeaths.Add();
+        }
+
+        if (killer && killer->GetCharmerOrOwnerPlayerOrPlayerItself())
+        {
+            event.playerKills.Add();
+        }
+
+        if (ref.isBot)
+        {
+#ifdef MOD_PLAYERBOTS
+            if (g_PlayerbotsEnabled)
             {
-                for (const auto& guid : event.spawnedCreatures)
-                {
-                    if (Creature* creature = map->GetCreature(guid))
-                    {
-                        // Track dead creatures for respawning
-                        if (!creature->IsAlive())
-                        {
-                            // Check if this specific creature GUID is already in the dead list (avoid duplicates)
-                            bool alreadyTracked = false;
-                            for (const auto& deadData : event.deadCreatures)
-                            {
-                                if (deadData.guid == guid)
-                                {
-                                    alreadyTracked = true;
-                                    break;
-                                }
-                            }
-                            
-                            // Add to dead creatures list if not already tracked
-                            if (!alreadyTracked && g_RespawnEnabled)
-                            {
-                                SiegeEvent::RespawnData respawnData;
-                                respawnData.guid = guid;
-                                respawnData.entry = creature->GetEntry();
-                                respawnData.deathTime = currentTime;
-                                respawnData.isDefender = false; // This is an attacker
-                                event.deadCreatures.push_back(respawnData);
-                                
-                                if (g_DebugMode)
-                                {
-                                    bool isLeader = (std::find(g_AllianceCityLeaders.begin(), g_AllianceCityLeaders.end(), respawnData.entry) != g_AllianceCityLeaders.end()) ||
-                                                   (std::find(g_HordeCityLeaders.begin(), g_HordeCityLeaders.end(), respawnData.entry) != g_HordeCityLeaders.end());
-                                    uint32 respawnTime = isLeader ? g_RespawnTimeLeader :
-                                                         respawnData.entry == g_CreatureAllianceMiniBoss || respawnData.entry == g_CreatureHordeMiniBoss ? g_RespawnTimeMiniBoss :
-                                                         respawnData.entry == g_CreatureAllianceElite || respawnData.entry == g_CreatureHordeElite ? g_RespawnTimeElite :
-                                                         g_RespawnTimeMinion;
-                                    LOG_INFO("server.loading", "[City Siege] Attacker {} (entry {}) died, will respawn at siege spawn point in {} seconds",
-                                             creature->GetGUID().ToString(), respawnData.entry, respawnTime);
-                                }
-                            }
-                            continue;
-                        }
-                        
-                        // IMPORTANT: ALWAYS set home position to current position to prevent evading/returning
-                        // This must be done continuously - even during combat - because combat reset can restore original home
-                        creature->SetHomePosition(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ(), creature->GetOrientation());
-                        
-                        // Skip movement updates if creature is currently in combat
-                        if (creature->IsInCombat())
-                            continue;
-                        
-                        // Check if creature is currently moving - if so, don't interrupt
-                        if (!creature->movespline->Finalized())
-                            continue;
-                        
-                        // Check if creature is currently moving - if so, don't interrupt
-                        if (!creature->movespline->Finalized())
-                            continue;
-                        
-                        // Force creature to ground level to prevent floating/clipping
-                        float creatureX = creature->GetPositionX();
-                        float creatureY = creature->GetPositionY();
-                        float creatureZ = creature->GetPositionZ();
-                        float groundZ = creature->GetMap()->GetHeight(creatureX, creatureY, creatureZ + 5.0f, true, 50.0f);
-                        
-                        // If ground Z is valid and creature is significantly off the ground, update position
-                        if (groundZ > INVALID_HEIGHT && std::abs(creatureZ - groundZ) > 2.0f)
-                        {
-                            creature->UpdateGroundPositionZ(creatureX, creatureY, groundZ);
-                            creature->Relocate(creatureX, creatureY, groundZ, creature->GetOrientation());
-                        }
-                        
-                        // Continuously enforce ground movement flags
-                        creature->SetDisableGravity(false);
-                        creature->SetCanFly(false);
-                        creature->SetHover(false);
-                        creature->RemoveUnitMovementFlag(MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER);
-                        
-                        // Get current waypoint index
-                        uint32 currentWP = event.creatureWaypointProgress[guid];
-                        
-                        // Check if this is a defender (marked with +10000)
-                        bool isDefender = (currentWP >= 10000);
-                        if (isDefender)
-                            currentWP -= 10000; // Remove marker to get actual waypoint
-                        
-                        // Check if we've reached final destination
-                        if (!isDefender && currentWP > city.waypoints.size())
-                            continue; // Attacker already at leader
-                        if (isDefender && currentWP == 0 && city.waypoints.empty())
-                            continue; // Defender at spawn point with no waypoints
-                        
-                        // Determine current target location
-                        float targetX, targetY, targetZ;
-                        
-                        if (isDefender)
-                        {
-                            // DEFENDERS: Move backwards through waypoints (high to low), then to spawn
-                            if (currentWP > 0 && currentWP <= city.waypoints.size())
-                            {
-                                // Moving towards a waypoint (backwards)
-                                targetX = city.waypoints[currentWP - 1].x;
-                                targetY = city.waypoints[currentWP - 1].y;
-                                targetZ = city.waypoints[currentWP - 1].z;
-                            }
-                            else if (currentWP == 0)
-                            {
-                                // At first waypoint, now go to spawn point
-                                targetX = city.spawnX;
-                                targetY = city.spawnY;
-                                targetZ = city.spawnZ;
-                            }
-                            else
-                            {
-                                continue; // Invalid state
-                            }
-                        }
-                        else
-                        {
-                            // ATTACKERS: Move forwards through waypoints (low to high), then to leader
-                            if (currentWP < city.waypoints.size())
-                            {
-                                targetX = city.waypoints[currentWP].x;
-                                targetY = city.waypoints[currentWP].y;
-                                targetZ = city.waypoints[currentWP].z;
-                            }
-                            else if (currentWP == city.waypoints.size())
-                            {
-                                targetX = city.leaderX;
-                                targetY = city.leaderY;
-                                targetZ = city.leaderZ;
-                            }
-                            else
-                            {
-                                continue;
-                            }
-                        }
-                        
-                        // Check distance to current target
-                        float dist = creature->GetDistance(targetX, targetY, targetZ);
-                        
-                        // If creature is far from target (>10 yards) and not moving, resume movement to current target
-                        if (dist > 10.0f)
-                        {
-                            // Store original waypoint Z to preserve floor height
-                            float waypointZ = targetZ;
-                            
-                            // Randomize target position to prevent bunching (X and Y only)
-                            Map* creatureMap = creature->GetMap();
-                            RandomizePosition(targetX, targetY, targetZ, creatureMap, 5.0f);
-                            
-                            // ALWAYS use the original waypoint Z coordinate to prevent underground pathing
-                            // Do NOT let the pathfinding system adjust Z to terrain/ground level
-                            targetZ = waypointZ;
-                            
-                            // Update home position before movement to prevent evading
-                            creature->SetHomePosition(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ(), creature->GetOrientation());
-                            
-                            Movement::MoveSplineInit init(creature);
-                            init.MoveTo(targetX, targetY, targetZ, true, true);
-                            init.SetWalk(false);
-                            init.Launch();
-                            continue;
-                        }
-                        
-                        // Creature is close to current target (within 10 yards), consider it reached
-                        if (dist <= 10.0f)
-                        {
-                            float nextX, nextY, nextZ;
-                            bool hasNextDestination = false;
-                            uint32 nextWP;
-                            
-                            if (isDefender)
-                            {
-                                // DEFENDERS: Move backwards (decrement waypoint)
-                                if (currentWP > 0)
-                                {
-                                    nextWP = currentWP - 1;
-                                    
-                                    if (nextWP > 0)
-                                    {
-                                        // Move to previous waypoint
-                                        nextX = city.waypoints[nextWP - 1].x;
-                                        nextY = city.waypoints[nextWP - 1].y;
-                                        nextZ = city.waypoints[nextWP - 1].z;
-                                        hasNextDestination = true;
-                                    }
-                                    else
-                                    {
-                                        // Reached first waypoint, now go to spawn
-                                        nextX = city.spawnX;
-                                        nextY = city.spawnY;
-                                        nextZ = city.spawnZ;
-                                        hasNextDestination = true;
-                                    }
-                                    
-                                    nextWP += 10000; // Re-add defender marker
-                                }
-                            }
-                            else
-                            {
-                                // ATTACKERS: Move forwards (increment waypoint)
-                                nextWP = currentWP + 1;
-                                
-                                if (nextWP < city.waypoints.size())
-                                {
-                                    // Move to next waypoint
-                                    nextX = city.waypoints[nextWP].x;
-                                    nextY = city.waypoints[nextWP].y;
-                                    nextZ = city.waypoints[nextWP].z;
-                                    hasNextDestination = true;
-                                }
-                                else if (nextWP == city.waypoints.size())
-                                {
-                                    // All waypoints complete, move to leader
-                                    nextX = city.leaderX;
-                                    nextY = city.leaderY;
-                                    nextZ = city.leaderZ;
-                                    hasNextDestination = true;
-                                }
-                            }
-                            
-                            // Update progress and start movement to next destination
-                            if (hasNextDestination)
-                            {
-                                event.creatureWaypointProgress[guid] = nextWP;
-                                
-                                // Store original waypoint Z
-                                float waypointZ = nextZ;
-                                
-                                // Randomize next position to prevent bunching (X/Y only)
-                                Map* creatureMap = creature->GetMap();
-                                RandomizePosition(nextX, nextY, nextZ, creatureMap, 5.0f);
-                                
-                                // Restore original Z coordinate to prevent underground pathing
-                                nextZ = waypointZ;
-                                
-                                // Update home position before movement to prevent evading
-                                creature->SetHomePosition(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ(), creature->GetOrientation());
-                                
-                                Movement::MoveSplineInit init(creature);
-                                init.MoveTo(nextX, nextY, nextZ, true, true);
-                                init.SetWalk(false);
-                                init.Launch();
-                            }
-                        }
-                    }
-                }
-                
-                // Check defenders for deaths (separate tracking from attackers)
-                for (const auto& guid : event.spawnedDefenders)
+                SiegeEvent::BotRespawnData respawnData;
+                respawnData.botGuid = unit->GetGUID();
+                respawnData.respawnTime = currentTime + g_PlayerbotsRespawnDelay;
+                respawnData.isDefender = ref.isDefender;
+                PushRespawnEntry(event.deadBots, respawnData);
+
+                if (g_DebugMode)
                 {
-                    if (Creature* creature = map->GetCreature(guid))
-                    {
-                        // Track dead defenders for respawning
-                        if (!creature->IsAlive())
-                        {
-                            // Check if this specific defender GUID is already in the dead list (avoid duplicates)
-                            bool alreadyTracked = false;
-                            for (const auto& deadData : event.deadCreatures)
-                            {
-                                if (deadData.guid == guid)
-                                {
-                                    alreadyTracked = true;
-                                    break;
-                                }
-                            }
-                            
-                            // Add to dead creatures list if not already tracked
-                            if (!alreadyTracked && g_RespawnEnabled)
-                            {
-                                SiegeEvent::RespawnData respawnData;
-                                respawnData.guid = guid;
-                                respawnData.entry = creature->GetEntry();
-                                respawnData.deathTime = currentTime;
-                                respawnData.isDefender = true; // This is a defender
-                                event.deadCreatures.push_back(respawnData);
-                                
-                                if (g_DebugMode)
-                                {
-                                    LOG_INFO("server.loading", "[City Siege] Defender {} (entry {}) died, will respawn near leader position in {} seconds",
-                                             creature->GetGUID().ToString(), respawnData.entry, g_RespawnTimeDefender);
-                                }
-                            }
-                            continue;
-                        }
-                        
-                        // IMPORTANT: ALWAYS set home position to current position to prevent evading/returning
-                        creature->SetHomePosition(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ(), creature->GetOrientation());
-                        
-                        // Skip movement updates if creature is currently in combat
-                        if (creature->IsInCombat())
-                            continue;
-                        
-                        // Check if creature is currently moving - if so, don't interrupt
-                        if (!creature->movespline->Finalized())
-                            continue;
-                        
-                        // Force creature to ground level
-                        float creatureX = creature->GetPositionX();
-                        float creatureY = creature->GetPositionY();
-                        float creatureZ = creature->GetPositionZ();
-                        float groundZ = creature->GetMap()->GetHeight(creatureX, creatureY, creatureZ + 5.0f, true, 50.0f);
-                        
-                        if (groundZ > INVALID_HEIGHT && std::abs(creatureZ - groundZ) > 2.0f)
-                        {
-                            creature->UpdateGroundPositionZ(creatureX, creatureY, groundZ);
-                            creature->Relocate(creatureX, creatureY, groundZ, creature->GetOrientation());
-                        }
-                        
-                        creature->SetDisableGravity(false);
-                        creature->SetCanFly(false);
-                        creature->SetHover(false);
-                        creature->RemoveUnitMovementFlag(MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER);
-                        
-                        // Get current waypoint - defenders have +10000 marker
-                        uint32 currentWP = event.creatureWaypointProgress[guid];
-                        if (currentWP < 10000)
-                            continue; // Not a defender marker, skip
-                        
-                        currentWP -= 10000; // Remove defender marker
-                        
-                        // Check if defender has reached spawn point (waypoint 0)
-                        if (currentWP == 0 && city.waypoints.empty())
-                            continue; // Already at spawn
-                        
-                        // Defenders move backwards through waypoints
-                        float targetX, targetY, targetZ;
-                        if (currentWP > 0 && currentWP <= city.waypoints.size())
-                        {
-                            // Moving towards previous waypoint
-                            targetX = city.waypoints[currentWP - 1].x;
-                            targetY = city.waypoints[currentWP - 1].y;
-                            targetZ = city.waypoints[currentWP - 1].z;
-                        }
-                        else if (currentWP == 0)
-                        {
-                            // Go to spawn point
-                            targetX = city.spawnX;
-                            targetY = city.spawnY;
-                            targetZ = city.spawnZ;
-                        }
-                        else
-                        {
-                            continue; // Invalid state
-                        }
-                        
-                        // Check distance to target
-                        float dist = creature->GetDistance(targetX, targetY, targetZ);
-                        
-                        // If far from target and not moving, resume movement
-                        if (dist > 10.0f)
-                        {
-                            // Store original waypoint Z to preserve floor height
-                            float waypointZ = targetZ;
-                            
-                            // Randomize X/Y only to prevent bunching
-                            RandomizePosition(targetX, targetY, targetZ, map, 5.0f);
-                            
-                            // ALWAYS use the original waypoint Z coordinate to prevent underground pathing
-                            targetZ = waypointZ;
-                            
-                            creature->SetHomePosition(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ(), creature->GetOrientation());
-                            
-                            Movement::MoveSplineInit init(creature);
-                            init.MoveTo(targetX, targetY, targetZ, true, true);
-                            init.SetWalk(false);
-                            init.Launch();
-                        }
-                        // If close to target waypoint, advance to next
-                        else if (dist <= 5.0f)
-                        {
-                            uint32 nextWP;
-                            float nextX, nextY, nextZ;
-                            
-                            if (currentWP > 0)
-                            {
-                                // Move to previous waypoint
-                                nextWP = currentWP - 1;
-                                if (nextWP > 0)
-                                {
-                                    nextX = city.waypoints[nextWP - 1].x;
-                                    nextY = city.waypoints[nextWP - 1].y;
-                                    nextZ = city.waypoints[nextWP - 1].z;
-                                }
-                                else
-                                {
-                                    // Go to spawn point
-                                    nextX = city.spawnX;
-                                    nextY = city.spawnY;
-                                    nextZ = city.spawnZ;
-                                }
-                            }
-                            else
-                            {
-                                continue; // Already at spawn
-                            }
-                            
-                            // Update progress with defender marker
-                            event.creatureWaypointProgress[guid] = nextWP + 10000;
-                            
-                            // Store original waypoint Z
-                            float waypointZ = nextZ;
-                            
-                            // Randomize X/Y only
-                            RandomizePosition(nextX, nextY, nextZ, map, 5.0f);
-                            
-                            // Restore original Z coordinate
-                            nextZ = waypointZ;
-                            
-                            creature->SetHomePosition(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ(), creature->GetOrientation());
-                            
-                            Movement::MoveSplineInit init(creature);
-                            init.MoveTo(nextX, nextY, nextZ, true, true);
-                            init.SetWalk(false);
-                            init.Launch();
-                        }
-                    }
+                    LOG_INFO("server.loading", "[City Siege] {} bot {} died, will respawn in {} seconds",
+                             ref.isDefender ? "Defender" : "Attacker", unit->GetName(), g_PlayerbotsRespawnDelay);
                 }
             }
+#endif
+            return;
         }
 
-        // Handle respawning of dead creatures (only during active siege, not during cinematic)
-        if (!event.cinematicPhase && g_RespawnEnabled && !event.deadCreatures.empty())
+        if (!g_RespawnEnabled)
         {
-            const CityData& city = g_Cities[event.cityId];
-            Map* map = sMapMgr->FindMap(city.mapId, 0);
-            if (map)
+            return;
+        }
+
+        SiegeUnitRole role = QueueSiegeRespawn(event, unit->GetGUID(), unit->GetEntry(), ref.slot, ref.isDefender, currentTime);
+
+        if (g_DebugMode)
+        {
+            LOG_INFO("server.loading", "[City Siege] {} {} (entry {}) died, will respawn at {} in {} seconds",
+                     ref.isDefender ? "Defender" : "Attacker", unit->GetGUID().ToString(), unit->GetEntry(),
+                     ref.isDefender ? "leader position" : "siege spawn point", GetSiegeRespawnDelay(event, role));
+        }
+        return;
+    }
+}
+
+/**
+ * @brief Adds damage taken by a city leader to the telemetry of its siege.
+ * Called from the damage hook on the thread updating the leader's map, like HandleSiegeUnitDeath.
+ * @param victim The unit that took the damage.
+ * @param damage The damage dealt.
+ */
+void HandleSiegeLeaderDamage(Unit* victim, uint32 damage)
+{
+    if (!victim->IsCreature())
+    {
+        return;
+    }
+
+    for (auto& event : g_ActiveSieges)
+    {
+        if (event.isActive && victim->GetGUID() == event.cityLeaderGuid)
+        {
+            event.leaderDamage.Add(damage);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Runs the per-tick siege work headless, on synthetic sieges without a map, creatures or players.
+ *
+ * Each synthetic siege gets unitCount units split over the formation ranks like a real army,
+ * grouped into squads, and twenty synthetic participants around the city center. Every
+ * simulated tick (one CitySiege.Scheduler.MovementInterval) runs the interest checks, a
+ * parked-style step of every unit along the waypoint path, deaths and the respawn queue, each
+ * timed on its own. These are stand-ins for the live stages, not the live code: the full unit
+ * movement update, the respawn hold logic, the wave scheduler, spline launches, pathfinding and
+ * grid work are not run, so the numbers do not predict a live tick. Use .citysiege perf on a
+ * live siege for that.
+ *
+ * @param unitCount Units per siege.
+ * @param siegeCount Number of simultaneous sieges, one per city.
+ * @param ticks Number of ticks to simulate.
+ * @return The report lines.
+ */
+std::vector<std::string> RunSiegeBenchmark(uint32 unitCount, uint32 siegeCount, uint32 ticks)
+{
+    enum BenchPhase { BENCH_SETUP, BENCH_BOT_SAMPLE, BENCH_INTEREST, BENCH_MOVEMENT, BENCH_DEATHS, BENCH_RESPAWN, BENCH_TICK, BENCH_MAX };
+    static const char* const phaseNames[BENCH_MAX] = { "setup", "bot sample", "interest", "path step", "deaths", "respawn queue", "tick" };
+    SiegePerfStats phases[BENCH_MAX];
+
+    auto elapsedUs = [](std::chrono::steady_clock::time_point start)
+    {
+        return uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    };
+
+    struct BenchUnit
+    {
+        float x, y, z, o;
+        uint32 legPoint;
+        bool alive;
+        bool inInterest;
+    };
+
+    struct BenchSiege
+    {
+        SiegeEvent event;
+        std::vector<BenchUnit> units[2]; // Attackers and defenders, indexed like creatureSlots and defenderSlots
+        std::vector<Waypoint> observers;
+    };
+
+    // Formation ranks in proportion to the configured spawn counts, all minions if none are set
+    uint32 rankTotal = 0;
+    for (const SiegeFormationRank& rank : g_FormationRanks)
+    {
+        rankTotal += GetSiegeRoleSpawnCount(rank.role);
+    }
+
+    std::vector<BenchSiege> sieges(siegeCount);
+    for (uint32 i = 0; i < siegeCount; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+        BenchSiege& siege = sieges[i];
+        SiegeEvent& event = siege.event;
+        event.config = g_Config;
+        event.cityId = static_cast<CityId>(i % g_Config->cities.size());
+        const CityData& city = GetSiegeCity(event);
+
+        for (uint32 unit = 0; unit < unitCount; ++unit)
+        {
+            SiegeUnitRole role = SIEGE_ROLE_MINION;
+            uint32 position = rankTotal ? uint32(uint64(unit) * rankTotal / unitCount) : 0;
+            for (const SiegeFormationRank& rank : g_FormationRanks)
             {
-                // Check each dead creature to see if it's time to respawn
-                for (auto it = event.deadCreatures.begin(); it != event.deadCreatures.end();)
+                uint32 count = GetSiegeRoleSpawnCount(rank.role);
+                if (position < count)
                 {
-                    const auto& respawnData = *it;
-                    
-                    // Determine respawn time based on creature type and whether it's a defender
-                    uint32 respawnDelay;
-                    
-                    if (respawnData.isDefender)
-                    {
-                        // Defenders use their own respawn time
-                        respawnDelay = g_RespawnTimeDefender;
-                    }
-                    else
-                    {
-                        // Attackers use type-based respawn times
-                        respawnDelay = g_RespawnTimeMinion; // Default
-                        bool isLeader = (std::find(g_AllianceCityLeaders.begin(), g_AllianceCityLeaders.end(), respawnData.entry) != g_AllianceCityLeaders.end()) ||
-                                       (std::find(g_HordeCityLeaders.begin(), g_HordeCityLeaders.end(), respawnData.entry) != g_HordeCityLeaders.end());
-                        if (isLeader)
-                        {
-                            respawnDelay = g_RespawnTimeLeader;
-                        }
-                        else if (respawnData.entry == g_CreatureAllianceMiniBoss || respawnData.entry == g_CreatureHordeMiniBoss)
-                        {
-                            respawnDelay = g_RespawnTimeMiniBoss;
-                        }
-                        else if (respawnData.entry == g_CreatureAllianceElite || respawnData.entry == g_CreatureHordeElite)
-                        {
-                            respawnDelay = g_RespawnTimeElite;
-                        }
-                    }
-                    
-                    // Check if enough time has passed
-                    if (currentTime >= (respawnData.deathTime + respawnDelay))
-                    {
-                        // Calculate spawn position based on whether this is a defender or attacker
-                        float spawnX, spawnY, spawnZ;
-                        
-                        if (respawnData.isDefender)
-                        {
-                            // Defenders respawn near the city leader position
-                            spawnX = city.leaderX;
-                            spawnY = city.leaderY;
-                            spawnZ = city.leaderZ;
-                            
-                            // Randomize spawn position in a circle around leader (15 yards)
-                            float angle = frand(0.0f, 2.0f * M_PI);
-                            float dist = frand(10.0f, 15.0f);
-                            spawnX += dist * cos(angle);
-                            spawnY += dist * sin(angle);
-                        }
-                        else
-                        {
-                            // Attackers respawn at the siege spawn point
-                            spawnX = city.spawnX;
-                            spawnY = city.spawnY;
-                            spawnZ = city.spawnZ;
-                        }
-                        
-                        // Get proper ground height at spawn location
-                        float groundZ = map->GetHeight(spawnX, spawnY, spawnZ, true, 50.0f);
-                        if (groundZ > INVALID_HEIGHT)
-                            spawnZ = groundZ + 0.5f;
-                        
-                        // Respawn the creature
-                        if (Creature* creature = map->SummonCreature(respawnData.entry, Position(spawnX, spawnY, spawnZ, 0)))
-                        {
-                            // Set up the respawned creature
-                            bool isAllianceCity = (event.cityId <= CITY_EXODAR);
-                            
-                            // Set level and scale based on creature type
-                            if (respawnData.isDefender)
-                            {
-                                creature->SetLevel(g_LevelDefender);
-                                // Defenders use default scale (1.0)
-                            }
-                            else
-                            {
-                                // Determine attacker level and scale by entry
-                                bool isLeader = (std::find(g_AllianceCityLeaders.begin(), g_AllianceCityLeaders.end(), respawnData.entry) != g_AllianceCityLeaders.end()) ||
-                                               (std::find(g_HordeCityLeaders.begin(), g_HordeCityLeaders.end(), respawnData.entry) != g_HordeCityLeaders.end());
-                                if (isLeader)
-                                {
-                                    creature->SetLevel(g_LevelLeader);
-                                    creature->SetObjectScale(g_ScaleLeader);
-                                }
-                                else if (respawnData.entry == g_CreatureAllianceMiniBoss || respawnData.entry == g_CreatureHordeMiniBoss)
-                                {
-                                    creature->SetLevel(g_LevelMiniBoss);
-                                    creature->SetObjectScale(g_ScaleMiniBoss);
-                                }
-                                else if (respawnData.entry == g_CreatureAllianceElite || respawnData.entry == g_CreatureHordeElite)
-                                {
-                                    creature->SetLevel(g_LevelElite);
-                                    // Elites use default scale (1.0)
-                                }
-                                else
-                                {
-                                    creature->SetLevel(g_LevelMinion);
-                                    // Minions use default scale (1.0)
-                                }
-                            }
-                            
-                            if (respawnData.isDefender)
-                            {
-                                // Defenders use city faction
-                                creature->SetFaction(isAllianceCity ? 84 : 83); // 84 = Alliance, 83 = Horde
-                                creature->SetReactState(REACT_AGGRESSIVE);
-                            }
-                            else
-                            {
-                                // Attackers use opposing faction
-                                creature->SetFaction(isAllianceCity ? 83 : 84); // 83 = Horde, 84 = Alliance
-                                
-                                // Set react state based on configuration
-                                if (g_AggroPlayers && g_AggroNPCs)
-                                {
-                                    creature->SetReactState(REACT_AGGRESSIVE);
-                                }
-                                else if (g_AggroPlayers)
-                                {
-                                    creature->SetReactState(REACT_DEFENSIVE);
-                                }
-                                else
-                                {
-                                    creature->SetReactState(REACT_DEFENSIVE);
-                                }
-                            }
-                            
-                            // Enforce ground movement
-                            creature->SetDisableGravity(false);
-                            creature->SetCanFly(false);
-                            creature->SetHover(false);
-                            creature->RemoveUnitMovementFlag(MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER);
-                            creature->UpdateGroundPositionZ(spawnX, spawnY, spawnZ);
-                            
-                            // Prevent return to home position after combat - clear motion master
-                            creature->SetWalk(false);
-                            creature->GetMotionMaster()->Clear(false);
-                            creature->GetMotionMaster()->MoveIdle();
-                            
-                            // Set home position to spawn location to prevent evading back
-                            creature->SetHomePosition(spawnX, spawnY, spawnZ, 0);
-                            
-                            // Replace the old GUID with the new one in appropriate spawned list
-                            if (respawnData.isDefender)
-                            {
-                                for (auto& spawnedGuid : event.spawnedDefenders)
-                                {
-                                    if (spawnedGuid == respawnData.guid)
-                                    {
-                                        spawnedGuid = creature->GetGUID();
-                                        break;
-                                    }
-                                }
-                            }
-                            else
-                            {
-                                for (auto& spawnedGuid : event.spawnedCreatures)
-                                {
-                                    if (spawnedGuid == respawnData.guid)
-                                    {
-                                        spawnedGuid = creature->GetGUID();
-                                        break;
-                                    }
-                                }
-                            }
-                            
-                            // Set waypoint progress and initial movement destination
-                            event.creatureWaypointProgress.erase(respawnData.guid); // Remove old GUID
-                            
-                            float destX, destY, destZ;
-                            
-                            if (respawnData.isDefender)
-                            {
-                                // Defenders start at last waypoint and move backwards
-                                uint32 startWaypoint = city.waypoints.empty() ? 0 : city.waypoints.size();
-                                event.creatureWaypointProgress[creature->GetGUID()] = startWaypoint + 10000; // Add defender marker
-                                
-                                // Start moving to last waypoint (or spawn point if no waypoints)
-                                if (!city.waypoints.empty())
-                                {
-                                    destX = city.waypoints[city.waypoints.size() - 1].x;
-                                    destY = city.waypoints[city.waypoints.size() - 1].y;
-                                    destZ = city.waypoints[city.waypoints.size() - 1].z;
-                                }
-                                else
-                                {
-                                    destX = city.spawnX;
-                                    destY = city.spawnY;
-                                    destZ = city.spawnZ;
-                                }
-                            }
-                            else
-                            {
-                                // Attackers start from waypoint 0 and move forward
-                                event.creatureWaypointProgress[creature->GetGUID()] = 0;
-                                
-                                // Start movement to first waypoint or leader
-                                if (!city.waypoints.empty())
-                                {
-                                    destX = city.waypoints[0].x;
-                                    destY = city.waypoints[0].y;
-                                    destZ = city.waypoints[0].z;
-                                }
-                                else
-                                {
-                                    destX = city.leaderX;
-                                    destY = city.leaderY;
-                                    destZ = city.leaderZ;
-                                }
-                            }
-                            
-                            // Store original Z coordinate
-                            float waypointZ = destZ;
-                            
-                            // Randomize position to prevent bunching on respawn (X/Y only)
-                            Map* creatureMap = creature->GetMap();
-                            RandomizePosition(destX, destY, destZ, creatureMap, 5.0f);
-                            
-                            // Restore original Z to prevent underground pathing
-                            destZ = waypointZ;
-                            
-                            // Update home position before movement to prevent evading
-                            creature->SetHomePosition(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ(), creature->GetOrientation());
-                            
-                            Movement::MoveSplineInit init(creature);
-                            init.MoveTo(destX, destY, destZ, true, true);
-                            init.SetWalk(false);
-                            init.Launch();
-                            
-                            if (g_DebugMode)
-                            {
-                                LOG_INFO("server.loading", "[City Siege] Respawned {} {} at {} ({}, {}, {}), starting movement to {} waypoint",
-                                         respawnData.isDefender ? "defender" : "attacker",
-                                         creature->GetGUID().ToString(),
-                                         respawnData.isDefender ? "leader position" : "siege spawn point",
-                                         spawnX, spawnY, spawnZ,
-                                         respawnData.isDefender ? "last" : "first");
-                            }
-                        }
-                        
-                        // Remove from dead creatures list
-                        it = event.deadCreatures.erase(it);
-                    }
-                    else
-                    {
-                        ++it;
-                    }
+                    role = rank.role;
+                    break;
                 }
+                position -= count;
+            }
+
+            bool isDefender = (role == SIEGE_ROLE_DEFENDER);
+            SiegeEvent::UnitSlot slot;
+            slot.role = role;
+            if (isDefender)
+            {
+                slot.progress = { uint32(city.waypoints.size()), SIEGE_MARCH_BACKWARD };
+                siege.units[1].push_back({ city.leaderX, city.leaderY, city.leaderZ, 0.0f, 0, true, true });
+                event.defenderSlots.push_back(slot);
+                event.spawnedDefenders.push_back(ObjectGuid());
             }
+            else
+            {
+                slot.progress = { 0, SIEGE_MARCH_FORWARD };
+                siege.units[0].push_back({ city.spawnX, city.spawnY, city.spawnZ, 0.0f, 0, true, true });
+                event.creatureSlots.push_back(slot);
+                event.spawnedCreatures.push_back(ObjectGuid());
+            }
+        }
+
+        BuildSiegeSquads(event);
+
+        for (uint32 observer = 0; observer < 20; ++observer)
+        {
+            siege.observers.push_back({ city.centerX + frand(-200.0f, 200.0f), city.centerY + frand(-200.0f, 200.0f), city.centerZ });
         }
 
+        AddSiegePerfSample(phases[BENCH_SETUP], elapsedUs(start));
+
 #ifdef MOD_PLAYERBOTS
-        // Handle bot death tracking and respawning
-        if (!event.cinematicPhase)
+        // Draws from the live candidate index, the drawn bots are not touched
+        if (g_PlayerbotsEnabled && g_BotCandidates.ready)
         {
-            CheckBotDeaths(event);
-            ProcessBotRespawns(event);
-            UpdateBotWaypointMovement(event);
+            start = std::chrono::steady_clock::now();
+            uint32 rejected = 0;
+            SampleSiegeBotCandidates(TEAM_ALLIANCE, g_PlayerbotsMaxDefenders, rejected);
+            SampleSiegeBotCandidates(TEAM_HORDE, g_PlayerbotsMaxAttackers, rejected);
+            AddSiegePerfSample(phases[BENCH_BOT_SAMPLE], elapsedUs(start));
         }
 #endif
+    }
+
+    uint32 tickMs = std::max<uint32>(1, g_StageIntervals[SIEGE_STAGE_MOVEMENT]);
+    float stepDistance = 7.0f * tickMs / 1000.0f; // Run speed
+    uint32 deathsPerTick = std::max<uint32>(1, unitCount / 200);
+    auto noLeg = [](uint32, uint32) { return static_cast<const Movement::PointsArray*>(nullptr); };
+
+    for (uint32 tick = 0; tick < ticks; ++tick)
+    {
+        auto tickStart = std::chrono::steady_clock::now();
+        uint32 simTime = tick * tickMs / 1000; // Seconds into the simulated siege
 
-        // Status announcements every 5 minutes (300 seconds) during active combat
-        if (!event.cinematicPhase && (currentTime - event.lastStatusAnnouncement) >= 300)
+        for (BenchSiege& siege : sieges)
         {
-            event.lastStatusAnnouncement = currentTime;
-            
-            const CityData& city = g_Cities[event.cityId];
-            Map* map = sMapMgr->FindMap(city.mapId, 0);
-            
-            // Calculate time remaining
-            uint32 timeRemaining = event.endTime > currentTime ? event.endTime - currentTime : 0;
-            uint32 minutesLeft = timeRemaining / 60;
-            
-            // Try to get leader health percentage - SEARCH FROM LEADER COORDINATES!
-            uint32 leaderHealthPct = 100;
-            bool leaderHealthAvailable = false;
-            
-            if (map)
+            SiegeEvent& event = siege.event;
+            const CityData& city = GetSiegeCity(event);
+
+            auto start = std::chrono::steady_clock::now();
+            for (SiegeEvent::SiegeSquad& squad : event.squads)
             {
-                // Search around the leader's throne coordinates directly
-                std::list<Creature*> leaderList;
-                CitySiege::CreatureEntryCheck check(city.targetLeaderEntry);
-                CitySiege::SimpleCreatureListSearcher<CitySiege::CreatureEntryCheck> searcher(leaderList, check);
-                Cell::VisitObjects(city.leaderX, city.leaderY, map, searcher, 100.0f);
-                
-                // Find the leader at the throne
-                for (Creature* leader : leaderList)
-                {
-                    if (leader && leader->IsAlive())
-                    {
-                        leaderHealthPct = leader->GetHealthPct();
-                        leaderHealthAvailable = true;
-                        break;
-                    }
-                }
+                const BenchUnit& leader = siege.units[squad.isDefender][squad.slots[squad.leader]];
+                squad.inInterest = !g_InterestEnabled || !leader.alive || IsSiegeObserverNear(siege.observers, leader.x, leader.y);
             }
-            
-            // Build announcement message
-            std::string statusMsg = "|cffff0000[City Siege]|r |cffFFFF00STATUS UPDATE:|r ";
-            statusMsg += city.name + " siege - ";
-            statusMsg += std::to_string(minutesLeft) + " minutes remaining. ";
-            
-            if (leaderHealthAvailable)
+            for (uint8 side = 0; side < 2; ++side)
             {
-                statusMsg += "Leader health: |cff";
-                // Color code based on health
-                if (leaderHealthPct > 75)
-                    statusMsg += "00FF00"; // Green
-                else if (leaderHealthPct > 50)
-                    statusMsg += "FFFF00"; // Yellow
-                else if (leaderHealthPct > 25)
-                    statusMsg += "FF8800"; // Orange
-                else
-                    statusMsg += "FF0000"; // Red
-                    
-                statusMsg += std::to_string(leaderHealthPct) + "%|r";
-                
-                // Add dramatic messages for critical health
-                if (leaderHealthPct <= 25)
-                {
-                    statusMsg += " |cffFF0000CRITICAL!|r The city leader is in grave danger!";
-                }
-                else if (leaderHealthPct <= 50)
+                const std::vector<int32>& unitSquads = side ? event.defenderSquads : event.creatureSquads;
+                for (uint32 slot = 0; slot < siege.units[side].size(); ++slot)
                 {
-                    statusMsg += " The city leader is under heavy assault!";
+                    BenchUnit& unit = siege.units[side][slot];
+                    if (!unit.alive)
+                        continue;
+
+                    unit.inInterest = !g_InterestEnabled ||
+                        (unitSquads[slot] >= 0 ? event.squads[unitSquads[slot]].inInterest : IsSiegeObserverNear(siege.observers, unit.x, unit.y));
                 }
             }
-            else
+            AddSiegePerfSample(phases[BENCH_INTEREST], elapsedUs(start));
+
+            start = std::chrono::steady_clock::now();
+            for (uint8 side = 0; side < 2; ++side)
             {
-                statusMsg += "Leader status: Unknown (not in combat yet)";
+                for (uint32 slot = 0; slot < siege.units[side].size(); ++slot)
+                {
+                    BenchUnit& unit = siege.units[side][slot];
+                    if (unit.alive)
+                    {
+                        StepAlongSiegePath(city, noLeg, GetSiegeUnitSlot(event, slot, side).progress, unit.legPoint,
+                            unit.x, unit.y, unit.z, unit.o, stepDistance);
+                    }
+                }
             }
-            
-            // Add time warning if less than 10 minutes left
-            if (minutesLeft <= 5 && minutesLeft > 0)
+            AddSiegePerfSample(phases[BENCH_MOVEMENT], elapsedUs(start));
+
+            start = std::chrono::steady_clock::now();
+            for (uint32 death = 0; death < deathsPerTick; ++death)
             {
-                statusMsg += " |cffFFFF00FINAL MINUTES!|r";
+                bool isDefender = !siege.units[1].empty() && (siege.units[0].empty() || urand(0, 4) == 0);
+                std::vector<BenchUnit>& units = siege.units[isDefender];
+                if (units.empty())
+                    continue;
+
+                uint32 slot = urand(0, units.size() - 1);
+                if (!units[slot].alive)
+                    continue;
+
+                units[slot].alive = false;
+                SiegeEvent::UnitSlot& unitSlot = GetSiegeUnitSlot(event, slot, isDefender);
+                unitSlot.awaitingRespawn = true;
+
+                SiegeEvent::RespawnData respawnData;
+                respawnData.entry = 0;
+                respawnData.slot = slot;
+                respawnData.role = unitSlot.role;
+                respawnData.respawnTime = simTime + GetSiegeRoleRespawnTime(unitSlot.role);
+                respawnData.isDefender = isDefender;
+                PushRespawnEntry(event.deadCreatures, respawnData);
             }
-            
-            sWorldSessionMgr->SendServerMessage(SERVER_MSG_STRING, statusMsg);
-        }
+            AddSiegePerfSample(phases[BENCH_DEATHS], elapsedUs(start));
 
-        // Check if city leader is dead (attackers win)
-        if (!event.cinematicPhase)
-        {
-            const CityData& city = g_Cities[event.cityId];
-            Map* map = sMapMgr->FindMap(city.mapId, 0);
-            if (map)
+            start = std::chrono::steady_clock::now();
+            SiegeEvent::RespawnData respawnData;
+            while (PopDueRespawnEntry(event.deadCreatures, simTime, respawnData))
             {
-                // Search around the leader's throne coordinates directly - no dependency on siege creatures!
-                std::list<Creature*> leaderList;
-                CitySiege::CreatureEntryCheck check(city.targetLeaderEntry);
-                CitySiege::SimpleCreatureListSearcher<CitySiege::CreatureEntryCheck> searcher(leaderList, check);
-                Cell::VisitObjects(city.leaderX, city.leaderY, map, searcher, 100.0f);
-                
-                bool leaderFound = false;
-                bool leaderAlive = false;
-                
-                // Check if we found the leader at the throne
-                for (Creature* leader : leaderList)
+                BenchUnit& unit = siege.units[respawnData.isDefender][respawnData.slot];
+                SiegeEvent::UnitSlot& unitSlot = GetSiegeUnitSlot(event, respawnData.slot, respawnData.isDefender);
+                unitSlot.awaitingRespawn = false;
+                unit.alive = true;
+                unit.legPoint = 0;
+                if (respawnData.isDefender)
                 {
-                    if (leader)
-                    {
-                        leaderFound = true;
-                        leaderAlive = leader->IsAlive();
-                        break;
-                    }
+                    unitSlot.progress = { uint32(city.waypoints.size()), SIEGE_MARCH_BACKWARD };
+                    unit.x = city.leaderX;
+                    unit.y = city.leaderY;
+                    unit.z = city.leaderZ;
                 }
-                
-                // Only end siege if we actually FOUND the leader and they are DEAD
-                if (leaderFound && !leaderAlive)
+                else
                 {
-                    if (g_DebugMode)
-                    {
-                        LOG_INFO("server.loading", "[City Siege] City leader killed! Attackers win. Ending siege of {}", city.name);
-                    }
-                    
-                    // Determine winning team: opposite of the city's faction
-                    bool isAllianceCity = (event.cityId <= CITY_EXODAR);
-                    int winningTeam = isAllianceCity ? 1 : 0; // 0 = Alliance, 1 = Horde
-                    
-                    EndSiegeEvent(event, winningTeam);
+                    unitSlot.progress = { 0, SIEGE_MARCH_FORWARD };
+                    unit.x = city.spawnX;
+                    unit.y = city.spawnY;
+                    unit.z = city.spawnZ;
                 }
             }
+            AddSiegePerfSample(phases[BENCH_RESPAWN], elapsedUs(start));
         }
 
-        // Check if city leader has died (attackers win immediately)
-        if (!event.cinematicPhase && event.cityLeaderGuid)
+        AddSiegePerfSample(phases[BENCH_TICK], elapsedUs(tickStart));
+    }
+
+    uint32 squadCount = 0;
+    uint32 parkedCount = 0;
+    for (const BenchSiege& siege : sieges)
+    {
+        squadCount += siege.event.squads.size();
+        for (const std::vector<BenchUnit>& units : siege.units)
         {
-            const CityData& city = g_Cities[event.cityId];
-            Map* map = sMapMgr->FindMap(city.mapId, 0);
-            
-            if (map)
+            for (const BenchUnit& unit : units)
             {
-                Creature* cityLeader = map->GetCreature(event.cityLeaderGuid);
-                
-                if (!cityLeader || !cityLeader->IsAlive())
-                {
-                    if (g_DebugMode)
-                    {
-                        LOG_INFO("server.loading", "[City Siege] City leader has been killed! Attackers win the siege of {}!", city.name);
-                    }
-                    
-                    // Determine winning team (attackers = opposite of city faction)
-                    bool isAllianceCity = (event.cityId == CITY_STORMWIND || event.cityId == CITY_IRONFORGE || 
-                                          event.cityId == CITY_DARNASSUS || event.cityId == CITY_EXODAR);
-                    int winningTeam = isAllianceCity ? 1 : 0; // Opposite faction wins
-                    
-                    EndSiegeEvent(event, winningTeam);
-                    continue; // Skip to next event since this one just ended
-                }
+                if (unit.alive && !unit.inInterest)
+                    parkedCount++;
             }
         }
-
-        // Check if event should end (time limit reached - defenders win)
-        if (currentTime >= event.endTime)
-        {
-            EndSiegeEvent(event);
-        }
     }
 
-    // Clean up ended events
-    g_ActiveSieges.erase(
-        std::remove_if(g_ActiveSieges.begin(), g_ActiveSieges.end(),
-            [currentTime](const SiegeEvent& event) {
-                return !event.isActive && (currentTime - event.endTime) > 60;
-            }),
-        g_ActiveSieges.end()
-    );
+    std::vector<std::string> lines;
+    char line[256];
+    snprintf(line, sizeof(line), "%u siege(s) x %u units, %u ticks of %u ms (%u s of siege time), %u squads, %u units parked at the end",
+        siegeCount, unitCount, ticks, tickMs, ticks * tickMs / 1000, squadCount, parkedCount);
+    lines.push_back(line);
 
-    // Check if it's time to start a new siege
-    if (currentTime >= g_NextSiegeTime)
+    for (uint8 phase = 0; phase < BENCH_MAX; ++phase)
     {
-        StartSiegeEvent();
-        // Schedule next siege
-        uint32 nextDelay = urand(g_TimerMin, g_TimerMax);
-        g_NextSiegeTime = currentTime + nextDelay;
-
-        if (g_DebugMode)
+        if (phases[phase].calls)
         {
-            LOG_INFO("server.loading", "[City Siege] Next siege scheduled in {} minutes", nextDelay / 60);
+            lines.push_back(FormatSiegePerfLine(phaseNames[phase], phases[phase]));
         }
     }
+
+    return lines;
 }
 
 // -----------------------------------------------------------------------------
@@ -4055,6 +6770,11 @@ public:
             return;
         }
 
+        if (g_AdaptiveEnabled)
+        {
+            SampleSiegeWorldDiff(diff);
+        }
+
         UpdateSiegeEvents(diff);
     }
 
@@ -4063,10 +6783,14 @@ public:
         // Clean up any active sieges
         for (auto& event : g_ActiveSieges)
         {
-            if (event.isActive)
+            // Includes ended sieges whose teardown has not finished yet
+            if (event.isActive || event.teardownStage != SIEGE_TEARDOWN_DONE)
             {
                 DespawnSiegeCreatures(event);
             }
+
+            // Mails and results of a teardown cut short, with whatever was rewarded so far
+            SaveSiegeResult(event);
         }
         g_ActiveSieges.clear();
 
@@ -4074,6 +6798,64 @@ public:
     }
 };
 
+/**
+ * @brief AllMapScript that runs the creature work of each siege from its city map's update.
+ */
+class CitySiegeMapScript : public AllMapScript
+{
+public:
+    CitySiegeMapScript() : AllMapScript("CitySiegeMapScript", { ALLMAPHOOK_ON_MAP_UPDATE }) { }
+
+    void OnMapUpdate(Map* map, uint32 diff) override
+    {
+        if (!g_CitySiegeEnabled)
+        {
+            return;
+        }
+
+        if (g_CachePrecompute && map->GetInstanceId() == 0)
+        {
+            PrecomputeSiegeCityCaches(map);
+        }
+
+        if (g_ActiveSieges.empty())
+        {
+            return;
+        }
+
+        UpdateSiegeMapEvents(map, diff);
+    }
+};
+
+/**
+ * @brief UnitScript that feeds siege unit deaths into the respawn queues.
+ */
+class CitySiegeUnitScript : public UnitScript
+{
+public:
+    CitySiegeUnitScript() : UnitScript("CitySiegeUnitScript", true, { UNITHOOK_ON_UNIT_DEATH, UNITHOOK_ON_DAMAGE }) { }
+
+    void OnUnitDeath(Unit* unit, Unit* killer) override
+    {
+        if (!g_CitySiegeEnabled || g_ActiveSieges.empty())
+        {
+            return;
+        }
+
+        HandleSiegeUnitDeath(unit, killer);
+    }
+
+    void OnDamage(Unit* /*attacker*/, Unit* victim, uint32& damage) override
+    {
+        if (!g_TelemetryEnabled || g_ActiveSieges.empty() || !damage)
+        {
+            return;
+        }
+
+        HandleSiegeLeaderDamage(victim, damage);
+    }
+};
+
 // -----------------------------------------------------------------------------
 // COMMAND SCRIPT
 // -----------------------------------------------------------------------------
@@ -4098,6 +6880,9 @@ public:
             { "waypoints",    HandleCitySiegeWaypointsCommand,    SEC_GAMEMASTER, Console::No },
             { "distance",     HandleCitySiegeDistanceCommand,     SEC_GAMEMASTER, Console::No },
             { "info",         HandleCitySiegeInfoCommand,         SEC_GAMEMASTER, Console::No },
+            { "perf",         HandleCitySiegePerfCommand,         SEC_GAMEMASTER, Console::No },
+            { "stats",        HandleCitySiegeStatsCommand,        SEC_GAMEMASTER, Console::Yes },
+            { "bench",        HandleCitySiegeBenchCommand,        SEC_ADMINISTRATOR, Console::Yes },
             { "reload",       HandleCitySiegeReloadCommand,       SEC_ADMINISTRATOR, Console::No }
         };
 
@@ -4124,9 +6909,9 @@ public:
             std::string cityName = *cityNameArg;
             std::transform(cityName.begin(), cityName.end(), cityName.begin(), ::tolower);
 
-            for (int i = 0; i < CITY_MAX; ++i)
+            for (int i = 0; i < int(g_Config->cities.size()); ++i)
             {
-                std::string compareName = g_Cities[i].name;
+                std::string compareName = g_Config->cities[i].name;
                 std::transform(compareName.begin(), compareName.end(), compareName.begin(), ::tolower);
                 if (compareName == cityName)
                 {
@@ -4142,9 +6927,9 @@ public:
             }
 
             // Check if city is enabled
-            if (!g_CityEnabled[g_Cities[cityId].name])
+            if (!g_Config->cityEnabled.test(cityId))
             {
-                handler->PSendSysMessage(("City '" + g_Cities[cityId].name + "' is disabled in configuration.").c_str());
+                handler->PSendSysMessage(("City '" + g_Config->cities[cityId].name + "' is disabled in configuration.").c_str());
                 return true;
             }
         }
@@ -4156,7 +6941,7 @@ public:
             {
                 if (event.isActive && event.cityId == cityId)
                 {
-                    handler->PSendSysMessage(("City '" + g_Cities[cityId].name + "' is already under siege!").c_str());
+                    handler->PSendSysMessage(("City '" + g_Config->cities[cityId].name + "' is already under siege!").c_str());
                     return true;
                 }
             }
@@ -4217,9 +7002,9 @@ public:
             std::string cityName = *cityNameArg;
             std::transform(cityName.begin(), cityName.end(), cityName.begin(), ::tolower);
 
-            for (int i = 0; i < CITY_MAX; ++i)
+            for (int i = 0; i < int(g_Config->cities.size()); ++i)
             {
-                std::string compareName = g_Cities[i].name;
+                std::string compareName = g_Config->cities[i].name;
                 std::transform(compareName.begin(), compareName.end(), compareName.begin(), ::tolower);
                 if (compareName == cityName)
                 {
@@ -4248,7 +7033,7 @@ public:
             {
                 found = true;
                 
-                const CityData& city = g_Cities[cityId];
+                const CityData& city = GetSiegeCity(event);
                 
                 // Determine winning team (0 = Alliance, 1 = Horde)
                 int winningTeam = allianceWins ? 0 : 1;
@@ -4256,11 +7041,9 @@ public:
                 // Announce winner to world or in range
                 std::string winnerAnnouncement;
                 std::string winningFaction = allianceWins ? "Alliance" : "Horde";
-                bool isAllianceCity = (cityId == CITY_STORMWIND || cityId == CITY_IRONFORGE || 
-                                      cityId == CITY_DARNASSUS || cityId == CITY_EXODAR);
                 
                 // Check if winners were defenders or attackers
-                bool defendersWon = (allianceWins && isAllianceCity) || (!allianceWins && !isAllianceCity);
+                bool defendersWon = (allianceWins ? TEAM_ALLIANCE : TEAM_HORDE) == city.team;
                 
                 if (defendersWon)
                 {
@@ -4272,35 +7055,19 @@ public:
                 }
                 
                 // Announce to world or in range
-                if (g_AnnounceRadius == 0)
-                {
-                    sWorldSessionMgr->SendServerMessage(SERVER_MSG_STRING, winnerAnnouncement);
-                }
-                else
-                {
-                    Map* map = sMapMgr->FindMap(city.mapId, 0);
-                    if (map)
-                    {
-                        Map::PlayerList const& players = map->GetPlayers();
-                        for (auto itr = players.begin(); itr != players.end(); ++itr)
-                        {
-                            if (Player* player = itr->GetSource())
-                            {
-                                if (player->GetDistance(city.centerX, city.centerY, city.centerZ) <= g_AnnounceRadius)
-                                {
-                                    ChatHandler(player->GetSession()).PSendSysMessage(winnerAnnouncement.c_str());
-                                }
-                            }
-                        }
-                    }
-                }
+                RefreshSiegeParticipants(event);
+                SendSiegeMessage(event, winnerAnnouncement);
                 
                 // Distribute rewards to winning faction's players
+                BeginSiegeResult(event, winningTeam, defendersWon);
                 DistributeRewards(event, city, winningTeam);
+                SaveSiegeResult(event);
                                 
                 // Clean up
                 DespawnSiegeCreatures(event);
+                DeactivatePlayerbotsFromSiege(event);
                 event.isActive = false;
+                event.teardownStage = SIEGE_TEARDOWN_DONE;
                 
                 break;
             }
@@ -4308,14 +7075,14 @@ public:
 
         if (!found)
         {
-            handler->PSendSysMessage(("No active siege in " + g_Cities[cityId].name).c_str());
+            handler->PSendSysMessage(("No active siege in " + g_Config->cities[cityId].name).c_str());
         }
         else
         {
             // Remove inactive events
             g_ActiveSieges.erase(
                 std::remove_if(g_ActiveSieges.begin(), g_ActiveSieges.end(),
-                    [](const SiegeEvent& event) { return !event.isActive; }),
+                    [](const SiegeEvent& event) { return !event.isActive && event.teardownStage == SIEGE_TEARDOWN_DONE; }),
                 g_ActiveSieges.end());
         }
 
@@ -4330,9 +7097,9 @@ public:
             std::string cityName = *cityNameArg;
             std::transform(cityName.begin(), cityName.end(), cityName.begin(), ::tolower);
 
-            for (int i = 0; i < CITY_MAX; ++i)
+            for (int i = 0; i < int(g_Config->cities.size()); ++i)
             {
-                std::string compareName = g_Cities[i].name;
+                std::string compareName = g_Config->cities[i].name;
                 std::transform(compareName.begin(), compareName.end(), compareName.begin(), ::tolower);
                 if (compareName == cityName)
                 {
@@ -4355,8 +7122,13 @@ public:
             if (cityId == -1 || event.cityId == cityId)
             {
                 DespawnSiegeCreatures(event);
+                DeactivatePlayerbotsFromSiege(event);
+
+                // Mails and results of a teardown cut short, with whatever was rewarded so far
+                SaveSiegeResult(event);
                 event.isActive = false;
-                handler->PSendSysMessage(("Cleaned up siege creatures in " + g_Cities[event.cityId].name).c_str());
+                event.teardownStage = SIEGE_TEARDOWN_DONE;
+                handler->PSendSysMessage(("Cleaned up siege creatures in " + GetSiegeCity(event).name).c_str());
                 cleanedCount++;
 
                 if (cityId != -1)
@@ -4373,7 +7145,7 @@ public:
             // Remove inactive events
             g_ActiveSieges.erase(
                 std::remove_if(g_ActiveSieges.begin(), g_ActiveSieges.end(),
-                    [](const SiegeEvent& event) { return !event.isActive; }),
+                    [](const SiegeEvent& event) { return !event.isActive && event.teardownStage == SIEGE_TEARDOWN_DONE; }),
                 g_ActiveSieges.end());
         }
 
@@ -4384,7 +7156,7 @@ public:
     {
         handler->PSendSysMessage("=== City Siege Status ===");
         handler->PSendSysMessage(("Module Enabled: " + std::string(g_CitySiegeEnabled ? "Yes" : "No")).c_str());
-        handler->PSendSysMessage(("Active Sieges: " + std::to_string(g_ActiveSieges.size())).c_str());
+        handler->PSendSysMessage("Active Sieges: {}", g_ActiveSieges.size());
 
         if (!g_ActiveSieges.empty())
         {
@@ -4393,7 +7165,7 @@ public:
             {
                 if (event.isActive)
                 {
-                    const CityData& city = g_Cities[event.cityId];
+                    const CityData& city = GetSiegeCity(event);
                     uint32 currentTime = time(nullptr);
                     uint32 remaining = event.endTime > currentTime ? (event.endTime - currentTime) : 0;
                     
@@ -4401,6 +7173,57 @@ public:
                     snprintf(siegeInfo, sizeof(siegeInfo), "  %s - %zu creatures, %u minutes remaining",
                         city.name.c_str(), event.spawnedCreatures.size(), remaining / 60);
                     handler->PSendSysMessage(siegeInfo);
+
+                    if (g_WavesEnabled)
+                    {
+                        char waveInfo[256];
+                        snprintf(waveInfo, sizeof(waveInfo), "    Wave %u of %zu", event.wavesSent, event.waveEnds.size());
+                        handler->PSendSysMessage(waveInfo);
+                    }
+
+                    if (g_AdaptiveEnabled)
+                    {
+                        char scaleInfo[256];
+                        snprintf(scaleInfo, sizeof(scaleInfo), "    Army scale: %.2f (%u real players, world diff %.1f ms)",
+                            event.armyScale, event.realParticipants, g_WorldDiffAverage);
+                        handler->PSendSysMessage(scaleInfo);
+                    }
+
+                    if (g_InterestEnabled)
+                    {
+                        uint32 parked = 0;
+                        for (const std::vector<SiegeEvent::UnitSlot>* slots : { &event.creatureSlots, &event.defenderSlots })
+                        {
+                            for (const SiegeEvent::UnitSlot& unitSlot : *slots)
+                            {
+                                if (unitSlot.parked && !unitSlot.awaitingRespawn)
+                                    parked++;
+                            }
+                        }
+
+                        char parkedInfo[256];
+                        snprintf(parkedInfo, sizeof(parkedInfo), "    Parked units: %u (no participant within %.0f yards)",
+                            parked, g_InterestRadius);
+                        handler->PSendSysMessage(parkedInfo);
+                    }
+
+                    if (g_StuckTimeout)
+                    {
+                        uint32 retrying = 0;
+                        for (const std::vector<SiegeEvent::UnitSlot>* slots : { &event.creatureSlots, &event.defenderSlots })
+                        {
+                            for (const SiegeEvent::UnitSlot& unitSlot : *slots)
+                            {
+                                if (unitSlot.retries && !unitSlot.awaitingRespawn)
+                                    retrying++;
+                            }
+                        }
+
+                        char stuckInfo[256];
+                        snprintf(stuckInfo, sizeof(stuckInfo), "    Stuck units: %u retrying, %u recovered",
+                            retrying, event.stuckRecoveries.Get());
+                        handler->PSendSysMessage(stuckInfo);
+                    }
                     
                     // Show leader status
                     if (event.cityLeaderGuid)
@@ -4445,7 +7268,7 @@ public:
             if (g_NextSiegeTime > currentTime)
             {
                 uint32 timeUntilNext = g_NextSiegeTime - currentTime;
-                handler->PSendSysMessage(("Next auto-siege in: " + std::to_string(timeUntilNext / 60) + " minutes").c_str());
+                handler->PSendSysMessage("Next auto-siege in: {} minutes", timeUntilNext / 60);
             }
         }
 
@@ -4531,9 +7354,9 @@ public:
         std::transform(cityName.begin(), cityName.end(), cityName.begin(), ::tolower);
 
         int cityId = -1;
-        for (size_t i = 0; i < g_Cities.size(); ++i)
+        for (size_t i = 0; i < g_Config->cities.size(); ++i)
         {
-            std::string checkName = g_Cities[i].name;
+            std::string checkName = g_Config->cities[i].name;
             std::transform(checkName.begin(), checkName.end(), checkName.begin(), ::tolower);
             if (checkName == cityName)
             {
@@ -4548,7 +7371,7 @@ public:
             return true;
         }
 
-        const CityData& city = g_Cities[cityId];
+        const CityData& city = g_Config->cities[cityId];
         Map* map = sMapMgr->FindMap(city.mapId, 0);
         if (!map)
         {
@@ -4830,23 +7653,26 @@ public:
             return true;
         }
 
-        const CityData& city = g_Cities[activeSiege->cityId];
+        const CityData& city = GetSiegeCity(*activeSiege);
 
-        // Get waypoint progress
-        auto it = activeSiege->creatureWaypointProgress.find(unitGuid);
-        if (it == activeSiege->creatureWaypointProgress.end())
+        // Get waypoint progress - bots are tracked by GUID, creatures in their slot
+        uint32 currentWP = 0;
+        auto it = activeSiege->botWaypointProgress.find(unitGuid);
+        auto ref = activeSiege->unitIndex.find(unitGuid);
+        if (isPlayerBot && it != activeSiege->botWaypointProgress.end())
+        {
+            currentWP = it->second.waypoint;
+        }
+        else if (isCreature && ref != activeSiege->unitIndex.end())
+        {
+            currentWP = GetSiegeUnitSlot(*activeSiege, ref->second.slot, isDefender).progress.waypoint;
+        }
+        else
         {
             handler->PSendSysMessage("Selected unit has no waypoint progress data.");
             return true;
         }
 
-        uint32 currentWP = it->second;
-
-        // Check if this is a defender (marked with +10000)
-        bool isDefenderMarker = (currentWP >= 10000);
-        if (isDefenderMarker)
-            currentWP -= 10000; // Remove marker to get actual waypoint
-
         // Determine current target location
         float targetX, targetY, targetZ;
         std::string targetDescription;
@@ -4929,6 +7755,113 @@ public:
         return true;
     }
 
+    static bool HandleCitySiegePerfCommand(ChatHandler* handler, Optional<std::string> actionArg)
+    {
+        if (actionArg && (*actionArg == "reset" || *actionArg == "RESET"))
+        {
+            ResetSiegePerf();
+            handler->PSendSysMessage("|cff00ff00[City Siege]|r Profiler data cleared.");
+            return true;
+        }
+
+        handler->PSendSysMessage("=== City Siege Profiler ===");
+        if (!g_PerfEnabled)
+        {
+            handler->PSendSysMessage("Profiler is disabled (CitySiege.Perf.Enabled = 0).");
+            return true;
+        }
+
+        std::vector<std::string> lines = BuildSiegePerfReport();
+        if (lines.empty())
+        {
+            handler->PSendSysMessage("No data yet - start a siege first.");
+            return true;
+        }
+
+        for (const std::string& line : lines)
+        {
+            handler->PSendSysMessage(line.c_str());
+        }
+        handler->PSendSysMessage("Percentiles cover the last 1024 calls of each section. Use '.citysiege perf reset' to clear.");
+        return true;
+    }
+
+    static bool HandleCitySiegeStatsCommand(ChatHandler* handler, Optional<std::string> cityNameArg)
+    {
+        handler->PSendSysMessage("=== City Siege Telemetry ===");
+        if (!g_TelemetryEnabled)
+        {
+            handler->PSendSysMessage("Telemetry is disabled (CitySiege.Telemetry.Enabled = 0).");
+            return true;
+        }
+
+        std::string cityName = cityNameArg.value_or("");
+        std::transform(cityName.begin(), cityName.end(), cityName.begin(), ::tolower);
+
+        bool found = false;
+        for (const SiegeEvent& event : g_ActiveSieges)
+        {
+            const CityData& city = GetSiegeCity(event);
+            if (!cityName.empty())
+            {
+                std::string compareName = city.name;
+                std::transform(compareName.begin(), compareName.end(), compareName.begin(), ::tolower);
+                if (compareName != cityName)
+                    continue;
+            }
+            found = true;
+
+            handler->PSendSysMessage("{} ({}): {} attacker and {} defender deaths, {} bot deaths, {} player kills, {} respawns, {} leader damage",
+                city.name, event.isActive ? "running" : "ended", event.attackerDeaths.Get(), event.defenderDeaths.Get(),
+                event.botDeaths.Get(), event.playerKills.Get(), event.respawns.Get(), event.leaderDamage.Get());
+            handler->PSendSysMessage("Participants: {} Alliance, {} Horde", event.allianceParticipants, event.hordeParticipants);
+
+            // The latest samples, oldest first
+            uint32 shown = std::min<uint32>(event.telemetrySamples, 10);
+            if (shown)
+            {
+                handler->PSendSysMessage("Every {}s - time: deaths att/def, bots, kills, respawns, leader damage, Alliance/Horde, waypoint avg (front)", g_TelemetryInterval);
+            }
+            for (uint32 i = event.telemetrySamples - shown; i < event.telemetrySamples; ++i)
+            {
+                const SiegeTelemetrySample& sample = event.telemetry[i % SIEGE_TELEMETRY_SAMPLES];
+                handler->PSendSysMessage("  {:>5}s: {}/{}, {}, {}, {}, {}, {}/{}, {:.1f} ({})",
+                    sample.elapsed, sample.attackerDeaths, sample.defenderDeaths, sample.botDeaths, sample.playerKills,
+                    sample.respawns, sample.leaderDamage, sample.allianceParticipants, sample.hordeParticipants,
+                    sample.waypointAverage, sample.waypointFront);
+            }
+        }
+
+        if (!found)
+        {
+            handler->PSendSysMessage(cityName.empty() ? "No sieges running." : "No siege running in that city.");
+        }
+        return true;
+    }
+
+    static bool HandleCitySiegeBenchCommand(ChatHandler* handler, Optional<uint32> unitsArg, Optional<uint32> siegesArg, Optional<uint32> ticksArg)
+    {
+        uint32 units = std::clamp<uint32>(unitsArg.value_or(100), 1, 5000);
+        uint32 sieges = std::clamp<uint32>(siegesArg.value_or(1), 1, g_Config->cities.size());
+        uint32 ticks = std::clamp<uint32>(ticksArg.value_or(200), 1, 10000);
+
+        // The benchmark runs synchronously on the world thread, keep a run to a fraction of a second
+        if (uint64(units) * sieges * ticks > 1000000)
+        {
+            handler->PSendSysMessage("|cffff0000[City Siege]|r Too much work for one run (units x sieges x ticks must stay below 1,000,000).");
+            return true;
+        }
+
+        handler->PSendSysMessage("=== City Siege Benchmark ===");
+        for (const std::string& line : RunSiegeBenchmark(units, sieges, ticks))
+        {
+            handler->PSendSysMessage(line.c_str());
+        }
+        handler->PSendSysMessage("Synthetic stand-ins for the siege stages: the live movement update, respawn holds, waves, "
+            "spline movement, pathfinding and grid updates are not included. Use .citysiege perf on a live siege for real tick costs.");
+        return true;
+    }
+
     static bool HandleCitySiegeReloadCommand(ChatHandler* handler)
     {
         handler->PSendSysMessage("|cff00ff00[City Siege]|r Reloading configuration from mod_city_siege.conf...");
@@ -4940,7 +7873,7 @@ public:
         LoadCitySiegeConfiguration();
         
         handler->PSendSysMessage("|cff00ff00[City Siege]|r Configuration reloaded successfully!");
-        handler->PSendSysMessage("Note: Active sieges will continue with old settings. New sieges will use the updated configuration.");
+        handler->PSendSysMessage("Note: Active sieges keep the cities and waypoints they started with. Other settings apply right away.");
         
         // Display some key settings
         char msg[512];
@@ -4953,7 +7886,7 @@ public:
         
         // Show waypoint counts
         handler->PSendSysMessage("Waypoints loaded:");
-        for (const auto& city : g_Cities)
+        for (const auto& city : g_Config->cities)
         {
             if (!city.waypoints.empty())
             {
@@ -4984,7 +7917,7 @@ public:
         if (!cityNameArg)
         {
             handler->PSendSysMessage("|cff00ff00[City Siege]|r Distance to city centers:");
-            for (const auto& city : g_Cities)
+            for (const auto& city : g_Config->cities)
             {
                 float distance = player->GetDistance(city.centerX, city.centerY, city.centerZ);
                 char msg[256];
@@ -4996,27 +7929,30 @@ public:
         }
 
         // Find specific city
-        CityId cityId = CITY_STORMWIND;
         std::string cityName = *cityNameArg;
         
         // Convert to lowercase for comparison
         std::transform(cityName.begin(), cityName.end(), cityName.begin(), ::tolower);
         
-        if (cityName == "stormwind") cityId = CITY_STORMWIND;
-        else if (cityName == "ironforge") cityId = CITY_IRONFORGE;
-        else if (cityName == "darnassus") cityId = CITY_DARNASSUS;
-        else if (cityName == "exodar") cityId = CITY_EXODAR;
-        else if (cityName == "orgrimmar") cityId = CITY_ORGRIMMAR;
-        else if (cityName == "undercity") cityId = CITY_UNDERCITY;
-        else if (cityName == "thunderbluff") cityId = CITY_THUNDERBLUFF;
-        else if (cityName == "silvermoon") cityId = CITY_SILVERMOON;
-        else
+        int cityId = -1;
+        for (size_t i = 0; i < g_Config->cities.size(); ++i)
+        {
+            std::string checkName = g_Config->cities[i].name;
+            std::transform(checkName.begin(), checkName.end(), checkName.begin(), ::tolower);
+            if (checkName == cityName)
+            {
+                cityId = static_cast<int>(i);
+                break;
+            }
+        }
+
+        if (cityId == -1)
         {
             handler->PSendSysMessage("Invalid city name. Available: Stormwind, Ironforge, Darnassus, Exodar, Orgrimmar, Undercity, ThunderBluff, Silvermoon");
             return true;
         }
 
-        const CityData& city = g_Cities[cityId];
+        const CityData& city = g_Config->cities[cityId];
         float distance = player->GetDistance(city.centerX, city.centerY, city.centerZ);
         
         char msg[512];
@@ -5037,5 +7973,7 @@ public:
 void Addmod_city_siegeScripts()
 {
     new CitySiegeWorldScript();
+    new CitySiegeMapScript();
+    new CitySiegeUnitScript();
     new citysiege_commandscript();
 }